@@ -0,0 +1,86 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/benchmark/benchmarkConfig.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/benchmark/benchmarkConfigVersion.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/benchmark/benchmarkTargets-none.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/benchmark/benchmarkTargets.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeFindDependencyMacro.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython/Support.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPython3.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/yachie_core.dir/DependInfo.cmake"
+  "CMakeFiles/yachie-trace.dir/DependInfo.cmake"
+  "CMakeFiles/yachie-record.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_disasm.dir/DependInfo.cmake"
+  "CMakeFiles/yachie-disasm.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_lockstep.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_explorer.dir/DependInfo.cmake"
+  "CMakeFiles/yachie-explore.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_env.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_bench.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_lockstep_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_explorer_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_executionlog_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_tracer_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_instruction_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_profiler_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_debugger_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_gdb_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_disassembly_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_probes_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_framebuffer_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_atlas_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_capture_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_env_tests.dir/DependInfo.cmake"
+  "CMakeFiles/yachie_fuzz_standalone.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tools/yachie-disasm.cpp" "CMakeFiles/yachie-disasm.dir/tools/yachie-disasm.cpp.o" "gcc" "CMakeFiles/yachie-disasm.dir/tools/yachie-disasm.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_san_build/CMakeFiles/yachie_disasm.dir/DependInfo.cmake"
+  "/root/repo/_san_build/CMakeFiles/yachie_core.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
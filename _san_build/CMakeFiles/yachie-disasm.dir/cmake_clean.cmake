@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie-disasm"
+  "/root/repo/bin/yachie-disasm.pdb"
+  "CMakeFiles/yachie-disasm.dir/tools/yachie-disasm.cpp.o"
+  "CMakeFiles/yachie-disasm.dir/tools/yachie-disasm.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie-disasm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
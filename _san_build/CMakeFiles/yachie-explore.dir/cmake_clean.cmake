@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie-explore"
+  "/root/repo/bin/yachie-explore.pdb"
+  "CMakeFiles/yachie-explore.dir/tools/yachie-explore.cpp.o"
+  "CMakeFiles/yachie-explore.dir/tools/yachie-explore.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie-explore.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie-record"
+  "/root/repo/bin/yachie-record.pdb"
+  "CMakeFiles/yachie-record.dir/tools/yachie-record.cpp.o"
+  "CMakeFiles/yachie-record.dir/tools/yachie-record.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie-record.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
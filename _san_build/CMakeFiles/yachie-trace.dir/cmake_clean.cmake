@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie-trace"
+  "/root/repo/bin/yachie-trace.pdb"
+  "CMakeFiles/yachie-trace.dir/tools/yachie-trace.cpp.o"
+  "CMakeFiles/yachie-trace.dir/tools/yachie-trace.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie-trace.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
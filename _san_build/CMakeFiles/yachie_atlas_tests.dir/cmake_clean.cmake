@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_atlas_tests"
+  "/root/repo/bin/yachie_atlas_tests.pdb"
+  "CMakeFiles/yachie_atlas_tests.dir/tests/atlas.cpp.o"
+  "CMakeFiles/yachie_atlas_tests.dir/tests/atlas.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_atlas_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
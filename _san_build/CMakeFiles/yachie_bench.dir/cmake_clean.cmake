@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_bench"
+  "/root/repo/bin/yachie_bench.pdb"
+  "CMakeFiles/yachie_bench.dir/bench/bench.cpp.o"
+  "CMakeFiles/yachie_bench.dir/bench/bench.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
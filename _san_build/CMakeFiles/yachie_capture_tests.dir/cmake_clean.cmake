@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_capture_tests"
+  "/root/repo/bin/yachie_capture_tests.pdb"
+  "CMakeFiles/yachie_capture_tests.dir/tests/capture.cpp.o"
+  "CMakeFiles/yachie_capture_tests.dir/tests/capture.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_capture_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
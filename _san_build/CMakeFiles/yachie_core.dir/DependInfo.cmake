@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Capture.cpp" "CMakeFiles/yachie_core.dir/src/Capture.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Capture.cpp.o.d"
+  "/root/repo/src/Chip8.cpp" "CMakeFiles/yachie_core.dir/src/Chip8.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Chip8.cpp.o.d"
+  "/root/repo/src/DebugConsole.cpp" "CMakeFiles/yachie_core.dir/src/DebugConsole.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/DebugConsole.cpp.o.d"
+  "/root/repo/src/Debugger.cpp" "CMakeFiles/yachie_core.dir/src/Debugger.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Debugger.cpp.o.d"
+  "/root/repo/src/ExecutionLog.cpp" "CMakeFiles/yachie_core.dir/src/ExecutionLog.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/ExecutionLog.cpp.o.d"
+  "/root/repo/src/Framebuffer.cpp" "CMakeFiles/yachie_core.dir/src/Framebuffer.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Framebuffer.cpp.o.d"
+  "/root/repo/src/GdbServer.cpp" "CMakeFiles/yachie_core.dir/src/GdbServer.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/GdbServer.cpp.o.d"
+  "/root/repo/src/Opcodes.cpp" "CMakeFiles/yachie_core.dir/src/Opcodes.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Opcodes.cpp.o.d"
+  "/root/repo/src/Probes.cpp" "CMakeFiles/yachie_core.dir/src/Probes.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Probes.cpp.o.d"
+  "/root/repo/src/Profiler.cpp" "CMakeFiles/yachie_core.dir/src/Profiler.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Profiler.cpp.o.d"
+  "/root/repo/src/Quirks.cpp" "CMakeFiles/yachie_core.dir/src/Quirks.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Quirks.cpp.o.d"
+  "/root/repo/src/TileAtlas.cpp" "CMakeFiles/yachie_core.dir/src/TileAtlas.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/TileAtlas.cpp.o.d"
+  "/root/repo/src/Tone.cpp" "CMakeFiles/yachie_core.dir/src/Tone.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Tone.cpp.o.d"
+  "/root/repo/src/Tracer.cpp" "CMakeFiles/yachie_core.dir/src/Tracer.cpp.o" "gcc" "CMakeFiles/yachie_core.dir/src/Tracer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
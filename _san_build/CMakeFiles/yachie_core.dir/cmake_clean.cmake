@@ -0,0 +1,37 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yachie_core.dir/src/Capture.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Capture.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Chip8.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Chip8.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/DebugConsole.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/DebugConsole.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Debugger.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Debugger.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/ExecutionLog.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/ExecutionLog.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Framebuffer.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Framebuffer.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/GdbServer.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/GdbServer.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Opcodes.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Opcodes.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Probes.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Probes.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Profiler.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Profiler.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Quirks.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Quirks.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/TileAtlas.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/TileAtlas.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Tone.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Tone.cpp.o.d"
+  "CMakeFiles/yachie_core.dir/src/Tracer.cpp.o"
+  "CMakeFiles/yachie_core.dir/src/Tracer.cpp.o.d"
+  "libyachie_core.a"
+  "libyachie_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
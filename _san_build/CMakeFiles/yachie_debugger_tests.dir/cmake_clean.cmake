@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_debugger_tests"
+  "/root/repo/bin/yachie_debugger_tests.pdb"
+  "CMakeFiles/yachie_debugger_tests.dir/tests/debugger.cpp.o"
+  "CMakeFiles/yachie_debugger_tests.dir/tests/debugger.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_debugger_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yachie_disasm.dir/src/Disassembly.cpp.o"
+  "CMakeFiles/yachie_disasm.dir/src/Disassembly.cpp.o.d"
+  "libyachie_disasm.a"
+  "libyachie_disasm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_disasm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_disassembly_tests"
+  "/root/repo/bin/yachie_disassembly_tests.pdb"
+  "CMakeFiles/yachie_disassembly_tests.dir/tests/disassembly.cpp.o"
+  "CMakeFiles/yachie_disassembly_tests.dir/tests/disassembly.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_disassembly_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/libyachie_env.pdb"
+  "/root/repo/bin/libyachie_env.so"
+  "CMakeFiles/yachie_env.dir/src/Environment.cpp.o"
+  "CMakeFiles/yachie_env.dir/src/Environment.cpp.o.d"
+  "CMakeFiles/yachie_env.dir/src/ThreadPool.cpp.o"
+  "CMakeFiles/yachie_env.dir/src/ThreadPool.cpp.o.d"
+  "CMakeFiles/yachie_env.dir/src/yachie_env.cpp.o"
+  "CMakeFiles/yachie_env.dir/src/yachie_env.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_env.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_env_tests"
+  "/root/repo/bin/yachie_env_tests.pdb"
+  "CMakeFiles/yachie_env_tests.dir/tests/environment.cpp.o"
+  "CMakeFiles/yachie_env_tests.dir/tests/environment.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_env_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_executionlog_tests"
+  "/root/repo/bin/yachie_executionlog_tests.pdb"
+  "CMakeFiles/yachie_executionlog_tests.dir/tests/executionlog.cpp.o"
+  "CMakeFiles/yachie_executionlog_tests.dir/tests/executionlog.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_executionlog_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yachie_explorer.dir/src/Explorer.cpp.o"
+  "CMakeFiles/yachie_explorer.dir/src/Explorer.cpp.o.d"
+  "libyachie_explorer.a"
+  "libyachie_explorer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_explorer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
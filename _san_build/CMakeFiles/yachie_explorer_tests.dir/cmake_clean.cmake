@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_explorer_tests"
+  "/root/repo/bin/yachie_explorer_tests.pdb"
+  "CMakeFiles/yachie_explorer_tests.dir/tests/explorer.cpp.o"
+  "CMakeFiles/yachie_explorer_tests.dir/tests/explorer.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_explorer_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
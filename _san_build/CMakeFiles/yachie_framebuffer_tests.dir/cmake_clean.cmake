@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_framebuffer_tests"
+  "/root/repo/bin/yachie_framebuffer_tests.pdb"
+  "CMakeFiles/yachie_framebuffer_tests.dir/tests/framebuffer.cpp.o"
+  "CMakeFiles/yachie_framebuffer_tests.dir/tests/framebuffer.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_framebuffer_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
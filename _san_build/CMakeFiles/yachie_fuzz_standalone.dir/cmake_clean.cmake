@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_fuzz_standalone"
+  "/root/repo/bin/yachie_fuzz_standalone.pdb"
+  "CMakeFiles/yachie_fuzz_standalone.dir/fuzz/chip8_fuzzer.cpp.o"
+  "CMakeFiles/yachie_fuzz_standalone.dir/fuzz/chip8_fuzzer.cpp.o.d"
+  "CMakeFiles/yachie_fuzz_standalone.dir/fuzz/standalone.cpp.o"
+  "CMakeFiles/yachie_fuzz_standalone.dir/fuzz/standalone.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_fuzz_standalone.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
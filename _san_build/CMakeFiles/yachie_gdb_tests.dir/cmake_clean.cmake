@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_gdb_tests"
+  "/root/repo/bin/yachie_gdb_tests.pdb"
+  "CMakeFiles/yachie_gdb_tests.dir/tests/gdb.cpp.o"
+  "CMakeFiles/yachie_gdb_tests.dir/tests/gdb.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_gdb_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_instruction_tests"
+  "/root/repo/bin/yachie_instruction_tests.pdb"
+  "CMakeFiles/yachie_instruction_tests.dir/tests/instructions.cpp.o"
+  "CMakeFiles/yachie_instruction_tests.dir/tests/instructions.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_instruction_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/yachie_lockstep.dir/src/Lockstep.cpp.o"
+  "CMakeFiles/yachie_lockstep.dir/src/Lockstep.cpp.o.d"
+  "libyachie_lockstep.a"
+  "libyachie_lockstep.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_lockstep.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
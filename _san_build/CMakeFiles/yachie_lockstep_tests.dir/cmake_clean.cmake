@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_lockstep_tests"
+  "/root/repo/bin/yachie_lockstep_tests.pdb"
+  "CMakeFiles/yachie_lockstep_tests.dir/tests/lockstep.cpp.o"
+  "CMakeFiles/yachie_lockstep_tests.dir/tests/lockstep.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_lockstep_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
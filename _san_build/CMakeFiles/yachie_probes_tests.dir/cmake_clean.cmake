@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_probes_tests"
+  "/root/repo/bin/yachie_probes_tests.pdb"
+  "CMakeFiles/yachie_probes_tests.dir/tests/probes.cpp.o"
+  "CMakeFiles/yachie_probes_tests.dir/tests/probes.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_probes_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_profiler_tests"
+  "/root/repo/bin/yachie_profiler_tests.pdb"
+  "CMakeFiles/yachie_profiler_tests.dir/tests/profiler.cpp.o"
+  "CMakeFiles/yachie_profiler_tests.dir/tests/profiler.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_profiler_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_tests"
+  "/root/repo/bin/yachie_tests.pdb"
+  "CMakeFiles/yachie_tests.dir/tests/golden.cpp.o"
+  "CMakeFiles/yachie_tests.dir/tests/golden.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
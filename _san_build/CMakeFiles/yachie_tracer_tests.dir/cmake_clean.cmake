@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "/root/repo/bin/yachie_tracer_tests"
+  "/root/repo/bin/yachie_tracer_tests.pdb"
+  "CMakeFiles/yachie_tracer_tests.dir/tests/tracer.cpp.o"
+  "CMakeFiles/yachie_tracer_tests.dir/tests/tracer.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/yachie_tracer_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
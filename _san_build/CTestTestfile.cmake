@@ -0,0 +1,40 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_san_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(golden "/root/repo/bin/yachie_tests")
+set_tests_properties(golden PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;158;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(lockstep "/root/repo/bin/yachie_lockstep_tests")
+set_tests_properties(lockstep PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;162;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(explorer "/root/repo/bin/yachie_explorer_tests")
+set_tests_properties(explorer PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;166;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(executionlog "/root/repo/bin/yachie_executionlog_tests")
+set_tests_properties(executionlog PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;170;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(tracer "/root/repo/bin/yachie_tracer_tests")
+set_tests_properties(tracer PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;174;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(instructions "/root/repo/bin/yachie_instruction_tests")
+set_tests_properties(instructions PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;177;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(profiler "/root/repo/bin/yachie_profiler_tests")
+set_tests_properties(profiler PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;180;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(debugger "/root/repo/bin/yachie_debugger_tests")
+set_tests_properties(debugger PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;183;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(gdb "/root/repo/bin/yachie_gdb_tests")
+set_tests_properties(gdb PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;187;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(disassembly "/root/repo/bin/yachie_disassembly_tests")
+set_tests_properties(disassembly PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;191;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(probes "/root/repo/bin/yachie_probes_tests")
+set_tests_properties(probes PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;194;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(framebuffer "/root/repo/bin/yachie_framebuffer_tests")
+set_tests_properties(framebuffer PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;197;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(atlas "/root/repo/bin/yachie_atlas_tests")
+set_tests_properties(atlas PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;201;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(capture "/root/repo/bin/yachie_capture_tests")
+set_tests_properties(capture PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;205;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(environment "/root/repo/bin/yachie_env_tests")
+set_tests_properties(environment PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;208;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(python_environment "/root/.pyenv/shims/python3" "/root/repo/tests/test_yachie_env.py" "/root/repo/roms")
+set_tests_properties(python_environment PROPERTIES  ENVIRONMENT "YACHIE_ENV_LIBRARY=/root/repo/bin/libyachie_env.so;LD_PRELOAD=/usr/lib/gcc/x86_64-linux-gnu/12/libasan.so;ASAN_OPTIONS=detect_leaks=0" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;211;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(fuzz "/root/repo/bin/yachie_fuzz_standalone" "--roms=/root/repo/roms" "--runs=2000" "--seed=1")
+set_tests_properties(fuzz PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;230;add_test;/root/repo/CMakeLists.txt;0;")
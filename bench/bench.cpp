@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "Capture.h"
+#include "Chip8.h"
+#include "Disassembly.h"
+#include "Framebuffer.h"
+#include "Probes.h"
+#include "SpscRing.h"
+#include "TileAtlas.h"
+#include "Tone.h"
+#include "yachie_env.h"
+
+// Run with --benchmark_format=json (or --benchmark_out=file --benchmark_out_format=json) for machine-readable output
+
+namespace {
+
+constexpr int PROGRAM_REPEATS = 64; // copies of the benchmarked opcodes before jumping back to PROGRAM_OFFSET
+constexpr uint16_t SCRATCH_ADDRESS = 0xE00; // I for benchmarks that store to memory, well after the programs
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY); // instructions run between timer ticks
+const std::string BENCH_ROM = std::string(YACHIE_ROM_DIR) + "/BLINKY";
+
+void writeOpcode(Chip8& cpu, int address, uint16_t opcode) {
+    cpu.memory()[address] = uint8_t(opcode >> 8);
+    cpu.memory()[address + 1] = uint8_t(opcode & 0xFF);
+}
+
+// Repeats `program` and appends a jump to the start, so step() can be called forever
+void loadProgram(Chip8& cpu, const std::vector<uint16_t>& program, int repeats = PROGRAM_REPEATS) {
+    if (cpu.quirkProfile != QuirkProfile::XoChip) {
+        cpu.initState();
+    }
+    int address = PROGRAM_OFFSET;
+    for (int n = 0; n < repeats; n++) {
+        for (uint16_t opcode : program) {
+            writeOpcode(cpu, address, opcode);
+            address += OPCODE_SIZE;
+        }
+    }
+    writeOpcode(cpu, address, 0x1000 | PROGRAM_OFFSET);
+    cpu.state.i = SCRATCH_ADDRESS;
+    std::fill(std::begin(cpu.state.v), std::end(cpu.state.v), 0);
+    std::fill(std::begin(cpu.state.input), std::end(cpu.state.input), false);
+    cpu.state.running = true;
+}
+
+void BM_Opcodes(benchmark::State& benchState, std::vector<uint16_t> program, int repeats) {
+    Chip8 cpu;
+    loadProgram(cpu, program, repeats);
+    for (auto _ : benchState) {
+        cpu.step();
+    }
+    benchState.SetItemsProcessed(benchState.iterations());
+}
+
+// One benchmark per opcode class in Chip8::step()
+BENCHMARK_CAPTURE(BM_Opcodes, cls_00E0, std::vector<uint16_t>{0x00E0}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, call_ret_2NNN_00EE, std::vector<uint16_t>{0x2204, 0x1200, 0x00EE}, 1);
+BENCHMARK_CAPTURE(BM_Opcodes, sys_0NNN, std::vector<uint16_t>{0x0123}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, jump_1NNN, std::vector<uint16_t>{0x1200}, 1);
+BENCHMARK_CAPTURE(BM_Opcodes, jump_v0_BNNN, std::vector<uint16_t>{0xB200}, 1);
+BENCHMARK_CAPTURE(BM_Opcodes, skip_3XNN_4XNN_5XY0_9XY0,
+    std::vector<uint16_t>{0x3000, 0x0000, 0x4001, 0x0000, 0x5010, 0x0000, 0x9010, 0x6000}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, load_add_6XNN_7XNN, std::vector<uint16_t>{0x6012, 0x7134}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, alu_8XYN,
+    std::vector<uint16_t>{0x8010, 0x8011, 0x8012, 0x8013, 0x8014, 0x8015, 0x8016, 0x8017, 0x801E}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, load_i_ANNN, std::vector<uint16_t>{0xA000 | SCRATCH_ADDRESS}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, random_CXNN, std::vector<uint16_t>{0xC0FF}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, keys_EX9E_EXA1, std::vector<uint16_t>{0xE09E, 0xE1A1, 0x0000}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, timers_FX07_FX15_FX18, std::vector<uint16_t>{0xF007, 0xF015, 0xF018}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, index_FX1E_FX29, std::vector<uint16_t>{0xF01E, 0xF029}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, bcd_FX33,
+    std::vector<uint16_t>{0x60FF, 0xA000 | SCRATCH_ADDRESS, 0xF033}, PROGRAM_REPEATS);
+BENCHMARK_CAPTURE(BM_Opcodes, store_load_FX55_FX65,
+    std::vector<uint16_t>{0xA000 | SCRATCH_ADDRESS, 0xFF55, 0xFF65}, PROGRAM_REPEATS);
+
+// SCHIP opcodes, run in high resolution mode
+void BM_SuperChipOpcodes(benchmark::State& benchState, std::vector<uint16_t> program) {
+    Chip8 cpu;
+    cpu.quirkProfile = QuirkProfile::SuperChip;
+    loadProgram(cpu, program);
+    cpu.state.hires = true;
+    cpu.state.i = BIG_FONT_OFFSET;
+    for (auto _ : benchState) {
+        cpu.step();
+    }
+    benchState.SetItemsProcessed(benchState.iterations());
+}
+BENCHMARK_CAPTURE(BM_SuperChipOpcodes, scroll_down_00CN, std::vector<uint16_t>{0x00C4});
+BENCHMARK_CAPTURE(BM_SuperChipOpcodes, scroll_right_left_00FB_00FC, std::vector<uint16_t>{0x00FB, 0x00FC});
+BENCHMARK_CAPTURE(BM_SuperChipOpcodes, sprite16_DXY0, std::vector<uint16_t>{0xD010});
+BENCHMARK_CAPTURE(BM_SuperChipOpcodes, flags_FX75_FX85, std::vector<uint16_t>{0xF775, 0xF785});
+
+// XO-CHIP opcodes, the sprites are drawn to both planes
+void BM_XoChipOpcodes(benchmark::State& benchState, std::vector<uint16_t> program) {
+    Chip8 cpu;
+    cpu.quirkProfile = QuirkProfile::XoChip;
+    loadProgram(cpu, {0xF301}); // select both planes
+    cpu.run(1);
+    loadProgram(cpu, program);
+    for (auto _ : benchState) {
+        cpu.step();
+    }
+    benchState.SetItemsProcessed(benchState.iterations());
+}
+BENCHMARK_CAPTURE(BM_XoChipOpcodes, two_plane_sprite_DXYN, std::vector<uint16_t>{0xD018});
+BENCHMARK_CAPTURE(BM_XoChipOpcodes, long_load_F000, std::vector<uint16_t>{0xF000, SCRATCH_ADDRESS});
+BENCHMARK_CAPTURE(BM_XoChipOpcodes, save_load_range_5XY2_5XY3, std::vector<uint16_t>{0x50F2, 0x5F03});
+
+// DXYN with sprite heights from range(0) and from either the middle of the screen or the bottom right corner,
+// where every row and column wraps, depending on range(1). range(2) switches to a profile that clips sprites.
+void BM_DrawSprite(benchmark::State& benchState) {
+    const int height = int(benchState.range(0));
+    const bool wrap = benchState.range(1) != 0;
+    Chip8 cpu;
+    cpu.quirkProfile = benchState.range(2) != 0 ? QuirkProfile::SuperChip : QuirkProfile::Yachie;
+    loadProgram(cpu, {uint16_t(0xD010 | height)});
+    cpu.state.i = 0; // font data, always mapped
+    cpu.state.v[0] = wrap ? DISPLAY_WIDTH - 4 : 8;
+    cpu.state.v[1] = wrap ? DISPLAY_HEIGHT - (height + 1) / 2 : 8;
+    for (auto _ : benchState) {
+        cpu.step();
+    }
+    benchState.SetItemsProcessed(benchState.iterations());
+    benchState.SetLabel(wrap ? "wrap" : "nowrap");
+}
+BENCHMARK(BM_DrawSprite)->ArgNames({"height", "wrap", "clip"})->ArgsProduct({{1, 5, 8, 15}, {0, 1}, {0, 1}});
+
+void BM_InitState(benchmark::State& benchState) {
+    Chip8 cpu;
+    for (auto _ : benchState) {
+        cpu.initState();
+        benchmark::DoNotOptimize(cpu.state.memory);
+    }
+}
+BENCHMARK(BM_InitState);
+
+void BM_Load(benchmark::State& benchState) {
+    Chip8 cpu;
+    for (auto _ : benchState) {
+        cpu.load(BENCH_ROM);
+        benchmark::DoNotOptimize(cpu.state.memory);
+    }
+    benchState.SetBytesProcessed(benchState.iterations() * std::filesystem::file_size(BENCH_ROM));
+}
+BENCHMARK(BM_Load);
+
+// The pixel conversion half of Display::draw(); uploading and presenting need a window
+void BM_VramToPixels(benchmark::State& benchState) {
+    vram_t vram;
+    std::mt19937 rng(0);
+    for (auto& row : vram) {
+        for (auto& pixel : row) {
+            pixel = uint8_t(rng() & 1);
+        }
+    }
+    pixels_t pixels;
+    for (auto _ : benchState) {
+        vramToPixels(vram, nullptr, pixels, int(benchState.range(0)), int(benchState.range(1)));
+        benchmark::DoNotOptimize(pixels.data());
+        benchmark::ClobberMemory();
+    }
+    benchState.SetBytesProcessed(benchState.iterations() * benchState.range(0) * benchState.range(1) * BYTES_PER_PIXEL);
+}
+BENCHMARK(BM_VramToPixels)->ArgNames({"width", "height"})
+    ->Args({DISPLAY_WIDTH, DISPLAY_HEIGHT})->Args({HIRES_WIDTH, HIRES_HEIGHT});
+
+// The phosphor persistence pass Display::draw() adds after the conversion, fading the last frames out
+void BM_Persistence(benchmark::State& benchState) {
+    const int width = int(benchState.range(0));
+    const int height = int(benchState.range(1));
+    vram_t vram;
+    std::mt19937 rng(0);
+    for (auto& row : vram) {
+        for (auto& pixel : row) {
+            pixel = uint8_t(rng() & 1);
+        }
+    }
+    pixels_t pixels;
+    pixels_t shown;
+    vramToPixels(vram, nullptr, pixels, width, height);
+    shown = pixels;
+    const int decay = persistenceDecay(4);
+    for (auto _ : benchState) {
+        decayPixels(pixels, shown, width, height, decay);
+        benchmark::DoNotOptimize(shown.data());
+        benchmark::ClobberMemory();
+    }
+    benchState.SetBytesProcessed(benchState.iterations() * width * height * BYTES_PER_PIXEL);
+}
+BENCHMARK(BM_Persistence)->ArgNames({"width", "height"})
+    ->Args({DISPLAY_WIDTH, DISPLAY_HEIGHT})->Args({HIRES_WIDTH, HIRES_HEIGHT});
+
+// A frame of the yachie-grid view without the window: many machines playing BRIX on one thread, each then updating
+// its tile in the atlas, which queues the rectangles that changed
+void BM_TileAtlas(benchmark::State& benchState) {
+    const int count = int(benchState.range(0));
+    std::vector<Chip8> machines(static_cast<size_t>(count));
+    for (int n = 0; n < count; n++) {
+        machines[size_t(n)].load(std::string(YACHIE_ROM_DIR) + "/BRIX");
+        machines[size_t(n)].seedRandom(uint32_t(n));
+    }
+    TileAtlas atlas(count, 8192);
+    size_t uploads = 0;
+    for (auto _ : benchState) {
+        for (int n = 0; n < count; n++) {
+            machines[size_t(n)].run(STEPS_PER_FRAME);
+            machines[size_t(n)].tickTimers();
+            atlas.update(n, machines[size_t(n)]);
+        }
+        uploads += atlas.uploads().size();
+        atlas.clearUploads();
+    }
+    benchState.counters["uploads"] = benchmark::Counter(double(uploads) / double(benchState.iterations()));
+    benchState.SetItemsProcessed(benchState.iterations() * count);
+}
+BENCHMARK(BM_TileAtlas)->ArgName("instances")->Arg(1024);
+
+// The audio producer's work per sample, generating the XO-CHIP pattern and pushing it through the ring
+void BM_Tone(benchmark::State& benchState) {
+    constexpr int RING_SAMPLES = 512;
+    Chip8 cpu;
+    cpu.quirkProfile = QuirkProfile::XoChip;
+    cpu.initState();
+    cpu.state.soundTimer = 1;
+    cpu.xoChip->pitch = 100;
+    ToneGenerator tone;
+    SpscRing<int16_t, RING_SAMPLES> ring;
+    int16_t samples[RING_SAMPLES];
+    for (auto _ : benchState) {
+        tone.generate(cpu, samples, RING_SAMPLES);
+        ring.push(samples, RING_SAMPLES);
+        ring.pop(samples, RING_SAMPLES);
+        benchmark::DoNotOptimize(samples);
+    }
+    benchState.SetItemsProcessed(benchState.iterations() * RING_SAMPLES);
+}
+BENCHMARK(BM_Tone);
+
+// Whole-ROM throughput through the batched run API, one iteration is a 60Hz frame of instructions followed by a
+// timer tick. FX0A is answered with a rotating key and faulting ROMs are reloaded so every ROM keeps running.
+void BM_Rom(benchmark::State& benchState, const std::string& path) {
+    Chip8 cpu;
+    cpu.load(path);
+    std::fill(std::begin(cpu.state.input), std::end(cpu.state.input), false);
+    int64_t instructions = 0;
+    uint8_t nextKey = 0;
+    for (auto _ : benchState) {
+        int remaining = STEPS_PER_FRAME;
+        while (remaining > 0) {
+            if (cpu.state.acceptingInputInto != -1) {
+                cpu.keyInput(nextKey);
+                nextKey = (nextKey + 1) % NUMBER_OF_KEYS;
+            } else if (!cpu.state.running) {
+                cpu.load(path);
+            }
+            RunResult result = cpu.run(remaining);
+            remaining -= std::max(result.executed, 1);
+            instructions += result.executed;
+        }
+        cpu.tickTimers();
+    }
+    benchState.SetItemsProcessed(instructions);
+}
+
+// BM_Rom's cost with the debugger's checked loop, a breakpoint that is never hit keeps it active
+void BM_RomWithBreakpoint(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.load(BENCH_ROM);
+    cpu.debugger.setBreakpoint(0xFFF);
+    int64_t instructions = 0;
+    for (auto _ : benchState) {
+        if (!cpu.state.running) {
+            cpu.load(BENCH_ROM);
+        }
+        instructions += cpu.run(STEPS_PER_FRAME).executed;
+        cpu.tickTimers();
+    }
+    benchState.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_RomWithBreakpoint);
+
+// The cost of each MemoryPolicy (guarded, wrap, checked), on a ROM and on the opcodes that access memory through I
+void BM_RomMemoryPolicy(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.memoryPolicy = MemoryPolicy(benchState.range(0));
+    cpu.load(BENCH_ROM);
+    int64_t instructions = 0;
+    for (auto _ : benchState) {
+        if (!cpu.state.running) {
+            cpu.load(BENCH_ROM);
+        }
+        instructions += cpu.run(STEPS_PER_FRAME).executed;
+        cpu.tickTimers();
+    }
+    benchState.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_RomMemoryPolicy)->ArgName("policy")->DenseRange(0, 2);
+
+void BM_MemoryOpcodes(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.memoryPolicy = MemoryPolicy(benchState.range(0));
+    loadProgram(cpu, {0xA000 | SCRATCH_ADDRESS, 0xF355, 0xF365, 0xF033, 0xD015});
+    int64_t instructions = 0;
+    for (auto _ : benchState) {
+        instructions += cpu.run(STEPS_PER_FRAME).executed;
+    }
+    benchState.SetItemsProcessed(instructions);
+}
+BENCHMARK(BM_MemoryOpcodes)->ArgName("policy")->DenseRange(0, 2);
+
+// Chip8::stateHash() against hashing from scratch, with a few seconds of a ROM on screen, with and without XO-CHIP
+void BM_StateHash(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.quirkProfile = benchState.range(1) != 0 ? QuirkProfile::XoChip : QuirkProfile::Yachie;
+    cpu.load(BENCH_ROM);
+    cpu.seedRandom(0);
+    for (int frame = 0; frame < 180 && cpu.state.running; frame++) {
+        cpu.run(STEPS_PER_FRAME);
+        cpu.tickTimers();
+    }
+    const bool incremental = benchState.range(0) != 0;
+    for (auto _ : benchState) {
+        benchmark::DoNotOptimize(incremental ? cpu.stateHash() : cpu.computeStateHash());
+    }
+    benchState.SetLabel(incremental ? "incremental" : "from scratch");
+}
+BENCHMARK(BM_StateHash)->ArgNames({"incremental", "xochip"})->ArgsProduct({{0, 1}, {0, 1}});
+
+// One evaluation of a probe program like a harness would run after every frame
+void BM_ProbeProgram(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.load(BENCH_ROM);
+    ProbeProgram program;
+    program.compile("score = bcd(mem[0x2F0..0x2F2])\nlives = mem[0x2F8] & 0xF\n"
+                    "done = v[0xE] == 0 || lives == 0 || !running\nreward = (v[3] > 2) - (dt != 0)");
+    std::vector<int64_t> values(static_cast<size_t>(program.variables()));
+    for (auto _ : benchState) {
+        program.evaluate(cpu, values.data());
+        benchmark::DoNotOptimize(values.data());
+    }
+    benchState.SetItemsProcessed(benchState.iterations());
+}
+BENCHMARK(BM_ProbeProgram);
+
+// What Capture::submit() costs the emulation thread per frame, for a screen that stays the same and one that changes
+// every frame, the encoder writing a GIF to /dev/null meanwhile
+void BM_CaptureSubmit(benchmark::State& benchState) {
+    Chip8 cpu;
+    cpu.load(BENCH_ROM);
+    cpu.seedRandom(0);
+    Capture capture("/dev/null", CaptureFormat::Gif, 2);
+    const bool changing = benchState.range(0) != 0;
+    for (auto _ : benchState) {
+        if (changing) {
+            cpu.state.vramHash++; // enough for submit() to take it as a new screen
+        }
+        capture.submit(cpu);
+    }
+    capture.finish();
+    benchState.SetLabel(changing ? "changing" : "still");
+    benchState.counters["dropped"] = double(capture.dropped());
+}
+BENCHMARK(BM_CaptureSubmit)->ArgName("changing")->DenseRange(0, 1);
+
+// Frames per second through the C environment API, with every core stepping environments playing BRIX
+void BM_EnvironmentStep(benchmark::State& benchState) {
+    std::ifstream file(std::string(YACHIE_ROM_DIR) + "/BRIX", std::ios::binary);
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const int count = int(benchState.range(0));
+    yachie_env* env = yachie_env_create(rom.data(), rom.size(), count, nullptr);
+    std::vector<uint8_t> observations(size_t(count * yachie_env_observation_width(env) *
+                                             yachie_env_observation_height(env)));
+    std::vector<uint8_t> dones(static_cast<size_t>(count));
+    std::vector<int32_t> actions(static_cast<size_t>(count));
+    for (int n = 0; n < count; n++) {
+        actions[size_t(n)] = n % 2 == 0 ? 4 : 6;
+    }
+    yachie_env_reset(env, 0, observations.data());
+    for (auto _ : benchState) {
+        yachie_env_step(env, actions.data(), observations.data(), nullptr, dones.data());
+    }
+    yachie_env_destroy(env);
+    benchState.SetItemsProcessed(benchState.iterations() * count);
+}
+BENCHMARK(BM_EnvironmentStep)->ArgName("environments")->RangeMultiplier(8)->Range(8, 512)->UseRealTime();
+
+// Steps of four frames each for 64 environments, with each way of reducing the observations and a reward probe
+void BM_EnvironmentPreprocessing(benchmark::State& benchState) {
+    std::ifstream file(std::string(YACHIE_ROM_DIR) + "/BRIX", std::ios::binary);
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    constexpr int count = 64;
+    const yachie_env_probe probe = {0x314, 3, YACHIE_ENV_DIGITS, 1}; // the score
+    yachie_env_config config = yachie_env_default_config();
+    config.frame_skip = 4;
+    config.reward_probes = &probe;
+    config.reward_probe_count = 1;
+    const char* labels[] = {"pixels", "packed", "downsampled", "max over frames"};
+    const int mode = int(benchState.range(0));
+    config.observation_format = mode == 1 ? YACHIE_ENV_PACKED : YACHIE_ENV_PIXELS;
+    config.downsample = mode == 2 ? 2 : 1;
+    config.max_over_frames = mode == 3;
+    yachie_env* env = yachie_env_create(rom.data(), rom.size(), count, &config);
+    std::vector<uint8_t> observations(static_cast<size_t>(count * yachie_env_observation_size(env)));
+    std::vector<float> rewards(count);
+    std::vector<uint8_t> dones(count);
+    std::vector<int32_t> actions(count);
+    for (int n = 0; n < count; n++) {
+        actions[size_t(n)] = n % 2 == 0 ? 4 : 6;
+    }
+    yachie_env_reset(env, 0, observations.data());
+    for (auto _ : benchState) {
+        yachie_env_step(env, actions.data(), observations.data(), rewards.data(), dones.data());
+    }
+    yachie_env_destroy(env);
+    benchState.SetItemsProcessed(benchState.iterations() * count * config.frame_skip);
+    benchState.SetLabel(labels[mode]);
+}
+BENCHMARK(BM_EnvironmentPreprocessing)->ArgName("mode")->DenseRange(0, 3)->UseRealTime();
+
+// Control-flow analysis of one ROM, with the opcode lookup table already built
+void BM_Disassemble(benchmark::State& benchState, const std::string& path) {
+    Chip8 cpu;
+    cpu.load(path);
+    int size = PROGRAM_OFFSET + int(std::filesystem::file_size(path));
+    for (auto _ : benchState) {
+        Disassembly disassembly(cpu.memory(), std::min(size, cpu.memorySize()));
+        benchmark::DoNotOptimize(disassembly.blocks().data());
+    }
+    benchState.SetBytesProcessed(benchState.iterations() * (size - PROGRAM_OFFSET));
+}
+
+void registerRomBenchmarks() {
+    std::vector<std::filesystem::path> roms;
+    for (const auto& entry : std::filesystem::directory_iterator(YACHIE_ROM_DIR)) {
+        if (entry.is_regular_file()) {
+            roms.push_back(entry.path());
+        }
+    }
+    std::sort(roms.begin(), roms.end());
+    for (const auto& rom : roms) {
+        benchmark::RegisterBenchmark(("BM_Rom/" + rom.filename().string()).c_str(), BM_Rom, rom.string());
+        benchmark::RegisterBenchmark(("BM_Disassemble/" + rom.filename().string()).c_str(), BM_Disassemble,
+                                     rom.string());
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    registerRomBenchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
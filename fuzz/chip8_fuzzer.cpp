@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include "Lockstep.h"
+#include "chip8_fuzzer.h"
+
+// Runs a ROM and key schedule from the fuzzer through Chip8::run() and a second engine in lockstep, so besides
+// crashes and sanitizer reports, anything that makes the engines disagree aborts too
+
+namespace {
+
+constexpr int QUIRK_PROFILES = 5;
+constexpr int FAULT_POLICIES = 3;
+constexpr int MEMORY_POLICIES = 3;
+constexpr int KEY_EVENT_SIZE = 2;
+
+struct FuzzInput {
+    QuirkProfile profile;
+    FaultPolicy faultPolicy;
+    MemoryPolicy memoryPolicy;
+    bool checked;
+    uint32_t seed;
+    uint16_t keys[FUZZ_FRAMES]; // pressed keys in each frame, a bit per key
+    const uint8_t* rom;
+    size_t romSize;
+};
+
+bool parse(const uint8_t* data, size_t size, FuzzInput& input) {
+    if (size < FUZZ_HEADER_SIZE) {
+        return false;
+    }
+    input.profile = QuirkProfile((data[0] & 0x7) % QUIRK_PROFILES);
+    input.faultPolicy = FaultPolicy(((data[0] >> 3) & 0x3) % FAULT_POLICIES);
+    input.checked = (data[0] & 0x20) != 0;
+    input.memoryPolicy = MemoryPolicy((data[0] >> 6) % MEMORY_POLICIES);
+    input.seed = uint32_t(data[1] | data[2] << 8 | data[3] << 16 | uint32_t(data[4]) << 24);
+    int events = std::min<int>(data[5], FUZZ_MAX_KEY_EVENTS);
+    size_t romOffset = FUZZ_HEADER_SIZE + size_t(events) * KEY_EVENT_SIZE;
+    if (size < romOffset) {
+        return false;
+    }
+    // Each event changes one key from its frame on
+    uint16_t pressed[FUZZ_FRAMES] = {};
+    uint16_t released[FUZZ_FRAMES] = {};
+    for (int n = 0; n < events; n++) {
+        const uint8_t* event = data + FUZZ_HEADER_SIZE + n * KEY_EVENT_SIZE;
+        int frame = event[0] % FUZZ_FRAMES;
+        uint16_t key = uint16_t(1 << (event[1] & 0xF));
+        if ((event[1] & 0x80) != 0) {
+            pressed[frame] |= key;
+            released[frame] &= uint16_t(~key);
+        } else {
+            released[frame] |= key;
+            pressed[frame] &= uint16_t(~key);
+        }
+    }
+    uint16_t keys = 0;
+    for (int frame = 0; frame < FUZZ_FRAMES; frame++) {
+        keys = uint16_t((keys | pressed[frame]) & ~released[frame]);
+        input.keys[frame] = keys;
+    }
+    input.rom = data + romOffset;
+    input.romSize = size - romOffset;
+    return true;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    FuzzInput fuzz {};
+    if (!parse(data, size, fuzz)) {
+        return 0;
+    }
+    auto setup = [&fuzz](Chip8& cpu) {
+        cpu.quirkProfile = fuzz.profile;
+        cpu.faultPolicy = fuzz.faultPolicy;
+        cpu.memoryPolicy = fuzz.memoryPolicy;
+        cpu.trapHandler = [](Chip8&, const FaultRecord& fault) {
+            return fault.fault == Fault::UnknownOpcode ? FaultPolicy::Skip : FaultPolicy::Halt;
+        };
+        cpu.load(fuzz.rom, fuzz.romSize);
+        cpu.seedRandom(fuzz.seed);
+    };
+    auto input = [&fuzz](Chip8& cpu, int frame) {
+        uint16_t keys = fuzz.keys[frame];
+        for (int key = 0; key < NUMBER_OF_KEYS; key++) {
+            cpu.state.input[key] = (keys >> key & 1) != 0;
+        }
+        if (cpu.state.acceptingInputInto != -1 && keys != 0) {
+            int key = 0;
+            while ((keys >> key & 1) == 0) {
+                key++;
+            }
+            cpu.keyInput(uint8_t(key));
+        }
+    };
+    LockstepOptions options;
+    options.frames = FUZZ_FRAMES;
+    options.blockSize = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+    LockstepRunner runner(runBatched, fuzz.checked ? runChecked : runStepped);
+    Divergence divergence = runner.run(setup, input, options);
+    if (divergence.found) {
+        std::cerr << LockstepRunner::describe(divergence);
+        std::abort();
+    }
+    return 0;
+}
+
+std::vector<uint8_t> fuzzSeed(const std::vector<uint8_t>& rom, QuirkProfile profile) {
+    // Presses and releases the keys in turn, a quarter of a second each
+    constexpr int HOLD_FRAMES = 15;
+    std::vector<uint8_t> seed = {uint8_t(profile), 0xC8, 0xC8, 0xC8, 0xC8, 0};
+    for (int frame = 0; frame + HOLD_FRAMES < FUZZ_FRAMES && seed[5] + 2 <= FUZZ_MAX_KEY_EVENTS;
+         frame += 2 * HOLD_FRAMES) {
+        uint8_t key = uint8_t(frame / (2 * HOLD_FRAMES) * 5 % NUMBER_OF_KEYS);
+        seed.insert(seed.end(), {uint8_t(frame), uint8_t(0x80 | key), uint8_t(frame + HOLD_FRAMES), key});
+        seed[5] += 2;
+    }
+    seed.insert(seed.end(), rom.begin(), rom.end());
+    return seed;
+}
@@ -0,0 +1,24 @@
+#ifndef CHIP8_FUZZER_H
+#define CHIP8_FUZZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Quirks.h"
+
+// Fuzz input layout, everything after the header being the ROM:
+//   byte 0: quirk profile (bits 0-2), fault policy (bits 3-4), run the debugger's checked loop (bit 5),
+//           memory policy (bits 6-7)
+//   bytes 1-4: RNG seed
+//   byte 5: number of key events, at most FUZZ_MAX_KEY_EVENTS
+//   then two bytes per key event: frame, key (bits 0-3) and pressed (bit 7)
+constexpr int FUZZ_HEADER_SIZE = 6;
+constexpr int FUZZ_MAX_KEY_EVENTS = 32;
+constexpr int FUZZ_FRAMES = 120;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// A fuzz input running rom under profile, with a key held now and then, for seeding a corpus from ROMs
+std::vector<uint8_t> fuzzSeed(const std::vector<uint8_t>& rom, QuirkProfile profile);
+
+#endif //CHIP8_FUZZER_H
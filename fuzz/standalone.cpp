@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+#include "Options.h"
+#include "chip8_fuzzer.h"
+#ifdef YACHIE_SANITIZE
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+// Drives the fuzz target without libFuzzer: runs every input it's given, then random mutations of them. There's no
+// coverage feedback, that's what building yachie_fuzz with Clang is for, but it needs nothing but the core and
+// reproduces libFuzzer's crash files.
+
+namespace {
+
+constexpr const char* CRASH_FILE = "yachie-fuzz-crash.bin";
+constexpr size_t MAX_INPUT_SIZE = FUZZ_HEADER_SIZE + 2 * FUZZ_MAX_KEY_EVENTS + 2 * MEMORY_SIZE;
+constexpr uint8_t INTERESTING_BYTES[] = {0x00, 0x01, 0x0F, 0x10, 0x7F, 0x80, 0xEE, 0xF0, 0xFF};
+
+std::vector<uint8_t> current; // the input being run, saved when it crashes
+
+// Best effort, the process is going down anyway
+void saveCrash() {
+    if (FILE* file = std::fopen(CRASH_FILE, "wb")) {
+        std::fwrite(current.data(), 1, current.size(), file);
+        std::fclose(file);
+        std::fprintf(stderr, "Crashing input (%zu bytes) written to %s\n", current.size(), CRASH_FILE);
+    }
+}
+
+#ifndef YACHIE_SANITIZE
+void onSignal(int signal) {
+    saveCrash();
+    std::signal(signal, SIG_DFL);
+    std::raise(signal);
+}
+#endif
+
+bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+void mutate(std::vector<uint8_t>& data, const std::vector<std::vector<uint8_t>>& corpus, std::mt19937& rng) {
+    int mutations = 1 + int(rng() % 4);
+    for (int n = 0; n < mutations; n++) {
+        size_t at = data.empty() ? 0 : rng() % data.size();
+        switch (rng() % 6) {
+        case 0: // flip a bit
+            if (!data.empty()) {
+                data[at] ^= uint8_t(1 << rng() % 8);
+            }
+            break;
+        case 1: // random byte
+            if (!data.empty()) {
+                data[at] = uint8_t(rng());
+            }
+            break;
+        case 2: // interesting byte
+            if (!data.empty()) {
+                data[at] = INTERESTING_BYTES[rng() % sizeof(INTERESTING_BYTES)];
+            }
+            break;
+        case 3: // insert a byte
+            if (data.size() < MAX_INPUT_SIZE) {
+                data.insert(data.begin() + long(at), uint8_t(rng()));
+            }
+            break;
+        case 4: // erase a run of bytes
+            if (!data.empty()) {
+                data.erase(data.begin() + long(at), data.begin() + long(std::min(data.size(), at + 1 + rng() % 16)));
+            }
+            break;
+        default: { // splice in part of another input
+            const std::vector<uint8_t>& other = corpus[rng() % corpus.size()];
+            if (!other.empty()) {
+                size_t from = rng() % other.size();
+                size_t length = std::min<size_t>(other.size() - from, 1 + rng() % 64);
+                data.insert(data.begin() + long(at), other.begin() + long(from), other.begin() + long(from + length));
+                data.resize(std::min(data.size(), MAX_INPUT_SIZE));
+            }
+            break;
+        }
+        }
+    }
+}
+
+void run(const std::vector<uint8_t>& data) {
+    current = data;
+    LLVMFuzzerTestOneInput(current.data(), current.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long runs = 0;
+    uint32_t seed = std::random_device()();
+    std::string romDirectory;
+    std::string corpusDirectory;
+    std::vector<std::filesystem::path> inputs;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option.compare(0, 7, "--runs=") == 0) {
+            if (!parseNumber(option.substr(7), runs)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 7, "--seed=") == 0) {
+            if (!parseNumber(option.substr(7), seed)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 7, "--roms=") == 0) {
+            romDirectory = option.substr(7);
+        } else if (option.compare(0, 15, "--write-corpus=") == 0) {
+            corpusDirectory = option.substr(15);
+        } else if (!option.empty() && option[0] != '-') {
+            inputs.emplace_back(option);
+        } else {
+            std::cout << "Usage: yachie_fuzz_standalone [--runs=N] [--seed=N] [--roms=DIRECTORY] "
+                         "[--write-corpus=DIRECTORY] [FILE|DIRECTORY...]" << std::endl;
+            return option == "-h" || option == "--help" ? 0 : 1;
+        }
+    }
+#ifdef YACHIE_SANITIZE
+    // The sanitizers have their own signal handlers, which report the crash before calling this
+    __sanitizer_set_death_callback(saveCrash);
+#else
+    for (int signal : {SIGSEGV, SIGABRT, SIGFPE, SIGILL}) {
+        std::signal(signal, onSignal);
+    }
+#endif
+
+    // Fuzz inputs given directly, then every ROM under every profile
+    std::vector<std::vector<uint8_t>> corpus;
+    std::vector<uint8_t> data;
+    for (const auto& input : inputs) {
+        if (std::filesystem::is_directory(input)) {
+            for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                if (entry.is_regular_file() && readFile(entry.path(), data)) {
+                    corpus.push_back(data);
+                }
+            }
+        } else if (readFile(input, data)) {
+            corpus.push_back(data);
+        } else {
+            std::cerr << "Couldn't read " << input.string() << std::endl;
+            return 1;
+        }
+    }
+    if (!romDirectory.empty()) {
+        std::vector<std::filesystem::path> roms;
+        for (const auto& entry : std::filesystem::directory_iterator(romDirectory)) {
+            if (entry.is_regular_file()) {
+                roms.push_back(entry.path());
+            }
+        }
+        std::sort(roms.begin(), roms.end());
+        for (const auto& rom : roms) {
+            if (!readFile(rom, data)) {
+                continue;
+            }
+            for (QuirkProfile profile : {QuirkProfile::Yachie, QuirkProfile::CosmacVip, QuirkProfile::Chip48,
+                                         QuirkProfile::SuperChip, QuirkProfile::XoChip}) {
+                corpus.push_back(fuzzSeed(data, profile));
+                if (!corpusDirectory.empty()) {
+                    std::filesystem::create_directories(corpusDirectory);
+                    std::string name = rom.filename().string() + "-" + quirkProfileName(profile);
+                    std::ofstream out(std::filesystem::path(corpusDirectory) / name, std::ios::binary);
+                    out.write(reinterpret_cast<const char*>(corpus.back().data()), long(corpus.back().size()));
+                }
+            }
+        }
+    }
+    if (!corpusDirectory.empty()) {
+        std::cout << "Wrote " << corpus.size() << " inputs to " << corpusDirectory << std::endl;
+        return 0;
+    }
+    if (corpus.empty()) {
+        std::cerr << "Nothing to run, give some inputs or --roms" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& input : corpus) {
+        run(input);
+    }
+    std::mt19937 rng(seed);
+    for (long n = 0; n < runs; n++) {
+        data = corpus[rng() % corpus.size()];
+        mutate(data, corpus, rng);
+        run(data);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Ran " << corpus.size() << " inputs and " << runs << " mutations (seed " << seed << ") in "
+              << seconds << "s without a crash" << std::endl;
+    return 0;
+}
@@ -0,0 +1,192 @@
+"""Python binding for yachie's C environment API (src/yachie_env.h), using ctypes.
+
+    env = VectorEnv("roms/BRIX", 64, frame_skip=4, reward_probes=[Probe(0x314, 3, DIGITS)])
+    observations = env.reset(seed=1)
+    observations, rewards, dones = env.step([4] * 64)
+
+Observations, rewards and dones are written by the library straight into buffers that live as long as the
+VectorEnv. Observations are shaped (count, height, width), or (count, height, width / 8) when packed. They're NumPy
+arrays if NumPy is installed and bytearrays (rewards an array.array) otherwise, and they're overwritten by the next
+reset() or step(): copy them to keep them. Actions are the key held, 0-15, or NO_KEY.
+
+The library is looked for in $YACHIE_ENV_LIBRARY, then in bin/ next to this directory, where CMake puts it.
+"""
+
+import collections
+import ctypes
+import os
+import sys
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+NO_KEY = -1
+RUNNING = 0
+TERMINATED = 1  # the machine halted
+TRUNCATED = 2  # the episode reached max_episode_frames
+
+BINARY = 0  # an unsigned big endian number
+DIGITS = 1  # a decimal digit per byte, as FX33 writes them
+
+API_VERSION = 3
+
+# A number in guest memory whose change during a step, times scale, adds to the step's reward
+Probe = collections.namedtuple("Probe", ["address", "bytes", "encoding", "scale"], defaults=[1, BINARY, 1.0])
+
+
+class _Probe(ctypes.Structure):
+    _fields_ = [
+        ("address", ctypes.c_int),
+        ("bytes", ctypes.c_int),
+        ("encoding", ctypes.c_int),
+        ("scale", ctypes.c_float),
+    ]
+
+
+class _Config(ctypes.Structure):
+    _fields_ = [
+        ("quirks", ctypes.c_char_p),
+        ("instructions_per_frame", ctypes.c_int),
+        ("max_episode_frames", ctypes.c_int),
+        ("threads", ctypes.c_int),
+        ("frame_skip", ctypes.c_int),
+        ("downsample", ctypes.c_int),
+        ("max_over_frames", ctypes.c_int),
+        ("observation_format", ctypes.c_int),
+        ("reward_probes", ctypes.POINTER(_Probe)),
+        ("reward_probe_count", ctypes.c_int),
+        ("probes", ctypes.c_char_p),
+    ]
+
+
+def _library_path():
+    if "YACHIE_ENV_LIBRARY" in os.environ:
+        return os.environ["YACHIE_ENV_LIBRARY"]
+    names = {"win32": "yachie_env.dll", "darwin": "libyachie_env.dylib"}
+    name = names.get(sys.platform, "libyachie_env.so")
+    return os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "bin", name)
+
+
+def _load():
+    lib = ctypes.CDLL(_library_path())
+    lib.yachie_env_api_version.restype = ctypes.c_int
+    if lib.yachie_env_api_version() != API_VERSION:
+        raise RuntimeError("yachie_env library has API version %d, expected %d"
+                           % (lib.yachie_env_api_version(), API_VERSION))
+    lib.yachie_env_default_config.restype = _Config
+    lib.yachie_env_create.restype = ctypes.c_void_p
+    lib.yachie_env_create.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_int, ctypes.POINTER(_Config)]
+    lib.yachie_env_destroy.argtypes = [ctypes.c_void_p]
+    lib.yachie_env_error.restype = ctypes.c_char_p
+    for function in ("count", "observation_width", "observation_height", "observation_size"):
+        getattr(lib, "yachie_env_" + function).argtypes = [ctypes.c_void_p]
+        getattr(lib, "yachie_env_" + function).restype = ctypes.c_int
+    lib.yachie_env_probe_values.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_void_p]
+    lib.yachie_env_probe_values.restype = ctypes.c_int
+    lib.yachie_env_reset.argtypes = [ctypes.c_void_p, ctypes.c_uint64, ctypes.c_void_p]
+    lib.yachie_env_step.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p,
+                                    ctypes.c_void_p]
+    return lib
+
+
+_lib = None
+
+
+def _library():
+    global _lib
+    if _lib is None:
+        _lib = _load()
+    return _lib
+
+
+def _address(buffer, ctype, length):
+    """The address of a writable buffer (NumPy array, bytearray, array.array), without copying it"""
+    return ctypes.addressof((ctype * length).from_buffer(buffer))
+
+
+class VectorEnv:
+    def __init__(self, rom, count, quirks=None, instructions_per_frame=0, max_episode_frames=0, threads=0,
+                 frame_skip=1, downsample=1, max_over_frames=False, packed=False, reward_probes=(), probes=None):
+        """rom is a path or the ROM's bytes. Each step runs frame_skip frames holding the action's key, and its
+        observation has a pixel per downsample x downsample block. max_over_frames ORs the last two frames of the step
+        together, keeping sprites that flicker, and packed gives a bit per pixel, eight to a byte. reward_probes are
+        Probes, or tuples of their fields. probes is a probe program, see src/Probes.h, whose reward, score and done
+        variables feed the rewards and dones."""
+        self._env = None
+        self._lib = _library()
+        if not isinstance(rom, (bytes, bytearray)):
+            with open(rom, "rb") as file:
+                rom = file.read()
+        config = self._lib.yachie_env_default_config()
+        config.quirks = quirks.encode() if quirks else None
+        config.instructions_per_frame = instructions_per_frame
+        config.max_episode_frames = max_episode_frames
+        config.threads = threads
+        config.frame_skip = frame_skip
+        config.downsample = downsample
+        config.max_over_frames = int(max_over_frames)
+        config.observation_format = 1 if packed else 0
+        probe_array = (_Probe * max(len(reward_probes), 1))(*[_Probe(*Probe(*probe)) for probe in reward_probes])
+        config.reward_probes = probe_array
+        config.reward_probe_count = len(reward_probes)
+        config.probes = probes.encode() if probes else None
+        self._env = self._lib.yachie_env_create(bytes(rom), len(rom), count, ctypes.byref(config))
+        if not self._env:
+            raise ValueError(self._lib.yachie_env_error().decode())
+        self.count = count
+        self.height = self._lib.yachie_env_observation_height(self._env)
+        self.width = self._lib.yachie_env_observation_width(self._env)
+        self.observation_shape = (self.height, self.width // 8 if packed else self.width)
+        size = count * self._lib.yachie_env_observation_size(self._env)
+        if numpy is not None:
+            self.observations = numpy.zeros((count,) + self.observation_shape, dtype=numpy.uint8)
+            self.rewards = numpy.zeros(count, dtype=numpy.float32)
+            self.dones = numpy.zeros(count, dtype=numpy.uint8)
+            self._actions = numpy.zeros(count, dtype=numpy.int32)
+        else:
+            import array
+            self.observations = bytearray(size)
+            self.rewards = array.array("f", [0.0] * count)
+            self.dones = bytearray(count)
+            self._actions = array.array("i", [NO_KEY] * count)
+        # Resolved once, so each step is a single foreign call
+        self._observations_address = _address(self.observations, ctypes.c_uint8, size)
+        self._rewards_address = _address(self.rewards, ctypes.c_float, count)
+        self._dones_address = _address(self.dones, ctypes.c_uint8, count)
+        self._actions_address = _address(self._actions, ctypes.c_int32, count)
+
+    def reset(self, seed=0):
+        self._lib.yachie_env_reset(self._env, seed, self._observations_address)
+        return self.observations
+
+    def step(self, actions):
+        """Returns the observations, rewards and dones buffers, see RUNNING, TERMINATED and TRUNCATED"""
+        if len(actions) != self.count:
+            raise ValueError("expected %d actions, got %d" % (self.count, len(actions)))
+        self._actions[:] = actions if numpy is not None else type(self._actions)("i", actions)
+        self._lib.yachie_env_step(self._env, self._actions_address, self._observations_address,
+                                  self._rewards_address, self._dones_address)
+        return self.observations, self.rewards, self.dones
+
+    def probe(self, name):
+        """A variable of the probe program in each environment, as of its last frame"""
+        values = (ctypes.c_int64 * self.count)()
+        if self._lib.yachie_env_probe_values(self._env, name.encode(), values) != 0:
+            raise KeyError(name)
+        return list(values)
+
+    def close(self):
+        if self._env:
+            self._lib.yachie_env_destroy(self._env)
+            self._env = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exception):
+        self.close()
+
+    def __del__(self):
+        self.close()
@@ -0,0 +1,43 @@
+#include <algorithm>
+#include <chrono>
+#include "Audio.h"
+#include "Tracer.h"
+
+Audio::Audio() {
+    initialize(1, AUDIO_SAMPLE_RATE);
+}
+
+Audio::~Audio() {
+    stop(); // joins SFML's streaming thread before the ring goes away
+}
+
+void Audio::update(const Chip8& cpu) {
+    push(cpu, space());
+}
+
+void Audio::push(const Chip8& cpu, int count) {
+    if (count > 0) {
+        tone.generate(cpu, generated, count);
+        ring.push(generated, count);
+    }
+}
+
+void Audio::waitForSpace(int samples) {
+    std::unique_lock<std::mutex> lock(drainMutex);
+    drained.wait_for(lock, std::chrono::milliseconds(AUDIO_WAIT_TIMEOUT_MS), [&] {return space() >= samples;});
+}
+
+bool Audio::onGetData(Chunk& data) {
+    size_t count = ring.pop(chunk, AUDIO_CHUNK_SAMPLES);
+    if (count < AUDIO_CHUNK_SAMPLES) {
+        Tracer::instant("audio underrun", "audio", "missing", int64_t(AUDIO_CHUNK_SAMPLES - count));
+        std::fill(chunk + count, chunk + AUDIO_CHUNK_SAMPLES, 0);
+    }
+    {
+        std::lock_guard<std::mutex> lock(drainMutex); // held only so a waiter can't miss the notification
+    }
+    drained.notify_one();
+    data.samples = chunk;
+    data.sampleCount = AUDIO_CHUNK_SAMPLES; // never end the stream
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef CHIP8_AUDIO_H
+#define CHIP8_AUDIO_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <SFML/Audio.hpp>
+#include "Chip8.h"
+#include "SpscRing.h"
+#include "Tone.h"
+
+constexpr int AUDIO_LATENCY_MS = 20; // the most a sample may wait between being generated and being played
+constexpr int AUDIO_CHUNK_SAMPLES = 128; // handed to SFML per onGetData() call
+constexpr int AUDIO_DEVICE_CHUNKS = 3; // SFML keeps this many chunks queued on the device besides the ring
+constexpr int AUDIO_RING_SAMPLES = 256; // 5.8ms at 44.1kHz, 14.5ms with the device's chunks
+static_assert((AUDIO_RING_SAMPLES + AUDIO_DEVICE_CHUNKS * AUDIO_CHUNK_SAMPLES) * 1000 <
+              AUDIO_LATENCY_MS * AUDIO_SAMPLE_RATE, "the ring and the device hold more than AUDIO_LATENCY_MS of audio");
+constexpr int AUDIO_WAIT_TIMEOUT_MS = 50; // waitForSpace() gives up after this, in case the stream has stopped
+
+// Plays the sound timer. The emulation thread tops the ring up with update(), SFML's streaming thread drains it,
+// neither side ever blocks and the stream plays silence when the ring runs dry.
+class Audio : public sf::SoundStream {
+public:
+    Audio();
+    ~Audio() override;
+    // Fills the free part of the ring with the tone for the machine's current state, call often
+    void update(const Chip8& cpu);
+    // Pushes exactly count samples for the machine's current state, count must not be more than space()
+    void push(const Chip8& cpu, int count);
+    int space() const {return int(ring.space());}
+    // Sleeps until the device has drained enough for space() to reach samples, for pacing emulation from audio
+    void waitForSpace(int samples);
+private:
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time) override {}
+    SpscRing<int16_t, AUDIO_RING_SAMPLES> ring;
+    ToneGenerator tone;
+    int16_t generated[AUDIO_RING_SAMPLES]; // producer scratch
+    int16_t chunk[AUDIO_CHUNK_SAMPLES]; // consumer scratch, must stay valid until the next onGetData()
+    // Only used to wake waitForSpace(), the ring itself never locks
+    std::mutex drainMutex;
+    std::condition_variable drained;
+};
+
+#endif //CHIP8_AUDIO_H
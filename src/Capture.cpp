@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "Capture.h"
+#include "Framebuffer.h"
+
+namespace {
+
+constexpr int GIF_COLORS = 4; // one per combination of planes
+constexpr int GIF_CODE_SIZE = 2; // bits per color index, the smallest LZW code size GIF allows
+constexpr int GIF_MAX_CODES = 4096; // 12 bit codes
+constexpr int GIF_BLOCK_SIZE = 255; // image data is split into sub-blocks of at most this
+constexpr int GIF_MIN_DELAY = 2; // centiseconds, browsers show shorter frames for 10cs
+constexpr auto ENCODER_POLL = std::chrono::milliseconds(10); // bounds the wait when a wakeup is missed
+
+void writeLittle16(std::ostream& out, int value) {
+    out.put(char(value & 0xFF));
+    out.put(char(value >> 8 & 0xFF));
+}
+
+// Scales a frame up to fill the canvas
+void expand(const CaptureFrame& frame, std::vector<uint8_t>& canvas, int canvasWidth, int canvasHeight) {
+    const int factor = canvasWidth / frame.width;
+    for (int y = 0; y < canvasHeight; y++) {
+        const uint8_t* row = frame.pixels.data() + (y / factor) * frame.width;
+        uint8_t* out = canvas.data() + size_t(y) * size_t(canvasWidth);
+        if (factor == 1) {
+            std::memcpy(out, row, size_t(canvasWidth));
+            continue;
+        }
+        for (int x = 0; x < canvasWidth; x++) {
+            out[x] = row[x / factor];
+        }
+    }
+}
+
+// Variable width LZW as GIF wants it: codes from GIF_CODE_SIZE + 1 bits up to 12, least significant bit first, and a
+// clear code whenever the table fills up
+void compressLzw(const uint8_t* pixels, size_t count, std::vector<uint8_t>& data) {
+    const int clearCode = 1 << GIF_CODE_SIZE;
+    const int endCode = clearCode + 1;
+    // The code for each string plus one more color, by string code and color, 0 for none as no string is code 0 long
+    std::vector<uint16_t> children(size_t(GIF_MAX_CODES * GIF_COLORS), 0);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    int width = GIF_CODE_SIZE + 1;
+    auto put = [&](int code) {
+        bits |= uint32_t(code) << bitCount;
+        bitCount += width;
+        while (bitCount >= 8) {
+            data.push_back(uint8_t(bits));
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    };
+    int last = endCode; // the last code assigned
+    put(clearCode);
+    int prefix = pixels[0];
+    for (size_t n = 1; n < count; n++) {
+        const uint8_t pixel = pixels[n];
+        uint16_t& child = children[size_t(prefix * GIF_COLORS + pixel)];
+        if (child != 0) {
+            prefix = child;
+            continue;
+        }
+        put(prefix);
+        if (last < GIF_MAX_CODES - 1) {
+            child = uint16_t(++last);
+            // The decoder assigns codes one behind, so it widens as it reads the code after this one
+            if (last >= 1 << width && width < 12) {
+                width++;
+            }
+        } else {
+            put(clearCode);
+            std::fill(children.begin(), children.end(), uint16_t(0));
+            width = GIF_CODE_SIZE + 1;
+            last = endCode;
+        }
+        prefix = pixel;
+    }
+    put(prefix);
+    put(endCode);
+    if (bitCount > 0) {
+        data.push_back(uint8_t(bits));
+    }
+}
+
+// GIF89a, looping. Each frame stores the rectangle that changed since the last one and leaves the rest in place.
+class GifWriter : public CaptureWriter {
+public:
+    GifWriter(std::ostream& out, int width, int height) : out(out), width(width), height(height),
+        canvas(size_t(width * height)), previous(size_t(width * height)) {
+        out.write("GIF89a", 6);
+        writeLittle16(out, width);
+        writeLittle16(out, height);
+        out.put(char(0x80 | (GIF_CODE_SIZE - 1) << 4 | (GIF_CODE_SIZE - 1))); // a global table of GIF_COLORS
+        out.put(0); // background color
+        out.put(0); // square pixels
+        for (uint8_t level : PLANE_LEVELS) {
+            for (int channel = 0; channel < 3; channel++) {
+                out.put(char(level));
+            }
+        }
+        out.write("\x21\xFF\x0BNETSCAPE2.0\x03\x01\x00\x00\x00", 19); // loop forever
+    }
+
+    void write(const CaptureFrame& frame, uint64_t frames) override {
+        elapsed += frames;
+        const int64_t delay = int64_t(elapsed * 100 / CAPTURE_FRAME_RATE) - int64_t(writtenDelay);
+        // Too short a frame is left out, the next one taking over its time, unless it's the last
+        if (delay < GIF_MIN_DELAY && written) {
+            held = frame;
+            holding = true;
+            return;
+        }
+        holding = false;
+        writtenDelay += uint64_t(std::max<int64_t>(delay, GIF_MIN_DELAY));
+        writeImage(frame);
+    }
+
+    void finish() override {
+        if (holding) {
+            writtenDelay += GIF_MIN_DELAY;
+            writeImage(held);
+        }
+        out.put(0x3B);
+        out.flush();
+    }
+
+private:
+    void writeImage(const CaptureFrame& frame) {
+        expand(frame, canvas, width, height);
+        int left = width;
+        int top = height;
+        int right = -1;
+        int bottom = -1;
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = canvas.data() + size_t(y) * size_t(width);
+            const uint8_t* before = previous.data() + size_t(y) * size_t(width);
+            if (written && std::memcmp(row, before, size_t(width)) == 0) {
+                continue;
+            }
+            for (int x = 0; x < width; x++) {
+                if (!written || row[x] != before[x]) {
+                    left = std::min(left, x);
+                    right = std::max(right, x);
+                }
+            }
+            top = std::min(top, y);
+            bottom = y;
+        }
+        if (right < 0) { // the same as the last frame written, which can happen after leaving one out
+            left = top = right = bottom = 0;
+        }
+        const int rectangleWidth = right - left + 1;
+        const int rectangleHeight = bottom - top + 1;
+        rectangle.resize(size_t(rectangleWidth * rectangleHeight));
+        for (int y = 0; y < rectangleHeight; y++) {
+            std::memcpy(rectangle.data() + size_t(y * rectangleWidth),
+                        canvas.data() + size_t((top + y) * width + left), size_t(rectangleWidth));
+        }
+        out.write("\x21\xF9\x04\x04", 4); // graphic control: leave the frame in place for the next one
+        writeLittle16(out, int(std::min<uint64_t>(writtenDelay - shownDelay, 0xFFFF)));
+        out.put(0); // no transparent color
+        out.put(0);
+        shownDelay = writtenDelay;
+        out.put(0x2C);
+        writeLittle16(out, left);
+        writeLittle16(out, top);
+        writeLittle16(out, rectangleWidth);
+        writeLittle16(out, rectangleHeight);
+        out.put(0); // no local color table, not interlaced
+        data.clear();
+        compressLzw(rectangle.data(), rectangle.size(), data);
+        out.put(GIF_CODE_SIZE);
+        for (size_t n = 0; n < data.size(); n += GIF_BLOCK_SIZE) {
+            size_t length = std::min(data.size() - n, size_t(GIF_BLOCK_SIZE));
+            out.put(char(length));
+            out.write(reinterpret_cast<const char*>(data.data() + n), std::streamsize(length));
+        }
+        out.put(0);
+        std::swap(canvas, previous);
+        written = true;
+    }
+
+    std::ostream& out;
+    int width;
+    int height;
+    std::vector<uint8_t> canvas;
+    std::vector<uint8_t> previous; // the last frame written
+    std::vector<uint8_t> rectangle;
+    std::vector<uint8_t> data;
+    bool written = false;
+    CaptureFrame held; // the last frame left out
+    bool holding = false;
+    uint64_t elapsed = 0; // frames
+    uint64_t writtenDelay = 0; // centiseconds, up to the end of the last frame written
+    uint64_t shownDelay = 0; // up to its start
+};
+
+// YUV4MPEG2 in full range 4:2:0, grey, so the chroma planes are constant. Every frame is stored, repeats too.
+class Y4mWriter : public CaptureWriter {
+public:
+    Y4mWriter(std::ostream& out, int width, int height) : out(out), width(width), height(height),
+        canvas(size_t(width * height)), picture(size_t(width * height * 3 / 2), uint8_t(0x80)) {
+        out << "YUV4MPEG2 W" << width << " H" << height << " F" << CAPTURE_FRAME_RATE
+            << ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+    }
+
+    void write(const CaptureFrame& frame, uint64_t frames) override {
+        expand(frame, canvas, width, height);
+        for (size_t n = 0; n < canvas.size(); n++) {
+            picture[n] = PLANE_LEVELS[canvas[n]];
+        }
+        for (uint64_t n = 0; n < frames; n++) {
+            out.write("FRAME\n", 6);
+            out.write(reinterpret_cast<const char*>(picture.data()), std::streamsize(picture.size()));
+        }
+    }
+
+    void finish() override {
+        out.flush();
+    }
+
+private:
+    std::ostream& out;
+    int width;
+    int height;
+    std::vector<uint8_t> canvas;
+    std::vector<uint8_t> picture; // the luma plane, then the chroma planes at half size each way
+};
+
+} // namespace
+
+bool captureFormatFor(const std::string& filename, CaptureFormat& format) {
+    auto endsWith = [&filename](const std::string& suffix) {
+        return filename.size() >= suffix.size() &&
+               filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (endsWith(".gif")) {
+        format = CaptureFormat::Gif;
+    } else if (endsWith(".y4m")) {
+        format = CaptureFormat::Y4m;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Capture::Capture(const std::string& filename, CaptureFormat format, int scale) :
+    file(filename, std::ios::binary), queue(std::make_unique<SpscRing<CaptureFrame, CAPTURE_QUEUE_FRAMES>>()) {
+    if (!file.is_open() || scale < 1) {
+        return;
+    }
+    const int width = HIRES_WIDTH * scale;
+    const int height = HIRES_HEIGHT * scale;
+    if (format == CaptureFormat::Gif) {
+        writer = std::make_unique<GifWriter>(file, width, height);
+    } else {
+        writer = std::make_unique<Y4mWriter>(file, width, height);
+    }
+    encoder = std::thread(&Capture::encode, this);
+}
+
+Capture::~Capture() {
+    finish();
+}
+
+void Capture::submit(const Chip8& cpu) {
+    if (!isOpen() || finishing.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const uint64_t start = frameCount++;
+    const uint64_t hashes[3] = {cpu.vramHash(0), cpu.xoChip ? cpu.vramHash(1) : 0,
+                                uint64_t(cpu.state.hires)};
+    if (submitted && std::equal(hashes, hashes + 3, lastHashes)) {
+        return;
+    }
+    submitted = true;
+    std::copy(hashes, hashes + 3, lastHashes);
+    if (queue->space() == 0) {
+        // The last screen queued stays up longer instead. Forgetting this one means the next change gets queued.
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        submitted = false;
+        return;
+    }
+    staging.start = start;
+    staging.width = cpu.state.screenWidth();
+    staging.height = cpu.state.screenHeight();
+    const vram_t* plane2 = cpu.secondPlane();
+    for (int y = 0; y < staging.height; y++) {
+        const auto& row1 = cpu.state.vram[y];
+        uint8_t* out = staging.pixels.data() + y * staging.width;
+        if (plane2 == nullptr) {
+            std::memcpy(out, row1.data(), size_t(staging.width));
+        } else {
+            const auto& row2 = (*plane2)[y];
+            for (int x = 0; x < staging.width; x++) {
+                out[x] = uint8_t(row1[x] | row2[x] << 1);
+            }
+        }
+    }
+    queue->push(&staging, 1);
+    wake.notify_one();
+}
+
+void Capture::waitForSpace() {
+    while (isOpen() && queue->space() == 0) {
+        std::this_thread::sleep_for(ENCODER_POLL / 10);
+    }
+}
+
+void Capture::finish() {
+    // The end frame is published before the flag: once the encoder sees finishing, endFrame must be final
+    endFrame.store(frameCount, std::memory_order_relaxed);
+    if (!isOpen() || finishing.exchange(true, std::memory_order_release)) {
+        if (encoder.joinable()) {
+            encoder.join();
+        }
+        return;
+    }
+    wake.notify_one();
+    encoder.join();
+    writer->finish();
+    file.close();
+}
+
+void Capture::encode() {
+    // A frame is written once the next one arrives, which is when its duration is known
+    CaptureFrame frames[2];
+    int pending = -1; // the frame waiting for its duration
+    while (true) {
+        const bool last = finishing.load(std::memory_order_acquire);
+        CaptureFrame& incoming = frames[pending == 0 ? 1 : 0];
+        if (queue->pop(&incoming, 1) == 1) {
+            if (pending != -1) {
+                writer->write(frames[pending], incoming.start - frames[pending].start);
+            }
+            pending = pending == 0 ? 1 : 0;
+            continue;
+        }
+        if (last) { // everything submitted before finish() has been popped
+            break;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_for(lock, ENCODER_POLL);
+    }
+    if (pending != -1) {
+        // Ordered after the acquire load of finishing that ended the loop
+        writer->write(frames[pending], endFrame.load(std::memory_order_relaxed) - frames[pending].start);
+    }
+}
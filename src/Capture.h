@@ -0,0 +1,81 @@
+#ifndef CHIP8_CAPTURE_H
+#define CHIP8_CAPTURE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Chip8.h"
+#include "SpscRing.h"
+
+constexpr int CAPTURE_QUEUE_FRAMES = 64; // changed frames that can wait for the encoder, a second at 60Hz
+constexpr int CAPTURE_FRAME_RATE = 60; // one frame per timer tick
+
+enum class CaptureFormat {
+    Gif, // animated, identical frames merged into one longer frame, only the changed rectangle stored
+    Y4m, // uncompressed YUV4MPEG2 at 60 frames per second, which ffmpeg and most players read
+};
+
+// The format a filename's extension asks for: .gif or .y4m
+bool captureFormatFor(const std::string& filename, CaptureFormat& format);
+
+// A screen as the encoder gets it: a byte per pixel, the planes it's lit in as for PLANE_LEVELS
+struct CaptureFrame {
+    uint64_t start = 0; // the frame number it was submitted at
+    int width = 0;
+    int height = 0;
+    std::array<uint8_t, HIRES_WIDTH * HIRES_HEIGHT> pixels;
+};
+
+// Writes captured frames in one of the formats, each with the number of frames it stays on screen for
+class CaptureWriter {
+public:
+    virtual ~CaptureWriter() = default;
+    virtual void write(const CaptureFrame& frame, uint64_t frames) = 0;
+    virtual void finish() = 0;
+};
+
+// Records what a Chip8 shows, once per frame, into a GIF or Y4M file. submit() runs on the emulation thread and never
+// waits: a screen the same as the last one (going by the incremental VRAM hashes) costs a comparison, a changed one a
+// copy into a bounded lock-free queue, or nothing but a count in dropped() if the queue is full. A thread of its own
+// drains the queue and encodes, so the emulation never waits for compression or the disk. Frames are scaled to a
+// fixed canvas, low resolution pixels twice the size of high resolution ones.
+class Capture {
+public:
+    // Check isOpen() afterwards. scale is the canvas size, in pixels per high resolution pixel.
+    Capture(const std::string& filename, CaptureFormat format, int scale);
+    ~Capture(); // finish()es
+    bool isOpen() const {return writer != nullptr;}
+    void submit(const Chip8& cpu);
+    // Blocks until the queue has room, for recording headless faster than real time without dropping frames
+    void waitForSpace();
+    // Encodes what's queued, gives the last frame its duration and closes the file. Nothing is recorded after it.
+    void finish();
+    uint64_t frames() const {return frameCount;} // submitted so far
+    uint64_t dropped() const {return droppedCount.load(std::memory_order_relaxed);} // changed, but the queue was full
+
+private:
+    void encode(); // the encoder thread
+    std::ofstream file;
+    std::unique_ptr<CaptureWriter> writer;
+    // Emulation thread side
+    uint64_t frameCount = 0;
+    bool submitted = false; // whether there is a last screen
+    uint64_t lastHashes[3] = {}; // of the last screen: its planes and resolution
+    CaptureFrame staging;
+    std::atomic<uint64_t> droppedCount{0};
+    // Shared
+    std::unique_ptr<SpscRing<CaptureFrame, CAPTURE_QUEUE_FRAMES>> queue;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> finishing{false};
+    std::atomic<uint64_t> endFrame{0}; // frameCount when finish() was called
+    std::thread encoder;
+};
+
+#endif //CHIP8_CAPTURE_H
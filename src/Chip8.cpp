@@ -1,26 +1,113 @@
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iterator>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include "Chip8.h"
 
-Chip8::Chip8() : rng(device()), randomDistribution(0, 255) {
+namespace {
+
+// splitmix64's finalizer, every input bit affects every output bit
+constexpr uint64_t mixHash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EB;
+    return value ^ value >> 31;
+}
+
+// The memory hash is the sum of every byte times the key of its address, so a store adds the difference times the key.
+// The keys are odd, so that changing any single byte changes the hash.
+inline uint64_t addressKey(int address) {
+    return mixHash(uint64_t(address)) | 1;
+}
+
+// The VRAM hashes are the XOR of the keys of the lit pixels (Zobrist hashing), so flipping a pixel XORs in its key.
+// Sprites flip a lot of pixels, so the keys are looked up rather than mixed.
+const uint64_t* pixelKeys(int plane) {
+    constexpr int PIXELS = HIRES_WIDTH * HIRES_HEIGHT;
+    static const std::vector<uint64_t> keys = [] {
+        std::vector<uint64_t> keys(2 * PIXELS);
+        for (size_t n = 0; n < keys.size(); n++) {
+            keys[n] = mixHash(uint64_t(1) << 32 | n);
+        }
+        return keys;
+    }();
+    return keys.data() + plane * PIXELS;
+}
+
+uint64_t hashMemory(const uint8_t* memory, int size) {
+    uint64_t hash = 0;
+    for (int address = 0; address < size; address++) {
+        if (memory[address] != 0) {
+            hash += memory[address] * addressKey(address);
+        }
+    }
+    return hash;
+}
+
+uint64_t hashPlane(const vram_t& plane, int index) {
+    const uint64_t* keys = pixelKeys(index);
+    uint64_t hash = 0;
+    for (int y = 0; y < HIRES_HEIGHT; y++) {
+        for (int x = 0; x < HIRES_WIDTH; x++) {
+            if (plane[y][x] != 0) {
+                hash ^= keys[y * HIRES_WIDTH + x];
+            }
+        }
+    }
+    return hash;
+}
+
+}
+
+XoChipState::XoChipState() : memory(XO_MEMORY_SIZE + XO_MEMORY_GUARD, 0) {
+    for (auto& row : plane2) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+    // The classic buzzer until a ROM loads its own pattern
+    std::copy(std::begin(DEFAULT_AUDIO_PATTERN), std::end(DEFAULT_AUDIO_PATTERN), audioPattern);
+}
+
+Chip8::Chip8() : randomSeed(device()), rng(randomSeed) {
+    std::fill(std::begin(state.rpl), std::end(state.rpl), 0);
     initState();
 }
 
 void Chip8::initState() {
     // Clear registers
+    std::fill(std::begin(state.v), std::end(state.v), 0);
+    state.i = 0;
     state.delayTimer = 0;
     state.soundTimer = 0;
     state.sp = STACK_SIZE; // Point to the top of the stack
     state.pc = PROGRAM_OFFSET; // Point to the start of the program
     // Clear memory
     std::fill(state.memory, state.memory + MEMORY_SIZE, 0);
+    std::fill(state.memory + MEMORY_SIZE, std::end(state.memory), MEMORY_GUARD_BYTE);
     std::fill(state.stack, state.stack + STACK_SIZE, 0);
     clearVRAM();
-    // Put font into ROM
+    state.hires = false;
+    std::fill(std::begin(state.input), std::end(state.input), false);
+    state.acceptingInputInto = -1;
+    // Put fonts into ROM
     std::copy(std::begin(FONT_SET), std::end(FONT_SET), std::begin(state.memory));
+    std::copy(std::begin(BIG_FONT_SET), std::end(BIG_FONT_SET), std::begin(state.memory) + BIG_FONT_OFFSET);
+    state.memoryHash = hashMemory(state.memory, MEMORY_SIZE);
+    if (quirkProfile == QuirkProfile::XoChip) {
+        enableXoChip();
+    } else {
+        xoChip.reset();
+    }
+}
+
+void Chip8::enableXoChip() {
+    // Start from a copy of the classic memory, which has the fonts and possibly a ROM
+    xoChip = std::make_unique<XoChipState>();
+    std::copy(state.memory, state.memory + MEMORY_SIZE, xoChip->memory.begin());
+    xoChip->memoryHash = state.memoryHash; // the keys don't depend on the memory size
 }
 
 void Chip8::load(std::string filename) {
@@ -29,32 +116,169 @@ void Chip8::load(std::string filename) {
         std::cerr << "Couldn't load rom " << filename << std::endl;
         return;
     }
-    initState();
-    // seems hacky, that's what I get for using uint8_t
-    char c;
-    int offset = PROGRAM_OFFSET;
-    while (romFile.get(c)) {
-        state.memory[offset] = (uint8_t)c;
-        offset++;
+    std::vector<uint8_t> rom((std::istreambuf_iterator<char>(romFile)), std::istreambuf_iterator<char>());
+    if (!load(rom.data(), rom.size())) {
+        std::cerr << "Rom " << filename << " doesn't fit in memory, truncating it" << std::endl;
     }
+}
+
+bool Chip8::load(const uint8_t* rom, size_t size) {
+    initState();
+    PROFILE(profiler.reset());
+    EXECUTION_LOG(executionLog.clear());
+    // Sized after initState(), which decides whether the XO-CHIP memory is in use
+    size_t space = size_t(memorySize() - PROGRAM_OFFSET);
+    std::copy(rom, rom + std::min(size, space), memory() + PROGRAM_OFFSET);
+    rehash();
     state.running = true;
+    return size <= space;
+}
+
+Fault Chip8::step() {
+    return run(1).fault.fault;
+}
+
+RunResult Chip8::run(int instructions) {
+    // The checked loop is only used while the debugger has something to do
+    return debugger.active() ? runProfile<true>(instructions) : runProfile<false>(instructions);
 }
 
-void Chip8::step() {
-    if (state.pc > MEMORY_SIZE) {
-        std::stringstream message;
-        message << std::hex;
-        message << "PC went out of bounds at 0x";
-        message << (state.pc);
-        throw std::out_of_range(message.str());
+template <bool Debugging>
+RunResult Chip8::runProfile(int instructions) {
+    switch (quirkProfile) {
+    case QuirkProfile::CosmacVip:
+        return runPolicy<CosmacVipQuirks, Debugging>(instructions);
+    case QuirkProfile::Chip48:
+        return runPolicy<Chip48Quirks, Debugging>(instructions);
+    case QuirkProfile::SuperChip:
+        return runPolicy<SuperChipQuirks, Debugging>(instructions);
+    case QuirkProfile::XoChip:
+        if (!xoChip) { // the profile was changed without reloading
+            enableXoChip();
+        }
+        return runPolicy<XoChipQuirks, Debugging>(instructions);
+    default:
+        return runPolicy<YachieQuirks, Debugging>(instructions);
+    }
+}
+
+template <typename Quirks, bool Debugging>
+RunResult Chip8::runPolicy(int instructions) {
+    switch (memoryPolicy) {
+    case MemoryPolicy::Wrap:
+        return runWith<WithMemoryPolicy<Quirks, MemoryPolicy::Wrap>, Debugging>(instructions);
+    case MemoryPolicy::Checked:
+        return runWith<WithMemoryPolicy<Quirks, MemoryPolicy::Checked>, Debugging>(instructions);
+    default:
+        return runWith<WithMemoryPolicy<Quirks, MemoryPolicy::Guarded>, Debugging>(instructions);
+    }
+}
+
+template <typename Quirks, bool Debugging>
+RunResult Chip8::runWith(int instructions) {
+    RunResult result {0, {}};
+    while (result.executed < instructions && state.running) {
+        uint16_t pc = state.pc;
+        if constexpr (Quirks::memoryPolicy == MemoryPolicy::Wrap) {
+            pc &= addressMask<Quirks>(); // where fetch() reads from
+        }
+        if constexpr (Debugging) {
+            int length = debugger.watching() && pc + 1 < memorySize() ? storeLength<Quirks>(
+                uint16_t(memory()[pc] << 8 | memory()[pc + 1])) : 0;
+            result.stop = debugger.check(pc, state.i, length, addressMask<Quirks>());
+            if (result.stop != DebugStop::None) {
+                break;
+            }
+        }
+        Fault fault = execute<Quirks>();
+        if (fault == Fault::None) {
+            result.executed++;
+            continue;
+        }
+        // Only gather the details of a fault once it has happened, keeping execute() lean
+        FaultRecord record {fault, pc, 0};
+        if (fault != Fault::PcOutOfBounds) {
+            record.opcode = uint16_t(memoryAt<Quirks>(memory(), pc) << 8 | memoryAt<Quirks>(memory(), pc + 1));
+        }
+        result.fault = record;
+        FaultPolicy policy = faultPolicy;
+        if (policy == FaultPolicy::Trap) {
+            policy = trapHandler ? trapHandler(*this, record) : FaultPolicy::Halt;
+        }
+        if (policy == FaultPolicy::Skip && fault != Fault::PcOutOfBounds) {
+            state.pc = uint16_t(pc + OPCODE_SIZE);
+            result.executed++;
+        } else if (policy == FaultPolicy::Pause) {
+            state.pc = pc;
+            debugger.trap();
+            result.stop = DebugStop::Fault;
+            break;
+        } else {
+            state.pc = pc; // leave PC on the faulting instruction
+            state.running = false;
+            break;
+        }
+    }
+    return result;
+}
+
+template <typename Quirks>
+int Chip8::storeLength(uint16_t opcode) {
+    if ((opcode & 0xF0FF) == 0xF033) {
+        return 3;
+    } else if ((opcode & 0xF0FF) == 0xF055) {
+        return x(opcode) + 1;
+    } else if (Quirks::xoChip && (opcode & 0xF00F) == 0x5002) {
+        return std::abs(x(opcode) - y(opcode)) + 1;
+    }
+    return 0;
+}
+
+template <typename Quirks>
+inline void Chip8::store(uint8_t* memory, int address, uint8_t value) {
+    uint8_t& byte = memoryAt<Quirks>(memory, address);
+    int index = int(&byte - memory);
+    (Quirks::xoChip ? xoChip->memoryHash : state.memoryHash) += (uint64_t(value) - byte) * addressKey(index);
+    byte = value;
+}
+
+template <typename Quirks>
+Fault Chip8::execute() {
+    uint8_t* memory = activeMemory<Quirks>();
+    uint16_t opcode;
+    if (!fetch<Quirks>(memory, opcode)) {
+        return Fault::PcOutOfBounds;
     }
-    uint16_t opcode = state.memory[state.pc] << 8 | state.memory[state.pc + 1];
+    PROFILE(profiler.instruction(state.pc, opcode));
+    EXECUTION_LOG(executionLog.record(state.pc, opcode, state.i, state.v));
     state.pc += OPCODE_SIZE;
     if (opcode == 0x00E0) {
-        clearVRAM(); // CLS
+        forEachPlane<Quirks>([this](vram_t& plane) {clearPlane(plane);}); // CLS
     } else if (opcode == 0x00EE) {
         // RET
-        state.pc = popFromStack();
+        if (!popFromStack(state.pc)) {
+            return Fault::StackUnderflow;
+        }
+        PROFILE(profiler.ret());
+    } else if (Quirks::superChip && (opcode & 0xFFF0) == 0x00C0) {
+        // Scroll down [nibble] lines
+        forEachPlane<Quirks>([this, opcode](vram_t& plane) {scrollDown(plane, nibble(opcode));});
+    } else if (Quirks::xoChip && (opcode & 0xFFF0) == 0x00D0) {
+        // Scroll up [nibble] lines
+        forEachPlane<Quirks>([this, opcode](vram_t& plane) {scrollUp(plane, nibble(opcode));});
+    } else if (Quirks::superChip && opcode == 0x00FB) {
+        forEachPlane<Quirks>([this](vram_t& plane) {scrollRight(plane);});
+    } else if (Quirks::superChip && opcode == 0x00FC) {
+        forEachPlane<Quirks>([this](vram_t& plane) {scrollLeft(plane);});
+    } else if (Quirks::superChip && opcode == 0x00FD) {
+        // Exit the interpreter
+        state.running = false;
+    } else if (Quirks::superChip && (opcode == 0x00FE || opcode == 0x00FF)) {
+        // Switch to low (FE) or high (FF) resolution
+        state.hires = opcode == 0x00FF;
+        if constexpr (Quirks::resolutionClears) {
+            clearVRAM();
+        }
     } else if (opidx(opcode) == 0x0) {
         ; // SYS, deprecated, just nop
     } else if (opidx(opcode) == 0x1) {
@@ -62,22 +286,40 @@ void Chip8::step() {
         state.pc = addr(opcode);
     } else if (opidx(opcode) == 0x2) {
         // JSR
-        pushToStack(state.pc); // already points to next opcode
+        if (!pushToStack(state.pc)) { // already points to next opcode
+            return Fault::StackOverflow;
+        }
         state.pc = addr(opcode);
+        PROFILE(profiler.call(state.pc));
     } else if (opidx(opcode) == 0x3) {
         // Skip next instruction if Vx = byte
         if (state.v[x(opcode)] == lowByte(opcode)) {
-            state.pc += OPCODE_SIZE;
+            skipInstruction<Quirks>();
         }
     } else if (opidx(opcode) == 0x4) {
         // Skip next instruction if Vx != byte
         if (state.v[x(opcode)] != lowByte(opcode)) {
-            state.pc += OPCODE_SIZE;
+            skipInstruction<Quirks>();
+        }
+    } else if (Quirks::xoChip && opidx(opcode) == 0x5 && (nibble(opcode) == 0x2 || nibble(opcode) == 0x3)) {
+        // Save (2) or load (3) the registers from Vx to Vy, in either direction, at $I. I is left alone.
+        int direction = x(opcode) <= y(opcode) ? 1 : -1;
+        int count = (x(opcode) <= y(opcode) ? y(opcode) - x(opcode) : x(opcode) - y(opcode)) + 1;
+        if (!inBounds<Quirks>(state.i, count)) {
+            return Fault::MemoryOutOfBounds;
+        }
+        for (int n = 0; n < count; n++) {
+            int reg = x(opcode) + n * direction;
+            if (nibble(opcode) == 0x2) {
+                store<Quirks>(memory, state.i + n, state.v[reg]);
+            } else {
+                state.v[reg] = memoryAt<Quirks>(memory, state.i + n);
+            }
         }
     } else if (opidx(opcode) == 0x5 && nibble(opcode) == 0x0) {
         // Skip next instruction if Vx = Vy
         if (state.v[x(opcode)] == state.v[y(opcode)]) {
-            state.pc += OPCODE_SIZE;
+            skipInstruction<Quirks>();
         }
     } else if (opidx(opcode) == 0x6) {
         // load byte into register
@@ -91,16 +333,25 @@ void Chip8::step() {
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x1) {
         // Vx | Vy
         state.v[x(opcode)] |= state.v[y(opcode)];
+        if constexpr (Quirks::logicResetsVF) {
+            state.v[0xF] = 0;
+        }
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x2) {
         // Vx & Vy
         state.v[x(opcode)] &= state.v[y(opcode)];
+        if constexpr (Quirks::logicResetsVF) {
+            state.v[0xF] = 0;
+        }
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x3) {
         // Vx ^ Vy
         state.v[x(opcode)] ^= state.v[y(opcode)];
+        if constexpr (Quirks::logicResetsVF) {
+            state.v[0xF] = 0;
+        }
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x4) {
         // add Vy to Vx, VF = carry
         uint16_t res = state.v[x(opcode)] + state.v[y(opcode)];
-        state.v[0xF] = uint8_t(res & 0xFF00 != 0);
+        state.v[0xF] = uint8_t(Quirks::carryIsLowBit ? res & 1 : res >> 8);
         state.v[x(opcode)] = uint8_t(res & 0x00FF);
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x5) {
         // sub Vy from Vx, VF is 1 if Vx > Vy
@@ -108,56 +359,65 @@ void Chip8::step() {
         state.v[x(opcode)] -= state.v[y(opcode)];
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x6) {
         // If the least-significant bit of Vx is 1, then VF is set to 1, otherwise 0. Then Vx is divided by 2.
-        state.v[0xF] = state.v[y(opcode)] & 1;
-        state.v[x(opcode)] = state.v[y(opcode)] >> 1;
+        uint8_t source = state.v[Quirks::shiftUsesVy ? y(opcode) : x(opcode)];
+        state.v[0xF] = source & 1;
+        state.v[x(opcode)] = source >> 1;
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0x7) {
         // sub Vx from Vy and store result in Vx, VF is 1 if Vy > Vx
         state.v[0xF] = state.v[y(opcode)] > state.v[x(opcode)];
         state.v[x(opcode)] = state.v[y(opcode)] - state.v[x(opcode)];
     } else if (opidx(opcode) == 0x8 && nibble(opcode) == 0xE) {
         // If the most-significant bit of Vx is 1, then VF is set to 1, otherwise to 0. Then Vx is multiplied by 2.
-        state.v[0xF] = (state.v[y(opcode)] & 0b10000000) >> 7;
-        state.v[x(opcode)] = state.v[y(opcode)] << 1;
+        uint8_t source = state.v[Quirks::shiftUsesVy ? y(opcode) : x(opcode)];
+        state.v[0xF] = (source & 0b10000000) >> 7;
+        state.v[x(opcode)] = source << 1;
     } else if (opidx(opcode) == 0x9 && nibble(opcode) == 0x0) {
         // Skip next instruction if Vx != Vy
         if (state.v[x(opcode)] != state.v[y(opcode)]) {
-            state.pc += OPCODE_SIZE;
+            skipInstruction<Quirks>();
         }
     } else if (opidx(opcode) == 0xA) {
         // load addr into I
         state.i = addr(opcode);
     } else if (opidx(opcode) == 0xB) {
-        // jump to addr + v0
-        state.pc = addr(opcode) + state.v[0];
+        // jump to addr + v0 (or + Vx)
+        state.pc = addr(opcode) + state.v[Quirks::jumpUsesVx ? x(opcode) : 0];
     } else if (opidx(opcode) == 0xC) {
         // Random uint8 & Vx
-        state.v[x(opcode)] = randomDistribution(rng) & lowByte(opcode);
+        state.v[x(opcode)] = uint8_t(rng() >> 24) & lowByte(opcode);
+        randomDraws++;
     } else if (opidx(opcode) == 0xD) {
-        // Read [nibble] bytes from RAM starting at $[register I] and XOR them into VRAM at (Vx, Vy), wrapping on OOB
-        state.v[0xf] = 0; // set on sprite collision
-        for (int yIdx = 0; yIdx < nibble(opcode); yIdx++) {
-            uint8_t row = state.memory[state.i + yIdx];
-            int yCoord = (state.v[y(opcode)] + yIdx) % DISPLAY_HEIGHT;
-            for (int xIdx = 0; xIdx <= 8; xIdx++) {
-                int xCoord = (state.v[x(opcode)] + xIdx) % DISPLAY_WIDTH;
-                if ((row & (0x80 >> xIdx)) != 0) {
-                    if (state.vram[yCoord][xCoord] != 0) {
-                        state.v[0xf] = 1;
-                    }
-                    state.vram[yCoord][xCoord] ^= 1;
-                }
-            }
+        if (!drawSprite<Quirks>(opcode, memory)) {
+            return Fault::MemoryOutOfBounds;
         }
     } else if (opidx(opcode) == 0xE && lowByte(opcode) == 0x9E) {
-        // Skip next instruction if key [Vx] is pressed
-        if (state.input[state.v[x(opcode)]]) {
-            state.pc += 2;
+        // Skip next instruction if key [Vx] is pressed, only the low nibble selects the key like on the VIP
+        if (state.input[state.v[x(opcode)] & 0xF]) {
+            skipInstruction<Quirks>();
         }
     } else if (opidx(opcode) == 0xE && lowByte(opcode) == 0xA1) {
         // Skip next instruction if key [Vx] is not pressed
-        if (!state.input[state.v[x(opcode)]]) {
-            state.pc += 2;
+        if (!state.input[state.v[x(opcode)] & 0xF]) {
+            skipInstruction<Quirks>();
+        }
+    } else if (Quirks::xoChip && opcode == 0xF000) {
+        // Load the 16 bit address that follows into I
+        state.i = uint16_t(memoryAt<Quirks>(memory, state.pc) << 8 | memoryAt<Quirks>(memory, state.pc + 1));
+        state.pc += OPCODE_SIZE;
+    } else if (Quirks::xoChip && opidx(opcode) == 0xF && lowByte(opcode) == 0x01) {
+        // Select the planes drawn, cleared and scrolled
+        xoChip->planes = uint8_t(x(opcode) & 0x3);
+    } else if (Quirks::xoChip && opcode == 0xF002) {
+        // Load the audio pattern from $I
+        if (!inBounds<Quirks>(state.i, AUDIO_PATTERN_SIZE)) {
+            return Fault::MemoryOutOfBounds;
         }
+        for (int n = 0; n < AUDIO_PATTERN_SIZE; n++) {
+            xoChip->audioPattern[n] = memoryAt<Quirks>(memory, state.i + n);
+        }
+    } else if (Quirks::xoChip && opidx(opcode) == 0xF && lowByte(opcode) == 0x3A) {
+        // Load Vx into the pitch register
+        xoChip->pitch = state.v[x(opcode)];
     } else if (opidx(opcode) == 0xF && lowByte(opcode) == 0x07) {
         // Load the value of the delay timer into Vx
         state.v[x(opcode)] = state.delayTimer;
@@ -177,32 +437,180 @@ void Chip8::step() {
     } else if (opidx(opcode) == 0xF && lowByte(opcode) == 0x29) {
         // Load the address of digit Vx into I
         state.i = 0x5 * state.v[x(opcode)]; // 0x5 is the size of a character in bytes
+    } else if (Quirks::superChip && opidx(opcode) == 0xF && lowByte(opcode) == 0x30) {
+        // Load the address of big digit Vx into I
+        state.i = BIG_FONT_OFFSET + BIG_FONT_CHARACTER_SIZE * (state.v[x(opcode)] & 0xF);
     } else if (opidx(opcode) == 0xF && lowByte(opcode) == 0x33) {
         // Load BCD version of Vx into I, I+1, I+2
+        if (!inBounds<Quirks>(state.i, 3)) {
+            return Fault::MemoryOutOfBounds;
+        }
         uint8_t vx = state.v[x(opcode)];
         for (int i = 2; i >= 0; i--) {
-            state.memory[state.i + i] = vx % 10; // 240 -> 0
+            store<Quirks>(memory, state.i + i, vx % 10); // 240 -> 0
             vx /= 10; // 240 -> 24
         }
     } else if (opidx(opcode) == 0xF && lowByte(opcode) == 0x55) {
         // Load V0-Vx into memory at $I
+        if (!inBounds<Quirks>(state.i, x(opcode) + 1)) {
+            return Fault::MemoryOutOfBounds;
+        }
         for (int reg = 0; reg <= x(opcode); reg++) {
-            state.memory[state.i + reg] = state.v[reg];
+            store<Quirks>(memory, state.i + reg, state.v[reg]);
         }
+        advanceIndex<Quirks>(x(opcode));
     } else if (opidx(opcode) == 0xF && lowByte(opcode) == 0x65) {
         // Load registers V0-Vx from $I
+        if (!inBounds<Quirks>(state.i, x(opcode) + 1)) {
+            return Fault::MemoryOutOfBounds;
+        }
         for (int reg = 0; reg <= x(opcode); reg++) {
-            state.v[reg] = state.memory[state.i + reg];
+            state.v[reg] = memoryAt<Quirks>(memory, state.i + reg);
+        }
+        advanceIndex<Quirks>(x(opcode));
+    } else if (Quirks::superChip && opidx(opcode) == 0xF && lowByte(opcode) == 0x75) {
+        // Save V0-Vx into the RPL user flags
+        for (int reg = 0; reg <= x(opcode); reg++) {
+            state.rpl[reg] = state.v[reg];
+        }
+    } else if (Quirks::superChip && opidx(opcode) == 0xF && lowByte(opcode) == 0x85) {
+        // Load V0-Vx from the RPL user flags
+        for (int reg = 0; reg <= x(opcode); reg++) {
+            state.v[reg] = state.rpl[reg];
         }
     } else {
-        std::stringstream message;
-        message << std::hex;
-        message << "Unknown opcode ";
-        message << opcode;
-        message << " at 0x";
-        message << (state.pc - OPCODE_SIZE);
-        throw std::runtime_error(message.str());
+        if constexpr (Quirks::memoryPolicy == MemoryPolicy::Guarded && !Quirks::xoChip) {
+            if (state.pc > MEMORY_SIZE) { // fetched from the guard bytes, PC has moved past them
+                return Fault::PcOutOfBounds;
+            }
+        }
+        return Fault::UnknownOpcode;
+    }
+    return Fault::None;
+}
+
+template <typename Quirks>
+bool Chip8::drawSprite(uint16_t opcode, uint8_t* memory) {
+    // Read [nibble] bytes from RAM starting at $[register I] and XOR them into VRAM at (Vx, Vy),
+    // wrapping or clipping on OOB. With SCHIP, a nibble of 0 draws a 16x16 sprite stored as two bytes per row.
+    // With XO-CHIP, each selected plane gets its own sprite, stored one after the other.
+    PROFILE(Profiler::Timer drawTimer(profiler.drawTime));
+    const bool wide = Quirks::superChip && nibble(opcode) == 0;
+    const int rows = wide ? 16 : nibble(opcode);
+    const int size = wide ? 2 * rows : rows;
+    if constexpr (Quirks::memoryPolicy == MemoryPolicy::Checked) {
+        int planes = Quirks::xoChip ? (xoChip->planes & 1) + (xoChip->planes >> 1 & 1) : 1;
+        if (!inBounds<Quirks>(state.i, planes * size)) {
+            return false;
+        }
+    }
+    int address = state.i;
+    bool collided = false;
+    state.v[0xf] = 0; // set on sprite collision
+    forEachPlane<Quirks>([&](vram_t& plane) {
+        // A sprite running off the end of memory continues from the start, copied so the rows stay contiguous
+        const uint8_t* sprite = &memoryAt<Quirks>(memory, address);
+        uint8_t wrapped[2 * 16];
+        const int end = (address & addressMask<Quirks>()) + size;
+        if (Quirks::memoryPolicy != MemoryPolicy::Checked && end > addressMask<Quirks>() + 1) {
+            for (int n = 0; n < size; n++) {
+                wrapped[n] = memoryAt<Quirks>(memory, address + n);
+            }
+            sprite = wrapped;
+        }
+        if (wide) {
+            collided |= drawSpriteRows<Quirks, 16>(opcode, rows, sprite, plane);
+        } else {
+            collided |= drawSpriteRows<Quirks, 8>(opcode, rows, sprite, plane);
+        }
+        address += size;
+    });
+    if (collided) {
+        state.v[0xf] = 1;
+    }
+    return true;
+}
+
+template <typename Quirks, int Columns>
+bool Chip8::drawSpriteRows(uint16_t opcode, int rows, const uint8_t* sprite, vram_t& plane) {
+    const int width = Quirks::superChip ? state.screenWidth() : DISPLAY_WIDTH;
+    const int height = Quirks::superChip ? state.screenHeight() : DISPLAY_HEIGHT;
+    bool collided = false;
+    uint64_t& hash = planeHash(plane);
+    const uint64_t* keys = pixelKeys(planeIndex(plane));
+    // Both resolutions are powers of two, so wrapping is a mask
+    int xOrigin = state.v[x(opcode)] & (width - 1);
+    int yOrigin = state.v[y(opcode)] & (height - 1);
+    for (int yIdx = 0; yIdx < rows; yIdx++) {
+        uint16_t row = Columns == 16 ? sprite[2 * yIdx] << 8 | sprite[2 * yIdx + 1] : sprite[yIdx] << 8;
+        int yCoord = yOrigin + yIdx;
+        if constexpr (Quirks::wrapSprites) {
+            yCoord &= height - 1;
+        } else if (yCoord >= height) {
+            break;
+        }
+        for (int xIdx = 0; xIdx < Columns; xIdx++) {
+            int xCoord = xOrigin + xIdx;
+            if constexpr (Quirks::wrapSprites) {
+                xCoord &= width - 1;
+            } else if (xCoord >= width) {
+                break;
+            }
+            if ((row & (0x8000 >> xIdx)) != 0) {
+                collided |= plane[yCoord][xCoord] != 0;
+                plane[yCoord][xCoord] ^= 1;
+                hash ^= keys[yCoord * HIRES_WIDTH + xCoord];
+            }
+        }
+    }
+    return collided;
+}
+
+// The scrolls move the framebuffer as one block, rows being contiguous, instead of copying pixel by pixel
+
+void Chip8::scrollDown(vram_t& plane, int lines) {
+    static_assert(sizeof(vram_t) == HIRES_WIDTH * HIRES_HEIGHT, "VRAM rows must be contiguous");
+    const int height = state.screenHeight();
+    lines = std::min(lines, height);
+    uint8_t* pixels = plane[0].data();
+    std::memmove(pixels + lines * HIRES_WIDTH, pixels, size_t((height - lines) * HIRES_WIDTH));
+    std::memset(pixels, 0, size_t(lines * HIRES_WIDTH));
+    state.staleVram |= uint8_t(1 << planeIndex(plane));
+}
+
+void Chip8::scrollUp(vram_t& plane, int lines) {
+    const int height = state.screenHeight();
+    lines = std::min(lines, height);
+    uint8_t* pixels = plane[0].data();
+    std::memmove(pixels, pixels + lines * HIRES_WIDTH, size_t((height - lines) * HIRES_WIDTH));
+    std::memset(pixels + (height - lines) * HIRES_WIDTH, 0, size_t(lines * HIRES_WIDTH));
+    state.staleVram |= uint8_t(1 << planeIndex(plane));
+}
+
+void Chip8::scrollRight(vram_t& plane) {
+    const int width = state.screenWidth();
+    uint8_t* pixels = plane[0].data();
+    std::memmove(pixels + SCROLL_DISTANCE, pixels, sizeof(vram_t) - SCROLL_DISTANCE);
+    // Clear what came in from the end of the previous row, and what was pushed off a low resolution screen
+    for (auto& row : plane) {
+        std::fill(row.begin(), row.begin() + SCROLL_DISTANCE, 0);
+        if (width < HIRES_WIDTH) {
+            std::fill(row.begin() + width, row.begin() + width + SCROLL_DISTANCE, 0);
+        }
     }
+    state.staleVram |= uint8_t(1 << planeIndex(plane));
+}
+
+void Chip8::scrollLeft(vram_t& plane) {
+    const int width = state.screenWidth();
+    uint8_t* pixels = plane[0].data();
+    std::memmove(pixels, pixels + SCROLL_DISTANCE, sizeof(vram_t) - SCROLL_DISTANCE);
+    // Clear what came in from the start of the next row, and the right edge of a low resolution screen
+    for (auto& row : plane) {
+        std::fill(row.begin() + width - SCROLL_DISTANCE, row.begin() + width, 0);
+        std::fill(row.end() - SCROLL_DISTANCE, row.end(), 0);
+    }
+    state.staleVram |= uint8_t(1 << planeIndex(plane));
 }
 
 void Chip8::tickTimers() {
@@ -210,40 +618,23 @@ void Chip8::tickTimers() {
         state.delayTimer--;
     }
     if (state.soundTimer > 0) {
-        state.soundTimer--;
-        // TODO: audio
+        state.soundTimer--; // the tone plays while this is non-zero, see ToneGenerator
     }
 }
 
 void Chip8::clearVRAM() {
-    for (auto& row : state.vram) {
-        std::fill(row.begin(), row.end(), 0);
+    clearPlane(state.vram);
+    if (xoChip) {
+        clearPlane(xoChip->plane2);
     }
 }
 
-void Chip8::pushToStack(uint16_t address) {
-    if (state.sp <= 0) { // Stack is full
-        std::cerr << "Tried to push with a full stack, ignoring" << std::endl;
-        return;
-    } else if (state.sp > STACK_SIZE) { // Stack pointer out of bounds
-        std::cerr << "Stack pointer out of bounds, resetting to sane value" << std::endl;
-        state.sp = STACK_SIZE;
-    }
-    state.sp--;
-    state.stack[state.sp] = address;
-}
-
-uint16_t Chip8::popFromStack() {
-    if (state.sp <= 0) { // Stack pointer out of bounds
-        std::cerr << "Stack pointer out of bounds, resetting to sane value" << std::endl;
-        state.sp = 0;
-    } else if (state.sp >= STACK_SIZE) { // Stack is empty
-        std::cerr << "Tried to pop with an empty stack, returning 0" << std::endl;
-        return 0;
+void Chip8::clearPlane(vram_t& plane) {
+    for (auto& row : plane) {
+        std::fill(row.begin(), row.end(), 0);
     }
-    uint16_t res = state.stack[state.sp];
-    state.sp++;
-    return res;
+    planeHash(plane) = 0;
+    state.staleVram &= uint8_t(~(1 << planeIndex(plane)));
 }
 
 void Chip8::keyInput(uint8_t keyId) {
@@ -254,3 +645,130 @@ void Chip8::keyInput(uint8_t keyId) {
     state.acceptingInputInto = -1;
     state.running = true;
 }
+
+Chip8::Snapshot Chip8::snapshot() const {
+    return {state, xoChip ? std::make_unique<XoChipState>(*xoChip) : nullptr, rng, randomSeed, randomDraws};
+}
+
+void Chip8::restore(const Snapshot& snapshot) {
+    state = snapshot.state;
+    if (!snapshot.xoChip) {
+        xoChip.reset();
+    } else if (xoChip) {
+        *xoChip = *snapshot.xoChip;
+    } else {
+        xoChip = std::make_unique<XoChipState>(*snapshot.xoChip);
+    }
+    rng = snapshot.rng;
+    randomSeed = snapshot.randomSeed;
+    randomDraws = snapshot.randomDraws;
+}
+
+uint64_t Chip8::stateHash() const {
+    return hashWith(xoChip ? xoChip->memoryHash : state.memoryHash, vramHash(0), xoChip ? vramHash(1) : 0);
+}
+
+uint64_t Chip8::vramHash(int plane) const {
+    // Sprites drawn after a scroll still flip their keys in the stale hash, which is thrown away here
+    uint64_t& hash = plane == 0 ? state.vramHash : xoChip->plane2Hash;
+    if ((state.staleVram & (1 << plane)) != 0) {
+        hash = hashPlane(plane == 0 ? state.vram : xoChip->plane2, plane);
+        state.staleVram &= uint8_t(~(1 << plane));
+    }
+    return hash;
+}
+
+uint64_t Chip8::computeStateHash() const {
+    if (xoChip) {
+        return hashWith(hashMemory(xoChip->memory.data(), XO_MEMORY_SIZE), hashPlane(state.vram, 0),
+                        hashPlane(xoChip->plane2, 1));
+    }
+    return hashWith(hashMemory(state.memory, MEMORY_SIZE), hashPlane(state.vram, 0), 0);
+}
+
+void Chip8::rehash() {
+    state.memoryHash = hashMemory(state.memory, MEMORY_SIZE);
+    state.vramHash = hashPlane(state.vram, 0);
+    state.staleVram = 0;
+    if (xoChip) {
+        xoChip->memoryHash = hashMemory(xoChip->memory.data(), XO_MEMORY_SIZE);
+        xoChip->plane2Hash = hashPlane(xoChip->plane2, 1);
+    }
+}
+
+uint64_t Chip8::hashWith(uint64_t memoryHash, uint64_t vramHash, uint64_t plane2Hash) const {
+    // The registers are hashed whole on every call, a few words being cheaper than updating a hash on every instruction
+    uint64_t words[20] = {memoryHash, vramHash, plane2Hash, randomSeed, randomDraws};
+    int count = 5;
+    auto pack = [&words, &count](const void* data, size_t size) {
+        std::memcpy(&words[count], data, size);
+        count += int((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    };
+    pack(state.v, sizeof(state.v));
+    pack(state.stack, sizeof(state.stack));
+    pack(state.rpl, sizeof(state.rpl));
+    words[count++] = uint64_t(state.i) | uint64_t(state.pc) << 16 | uint64_t(state.sp) << 32 |
+                     uint64_t(state.delayTimer) << 48 | uint64_t(state.soundTimer) << 56;
+    words[count++] = uint64_t(state.running) | uint64_t(state.hires) << 1 | uint64_t(state.acceptingInputInto + 1) << 8;
+    if (xoChip) {
+        words[count++] = uint64_t(xoChip->planes) | uint64_t(xoChip->pitch) << 8;
+        pack(xoChip->audioPattern, sizeof(xoChip->audioPattern));
+    }
+    uint64_t hash = 0;
+    for (int n = 0; n < count; n++) {
+        hash = mixHash(hash + words[n] + 0x9E3779B97F4A7C15);
+    }
+    return hash;
+}
+
+#ifdef YACHIE_EXECUTION_LOG
+bool Chip8::writeExecutionLog(const std::string& filename) {
+    ExecutionLog::Registers registers {};
+    std::copy(std::begin(state.v), std::end(state.v), std::begin(registers.v));
+    registers.i = state.i;
+    registers.pc = state.pc;
+    registers.sp = state.sp;
+    registers.delayTimer = state.delayTimer;
+    registers.soundTimer = state.soundTimer;
+    return executionLog.write(filename, registers);
+}
+#endif
+
+std::string describeFault(const FaultRecord& fault) {
+    std::stringstream message;
+    message << std::hex;
+    switch (fault.fault) {
+    case Fault::None:
+        message << "No fault";
+        break;
+    case Fault::PcOutOfBounds:
+        message << "PC went out of bounds at 0x" << fault.pc;
+        break;
+    case Fault::UnknownOpcode:
+        message << "Unknown opcode " << fault.opcode << " at 0x" << fault.pc;
+        break;
+    case Fault::StackOverflow:
+        message << "Tried to call with a full stack at 0x" << fault.pc;
+        break;
+    case Fault::StackUnderflow:
+        message << "Tried to return with an empty stack at 0x" << fault.pc;
+        break;
+    case Fault::MemoryOutOfBounds:
+        message << "Opcode " << fault.opcode << " at 0x" << fault.pc << " accessed memory out of bounds";
+        break;
+    }
+    return message.str();
+}
+
+bool parseMemoryPolicy(const std::string& name, MemoryPolicy& policy) {
+    if (name == "guarded") {
+        policy = MemoryPolicy::Guarded;
+    } else if (name == "wrap") {
+        policy = MemoryPolicy::Wrap;
+    } else if (name == "checked") {
+        policy = MemoryPolicy::Checked;
+    } else {
+        return false;
+    }
+    return true;
+}
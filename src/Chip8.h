@@ -3,14 +3,39 @@
 
 #include <array>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <random>
-#include "Display.h"
+#include <string>
+#include <vector>
+#include "Debugger.h"
+#include "ExecutionLog.h"
+#include "Profiler.h"
+#include "Quirks.h"
 
+constexpr int DISPLAY_WIDTH = 64;
+constexpr int DISPLAY_HEIGHT = 32;
+constexpr int HIRES_WIDTH = 128; // SCHIP high resolution mode
+constexpr int HIRES_HEIGHT = 64;
 constexpr int PROGRAM_OFFSET = 0x200;
 constexpr int MEMORY_SIZE = 4096;
+constexpr int XO_MEMORY_SIZE = 0x10000;
+constexpr int XO_MEMORY_GUARD = 32; // lets fetches at 0xFFFF read past the end without checks
+constexpr int MEMORY_GUARD = 0x100; // covers BNNN's furthest target, 0xFFF + 0xFF, see MemoryPolicy::Guarded
+constexpr uint8_t MEMORY_GUARD_BYTE = 0xFF; // FFFF is an unknown opcode in every profile
+constexpr int AUDIO_PATTERN_SIZE = 16; // XO-CHIP's 128 bit audio pattern
+constexpr uint8_t DEFAULT_PITCH = 64; // plays the audio pattern at 4000 bits per second
+constexpr uint8_t DEFAULT_AUDIO_PATTERN[AUDIO_PATTERN_SIZE] = { // a 250Hz square wave at DEFAULT_PITCH
+    0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF,
+};
 constexpr int OPCODE_SIZE = 2;
 constexpr int STACK_SIZE = 16;
 constexpr int NUMBER_OF_KEYS = 16;
+constexpr int NUMBER_OF_REGISTERS = 16;
+constexpr int RPL_FLAGS = 16; // SCHIP's HP-48 user flags, XO-CHIP allows 16
+constexpr int SCROLL_DISTANCE = 4; // pixels moved by 00FB/00FC
+constexpr int BIG_FONT_OFFSET = 0x50; // just after FONT_SET
+constexpr int BIG_FONT_CHARACTER_SIZE = 10;
 constexpr float TIMER_FREQUENCY = 1.f / 60.f; // Sound and delay timers are 60Hz
 constexpr float CPU_FREQUENCY = 1.f / 1000.f; // CPU frequency is ill defined, using 1KHz here
 constexpr uint8_t FONT_SET[] = {
@@ -31,10 +56,31 @@ constexpr uint8_t FONT_SET[] = {
     0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
     0xF0, 0x80, 0xF0, 0x80, 0x80  // F
 };
+constexpr uint8_t BIG_FONT_SET[] = { // 8x10 SCHIP digits, A-F come from XO-CHIP
+    0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, // 0
+    0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, // 1
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // 2
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 3
+    0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 5
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 6
+    0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, // 7
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 8
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 9
+    0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, // A
+    0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, // B
+    0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C, // C
+    0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, // D
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // E
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0  // F
+};
+
+// Sized for high resolution mode, low resolution mode only uses the top left DISPLAY_WIDTH x DISPLAY_HEIGHT pixels
+using vram_t = std::array<std::array<uint8_t, HIRES_WIDTH>, HIRES_HEIGHT>;
 
 struct Chip8State {
-    uint8_t memory[MEMORY_SIZE];
-    uint8_t v[16]; // registers
+    uint8_t memory[MEMORY_SIZE + MEMORY_GUARD]; // MEMORY_SIZE bytes followed by the guard
+    uint8_t v[NUMBER_OF_REGISTERS];
     uint8_t soundTimer;
     uint8_t delayTimer;
     uint16_t pc;
@@ -45,22 +91,236 @@ struct Chip8State {
     bool input[NUMBER_OF_KEYS];
     bool running = false;
     int acceptingInputInto = -1;
+    bool hires = false; // SCHIP 128x64 mode
+    uint8_t rpl[RPL_FLAGS]; // FX75/FX85, kept when loading another ROM like the HP-48 did
+    // Hashes of memory and VRAM, updated on every store and pixel flip for Chip8::stateHash(). Scrolls move every pixel
+    // at once, so they only mark the plane in staleVram, and Chip8::vramHash() hashes it again when it's next needed.
+    uint64_t memoryHash = 0;
+    mutable uint64_t vramHash = 0;
+    mutable uint8_t staleVram = 0; // bitmask of the planes scrolled since their hash was last computed
+
+    int screenWidth() const {return hires ? HIRES_WIDTH : DISPLAY_WIDTH;}
+    int screenHeight() const {return hires ? HIRES_HEIGHT : DISPLAY_HEIGHT;}
+};
+
+// State only XO-CHIP needs, allocated when that profile is used so that other instances stay small
+struct XoChipState {
+    XoChipState();
+    std::vector<uint8_t> memory; // XO_MEMORY_SIZE bytes followed by XO_MEMORY_GUARD bytes, replaces Chip8State::memory
+    vram_t plane2; // the second bitplane, Chip8State::vram being the first
+    uint8_t planes = 1; // bitmask of the planes drawn, cleared and scrolled (FN01)
+    uint8_t audioPattern[AUDIO_PATTERN_SIZE]; // F002
+    uint8_t pitch = DEFAULT_PITCH; // FX3A
+    uint64_t memoryHash = 0; // see Chip8State::memoryHash
+    mutable uint64_t plane2Hash = 0; // see Chip8State::vramHash
+};
+
+enum class Fault : uint8_t {
+    None,
+    PcOutOfBounds,
+    UnknownOpcode,
+    StackOverflow, // 2NNN with 16 return addresses on the stack
+    StackUnderflow, // 00EE with an empty stack
+    MemoryOutOfBounds, // an access relative to I went past the end of memory, only with MemoryPolicy::Checked
+};
+
+// What happens when an instruction faults
+enum class FaultPolicy : uint8_t {
+    Halt, // stop with PC on the faulting instruction
+    Skip, // carry on with the next instruction, as if the faulting one was a no-op (PC faults always halt)
+    Trap, // ask Chip8::trapHandler, which returns Halt, Skip or Pause
+    // Only returned by a trap handler: pause Chip8::debugger with PC on the faulting instruction, which runs (and
+    // faults) again when resumed
+    Pause,
 };
 
+// What happens to guest memory accesses past the end of memory. Like the quirk profile, it's chosen once per
+// Chip8::run() call, execute() being specialized on it.
+enum class MemoryPolicy : uint8_t {
+    // Fetches read straight from memory, which MEMORY_GUARD bytes of MEMORY_GUARD_BYTE follow: once PC gets there, the
+    // unknown opcode they form faults as PcOutOfBounds. An instruction at 0xFFF reads its second byte from the guard.
+    // Accesses relative to I wrap.
+    Guarded,
+    Wrap, // every address, PC included, is masked to the memory size like on the VIP, so nothing faults
+    Checked, // PC and accesses relative to I are checked, faulting with PcOutOfBounds or MemoryOutOfBounds
+};
+
+bool parseMemoryPolicy(const std::string& name, MemoryPolicy& policy);
+
+// A quirk profile and a memory policy, which is what execute() is specialized on
+template <typename Quirks, MemoryPolicy Policy>
+struct WithMemoryPolicy : Quirks {
+    static constexpr MemoryPolicy memoryPolicy = Policy;
+};
+
+struct FaultRecord {
+    Fault fault = Fault::None;
+    uint16_t pc = 0; // address of the faulting instruction
+    uint16_t opcode = 0;
+};
+
+struct RunResult {
+    int executed; // instructions completed, including skipped ones
+    FaultRecord fault; // the fault that halted the machine, or the last skipped one
+    DebugStop stop = DebugStop::None; // why the debugger stopped the run, if it did
+};
+
+// Formatting is left to the caller so that faulting stays cheap
+std::string describeFault(const FaultRecord& fault);
+
 class Chip8 {
 public:
     Chip8();
     void initState();
     void load(std::string filename);
-    void step();
+    bool load(const uint8_t* rom, size_t size); // false if the ROM was truncated to fit in memory
+    Fault step();
+    RunResult run(int instructions); // stops early when the machine halts, waits for a key or the debugger stops it
     void tickTimers();
     void clearVRAM();
     void keyInput(uint8_t keyId);
+    // Makes CXNN repeatable, it's seeded randomly otherwise
+    void seedRandom(uint32_t seed) {
+        randomSeed = seed;
+        randomDraws = 0;
+        rng.seed(seed);
+    }
+    // A 64 bit hash of everything that decides how the machine carries on: registers, stack, timers, memory, VRAM,
+    // the XO-CHIP state and where the RNG is (its seed and the number of CXNN draws since), but not the keys held.
+    // Memory and VRAM are hashed incrementally as the interpreter writes them, so this costs the same whatever the
+    // memory size. Equal states always hash the same.
+    uint64_t stateHash() const;
+    // The Zobrist hash of a plane's pixels, 0 for the first one, which changes whenever a pixel does
+    uint64_t vramHash(int plane = 0) const;
+    uint64_t computeStateHash() const; // stateHash() from scratch, for checking the incremental hashes
+    void rehash(); // brings the incremental hashes up to date after writing memory or VRAM directly
+    // A copy of everything run() changes, the RNG included, for forking a machine: restoring it into a Chip8 with the
+    // same profile and policies carries on exactly as the original would
+    struct Snapshot {
+        Chip8State state;
+        std::unique_ptr<XoChipState> xoChip;
+        std::mt19937 rng;
+        uint32_t randomSeed;
+        uint64_t randomDraws;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot& snapshot);
+    EXECUTION_LOG(bool writeExecutionLog(const std::string& filename);)
+    // The memory the interpreter is using, which is XoChipState::memory with the XO-CHIP profile
+    uint8_t* memory() {return xoChip ? xoChip->memory.data() : state.memory;}
+    const uint8_t* memory() const {return xoChip ? xoChip->memory.data() : state.memory;}
+    int memorySize() const {return xoChip ? XO_MEMORY_SIZE : MEMORY_SIZE;}
+    const vram_t* secondPlane() const {return xoChip ? &xoChip->plane2 : nullptr;}
     Chip8State state;
+    std::unique_ptr<XoChipState> xoChip; // only allocated with QuirkProfile::XoChip
+    QuirkProfile quirkProfile = QuirkProfile::Yachie;
+    FaultPolicy faultPolicy = FaultPolicy::Halt;
+    MemoryPolicy memoryPolicy = MemoryPolicy::Guarded;
+    std::function<FaultPolicy(Chip8&, const FaultRecord&)> trapHandler;
+    Debugger debugger;
+    PROFILE(Profiler profiler;)
+    EXECUTION_LOG(ExecutionLog executionLog;)
 
 private:
-    void pushToStack(uint16_t address);
-    uint16_t popFromStack();
+    template <bool Debugging> RunResult runProfile(int instructions);
+    template <typename Quirks, bool Debugging> RunResult runPolicy(int instructions);
+    template <typename Quirks, bool Debugging> RunResult runWith(int instructions);
+    template <typename Quirks> int storeLength(uint16_t opcode); // bytes written from I, 0 if none
+    template <typename Quirks> Fault execute();
+    template <typename Quirks> inline uint8_t* activeMemory() {
+        return Quirks::xoChip ? xoChip->memory.data() : state.memory;
+    }
+    // All guest memory access goes through fetch(), inBounds() and memoryAt(), which apply Quirks::memoryPolicy
+    template <typename Quirks> static constexpr int addressMask() {
+        return (Quirks::xoChip ? XO_MEMORY_SIZE : MEMORY_SIZE) - 1;
+    }
+    // The opcode at PC, false if PC is out of bounds. Only Checked tests PC here, the other policies can't fail.
+    template <typename Quirks> inline bool fetch(const uint8_t* memory, uint16_t& opcode) {
+        if constexpr (Quirks::memoryPolicy == MemoryPolicy::Wrap) {
+            state.pc &= addressMask<Quirks>();
+            opcode = uint16_t(memory[state.pc] << 8 | memory[(state.pc + 1) & addressMask<Quirks>()]);
+            return true;
+        } else if constexpr (Quirks::memoryPolicy == MemoryPolicy::Checked) {
+            if (state.pc >= addressMask<Quirks>()) {
+                return false;
+            }
+        }
+        opcode = uint16_t(memory[state.pc] << 8 | memory[state.pc + 1]);
+        return true;
+    }
+    // Whether an instruction may access length bytes from address, checked before it touches any of them
+    template <typename Quirks> inline bool inBounds(int address, int length) {
+        if constexpr (Quirks::memoryPolicy == MemoryPolicy::Checked) {
+            return address + length <= addressMask<Quirks>() + 1;
+        }
+        return true;
+    }
+    // A byte at an address relative to I, wrapped unless inBounds() has checked it
+    template <typename Quirks> inline uint8_t& memoryAt(uint8_t* memory, int address) {
+        if constexpr (Quirks::memoryPolicy == MemoryPolicy::Checked) {
+            return memory[address];
+        }
+        return memory[address & addressMask<Quirks>()];
+    }
+    // Writes go through here rather than memoryAt() to keep the memory hash up to date
+    template <typename Quirks> inline void store(uint8_t* memory, int address, uint8_t value);
+    // Calls function with each plane selected by FN01, which is just the one plane without XO-CHIP
+    template <typename Quirks, typename Function> inline void forEachPlane(Function function) {
+        if constexpr (Quirks::xoChip) {
+            if ((xoChip->planes & 1) != 0) {
+                function(state.vram);
+            }
+            if ((xoChip->planes & 2) != 0) {
+                function(xoChip->plane2);
+            }
+        } else {
+            function(state.vram);
+        }
+    }
+    template <typename Quirks> inline void skipInstruction() {
+        // XO-CHIP's F000 NNNN is twice as long as the other instructions
+        uint8_t* memory = activeMemory<Quirks>();
+        bool longInstruction = Quirks::xoChip && memoryAt<Quirks>(memory, state.pc) == 0xF0 &&
+                               memoryAt<Quirks>(memory, state.pc + 1) == 0x00;
+        state.pc += longInstruction ? 2 * OPCODE_SIZE : OPCODE_SIZE;
+    }
+    void enableXoChip();
+    // False if the sprite is out of bounds
+    template <typename Quirks> bool drawSprite(uint16_t opcode, uint8_t* memory);
+    template <typename Quirks, int Columns>
+    bool drawSpriteRows(uint16_t opcode, int rows, const uint8_t* sprite, vram_t& plane);
+    void clearPlane(vram_t& plane);
+    int planeIndex(const vram_t& plane) const {return &plane == &state.vram ? 0 : 1;}
+    uint64_t& planeHash(const vram_t& plane) {return &plane == &state.vram ? state.vramHash : xoChip->plane2Hash;}
+    uint64_t hashWith(uint64_t memoryHash, uint64_t vramHash, uint64_t plane2Hash) const;
+    void scrollDown(vram_t& plane, int lines);
+    void scrollUp(vram_t& plane, int lines);
+    void scrollRight(vram_t& plane);
+    void scrollLeft(vram_t& plane);
+    template <typename Quirks> inline void advanceIndex(uint16_t lastRegister) {
+        // FX55/FX65
+        if constexpr (Quirks::loadStoreIndex == IndexQuirk::IncrementByX) {
+            state.i += lastRegister;
+        } else if constexpr (Quirks::loadStoreIndex == IndexQuirk::IncrementByXPlusOne) {
+            state.i += lastRegister + 1;
+        }
+    }
+    inline bool pushToStack(uint16_t address) {
+        if (state.sp == 0 || state.sp > STACK_SIZE) { // Stack is full or the stack pointer is out of bounds
+            return false;
+        }
+        state.sp--;
+        state.stack[state.sp] = address;
+        return true;
+    }
+    inline bool popFromStack(uint16_t& address) {
+        if (state.sp >= STACK_SIZE) { // Stack is empty or the stack pointer is out of bounds
+            return false;
+        }
+        address = state.stack[state.sp];
+        state.sp++;
+        return true;
+    }
     // Convenience functions
     inline uint16_t opidx(uint16_t op) {return (op & 0xF000) >> 12;} // X000
     inline uint16_t addr(uint16_t op) {return op & 0x0FFF;} // 0XXX
@@ -69,8 +329,10 @@ private:
     inline uint16_t y(uint16_t op) {return (op & 0x00F0) >> 4;} // 00X0
     inline uint8_t lowByte(uint16_t op) {return uint8_t(op & 0x00FF);} // 00XX
     std::random_device device;
-    std::mt19937 rng;
-    std::uniform_int_distribution<int> randomDistribution;
+    // mt19937's state can't be hashed cheaply, so stateHash() goes by the seed and how many numbers were drawn since
+    uint32_t randomSeed;
+    uint64_t randomDraws = 0;
+    std::mt19937 rng; // CXNN takes the top byte, mt19937's output is the same everywhere unlike the distributions
 };
 
 #endif //CHIP8_CHIP8_H
@@ -0,0 +1,179 @@
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include "DebugConsole.h"
+#include "Opcodes.h"
+
+constexpr int DEFAULT_LISTING_LENGTH = 8; // instructions shown by "l"
+constexpr int DEFAULT_DUMP_LENGTH = 64; // bytes shown by "x"
+constexpr int DUMP_BYTES_PER_LINE = 16;
+
+namespace {
+
+const char* HELP =
+    "  b ADDR           set a breakpoint         bd ADDR        delete a breakpoint\n"
+    "  w ADDR [LEN]     watch stores to memory   wd ADDR [LEN]  stop watching\n"
+    "  clear            delete all breakpoints and watchpoints\n"
+    "  c                continue                 p              pause\n"
+    "  s [N]            step N instructions      f [N]          run N frames\n"
+    "  r                show registers           x ADDR [LEN]   show memory\n"
+    "  l [ADDR] [N]     list N instructions from ADDR, or from PC\n"
+    "Addresses are hexadecimal, counts decimal.\n";
+
+std::string hex(int value, int width) {
+    std::stringstream text;
+    text << std::hex << std::uppercase << std::setw(width) << std::setfill('0') << value;
+    return text.str();
+}
+
+} // namespace
+
+DebugConsole::DebugConsole(Chip8& cpu, std::istream& in, std::ostream& out) : cpu(cpu), in(in), out(out) {}
+
+void DebugConsole::start() {
+    out << "Debugger commands:\n" << HELP << std::flush;
+    // Detached, since there's no way to interrupt a blocking read at exit
+    std::thread([this] {
+        std::string line;
+        while (std::getline(in, line)) {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(line);
+        }
+    }).detach();
+}
+
+void DebugConsole::poll() {
+    std::deque<std::string> lines;
+    {
+        // Never wait for the reader thread, the commands can run on the next poll
+        std::unique_lock<std::mutex> lock(queueMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            lines.swap(queue);
+        }
+    }
+    for (const auto& line : lines) {
+        if (!execute(line)) {
+            out << "Unknown command, one of:\n" << HELP;
+        }
+    }
+    if (cpu.debugger.isPaused() && !wasPaused) {
+        report();
+    }
+    wasPaused = cpu.debugger.isPaused();
+    if (!lines.empty()) {
+        out << std::flush;
+    }
+}
+
+void DebugConsole::halted(const FaultRecord& fault) {
+    out << "Halted: " << describeFault(fault) << "\n";
+    printInstructions(fault.pc, 1);
+    out << std::flush;
+}
+
+FaultPolicy DebugConsole::trap(const FaultRecord& fault) {
+    trapped = fault;
+    return FaultPolicy::Pause;
+}
+
+bool DebugConsole::execute(const std::string& line) {
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command)) {
+        return true;
+    }
+    int first = -1;
+    int second = -1;
+    // Only addresses are hexadecimal
+    bool addressFirst = command != "s" && command != "f";
+    if (!(words >> (addressFirst ? std::hex : std::dec) >> first)) {
+        first = -1;
+    }
+    if (!(words >> std::dec >> second)) {
+        second = -1;
+    }
+    uint16_t pc = cpu.state.pc;
+    if (command == "b" && first >= 0) {
+        cpu.debugger.setBreakpoint(uint16_t(first));
+    } else if (command == "bd" && first >= 0) {
+        cpu.debugger.setBreakpoint(uint16_t(first), false);
+    } else if (command == "w" && first >= 0) {
+        cpu.debugger.setWatchpoint(uint16_t(first), second > 0 ? second : 1);
+    } else if (command == "wd" && first >= 0) {
+        cpu.debugger.setWatchpoint(uint16_t(first), second > 0 ? second : 1, false);
+    } else if (command == "clear") {
+        cpu.debugger.clear();
+    } else if (command == "c") {
+        cpu.debugger.resume(pc);
+    } else if (command == "p") {
+        cpu.debugger.pause();
+    } else if (command == "s") {
+        cpu.debugger.step(pc, first > 0 ? first : 1);
+    } else if (command == "f") {
+        cpu.debugger.runFrames(pc, first > 0 ? first : 1);
+    } else if (command == "r") {
+        printRegisters();
+    } else if (command == "x" && first >= 0) {
+        printMemory(first, second > 0 ? second : DEFAULT_DUMP_LENGTH);
+    } else if (command == "l") {
+        printInstructions(first >= 0 ? first : pc, second > 0 ? second : DEFAULT_LISTING_LENGTH);
+    } else {
+        return false;
+    }
+    wasPaused = wasPaused && cpu.debugger.isPaused(); // report the next stop, even if it happens straight away
+    return true;
+}
+
+void DebugConsole::report() {
+    switch (cpu.debugger.lastStop()) {
+    case DebugStop::Breakpoint:
+        out << "Breakpoint";
+        break;
+    case DebugStop::Watchpoint:
+        out << "Watchpoint on 0x" << hex(cpu.debugger.watchHit(), 3);
+        break;
+    case DebugStop::Step:
+        out << "Stepped";
+        break;
+    case DebugStop::Fault:
+        out << describeFault(trapped) << ", paused";
+        break;
+    default:
+        out << "Paused";
+        break;
+    }
+    out << " at 0x" << hex(cpu.state.pc, 3) << "\n";
+    printInstructions(cpu.state.pc, 1);
+    out << std::flush;
+}
+
+void DebugConsole::printRegisters() {
+    for (int reg = 0; reg < 16; reg++) {
+        out << "V" << hex(reg, 1) << "=" << hex(cpu.state.v[reg], 2) << (reg % 8 == 7 ? "\n" : "  ");
+    }
+    out << "I=" << hex(cpu.state.i, 3) << "  PC=" << hex(cpu.state.pc, 3) << "  SP=" << cpu.state.sp
+        << "  DT=" << int(cpu.state.delayTimer) << "  ST=" << int(cpu.state.soundTimer) << "\n";
+}
+
+void DebugConsole::printMemory(int address, int length) {
+    const uint8_t* memory = cpu.memory();
+    for (int n = 0; n < length && address + n < cpu.memorySize(); n++) {
+        if (n % DUMP_BYTES_PER_LINE == 0) {
+            out << (n == 0 ? "" : "\n") << "0x" << hex(address + n, 3) << " ";
+        }
+        out << " " << hex(memory[address + n], 2);
+    }
+    out << "\n";
+}
+
+void DebugConsole::printInstructions(int address, int count) {
+    const uint8_t* memory = cpu.memory();
+    for (int n = 0; n < count && address + 1 < cpu.memorySize(); n++) {
+        uint16_t opcode = uint16_t(memory[address] << 8 | memory[address + 1]);
+        // Only F000 uses the next word, which the last instruction in memory doesn't have
+        uint16_t next = address + 3 < cpu.memorySize() ? uint16_t(memory[address + 2] << 8 | memory[address + 3]) : 0;
+        out << (address == cpu.state.pc ? "=> " : "   ") << (cpu.debugger.hasBreakpoint(uint16_t(address)) ? "*" : " ")
+            << "0x" << hex(address, 3) << "  " << hex(opcode, 4) << "  " << formatInstruction(opcode, next) << "\n";
+        address += decodeOpcode(opcode).length;
+    }
+}
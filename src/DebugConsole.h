@@ -0,0 +1,39 @@
+#ifndef CHIP8_DEBUGCONSOLE_H
+#define CHIP8_DEBUGCONSOLE_H
+
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "Chip8.h"
+
+// Terminal UI for Chip8::debugger. A reader thread collects command lines from the input stream, poll() runs them
+// on the emulation thread, so the emulator never waits for the terminal.
+class DebugConsole {
+public:
+    DebugConsole(Chip8& cpu, std::istream& in, std::ostream& out);
+    void start(); // prints the help and starts reading commands
+    // Runs queued commands and reports a stop if the debugger paused since the last call
+    void poll();
+    // Reports a fault that halted the machine, the state stays around to inspect
+    void halted(const FaultRecord& fault);
+    // A Chip8::trapHandler that pauses on the faulting instruction, which the next poll() reports
+    FaultPolicy trap(const FaultRecord& fault);
+    bool execute(const std::string& line); // returns false for unknown commands
+
+private:
+    void report();
+    void printRegisters();
+    void printMemory(int address, int length);
+    void printInstructions(int address, int count);
+    Chip8& cpu;
+    std::istream& in;
+    std::ostream& out;
+    std::mutex queueMutex;
+    std::deque<std::string> queue;
+    bool wasPaused = false;
+    FaultRecord trapped; // the fault of the last DebugStop::Fault
+};
+
+#endif //CHIP8_DEBUGCONSOLE_H
@@ -0,0 +1,102 @@
+#include "Debugger.h"
+
+void Debugger::setBreakpoint(uint16_t address, bool set) {
+    if (breakpoints[address] != set) {
+        breakpoints[address] = set;
+        breakpointCount += set ? 1 : -1;
+    }
+}
+
+void Debugger::setWatchpoint(uint16_t address, int length, bool set) {
+    for (int n = 0; n < length && address + n < DEBUGGER_ADDRESSES; n++) {
+        if (watchpoints[address + n] != set) {
+            watchpoints[address + n] = set;
+            watchpointCount += set ? 1 : -1;
+        }
+    }
+}
+
+bool Debugger::watches(int address, int length, int addressMask) const {
+    for (int n = 0; n < length; n++) {
+        if (watchpoints[size_t((address + n) & addressMask)]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Debugger::clear() {
+    breakpoints.reset();
+    watchpoints.reset();
+    breakpointCount = 0;
+    watchpointCount = 0;
+}
+
+void Debugger::pause() {
+    paused = true;
+    stepping = false;
+    framesLeft = 0;
+    stopReason = DebugStop::Paused;
+}
+
+void Debugger::trap() {
+    stop(DebugStop::Fault);
+}
+
+void Debugger::resume(uint16_t pc) {
+    paused = false;
+    stepping = false;
+    framesLeft = 0;
+    resumeFrom = pc;
+}
+
+void Debugger::step(uint16_t pc, int instructions) {
+    resume(pc);
+    stepping = true;
+    stepsLeft = instructions;
+}
+
+void Debugger::runFrames(uint16_t pc, int frames) {
+    resume(pc);
+    framesLeft = frames;
+}
+
+void Debugger::endFrame() {
+    if (framesLeft > 0 && --framesLeft == 0) {
+        pause();
+    }
+}
+
+DebugStop Debugger::check(uint16_t pc, int storeAddress, int storeLength, int addressMask) {
+    if (paused) {
+        return DebugStop::Paused;
+    }
+    if (resumeFrom != pc) {
+        if (breakpoints[pc]) {
+            return stop(DebugStop::Breakpoint);
+        }
+        if (storeLength > 0 && watches(storeAddress, storeLength, addressMask)) {
+            for (int n = 0; n < storeLength; n++) {
+                if (watchpoints[size_t((storeAddress + n) & addressMask)]) {
+                    watchAddress = uint16_t((storeAddress + n) & addressMask);
+                    break;
+                }
+            }
+            return stop(DebugStop::Watchpoint);
+        }
+    }
+    resumeFrom = -1;
+    if (stepping) {
+        if (stepsLeft == 0) {
+            return stop(DebugStop::Step);
+        }
+        stepsLeft--;
+    }
+    return DebugStop::None;
+}
+
+DebugStop Debugger::stop(DebugStop reason) {
+    pause();
+    stopReason = reason;
+    return reason;
+}
@@ -0,0 +1,62 @@
+#ifndef CHIP8_DEBUGGER_H
+#define CHIP8_DEBUGGER_H
+
+#include <bitset>
+#include <cstdint>
+
+constexpr int DEBUGGER_ADDRESSES = 0x10000; // XO-CHIP's address space, CHIP-8 only ever uses the first 4096
+
+// Why the checked loop in Chip8::run() stopped
+enum class DebugStop : uint8_t {
+    None,
+    Paused, // was already paused, nothing ran
+    Breakpoint, // PC reached a breakpoint
+    Watchpoint, // an FX33, FX55 or 5XY2 was about to write to a watched address
+    Step, // finished a step()
+    Fault, // an instruction faulted and the trap handler paused on it
+};
+
+// Breakpoints, watchpoints and stepping for Chip8::run(). While active() is false, run() uses the same loop as
+// without a debugger, so a debugger with nothing set costs one check per run() call rather than per instruction.
+// Stops happen before the instruction executes, with PC on it.
+class Debugger {
+public:
+    void setBreakpoint(uint16_t address, bool set = true);
+    bool hasBreakpoint(uint16_t address) const {return breakpoints[address];}
+    void setWatchpoint(uint16_t address, int length = 1, bool set = true);
+    // Stores wrap around memory, so addressMask is the size of the machine's memory minus one
+    bool watches(int address, int length, int addressMask = DEBUGGER_ADDRESSES - 1) const;
+    bool watching() const {return watchpointCount > 0;}
+    void clear(); // removes all breakpoints and watchpoints
+
+    void pause();
+    void trap(); // pauses on a faulting instruction, for FaultPolicy::Pause
+    void resume(uint16_t pc); // carries on, ignoring a breakpoint or watchpoint on the instruction at pc
+    void step(uint16_t pc, int instructions); // runs instructions from pc, then pauses
+    void runFrames(uint16_t pc, int frames); // runs until endFrame() has been called frames times, then pauses
+    void endFrame(); // the frontend calls this after each timer tick
+    bool isPaused() const {return paused;}
+    DebugStop lastStop() const {return stopReason;}
+    uint16_t watchHit() const {return watchAddress;} // the first watched address of the last Watchpoint stop
+
+    bool active() const {return paused || stepping || breakpointCount > 0 || watchpointCount > 0;}
+    // Called before each instruction by the checked loop. storeLength is 0 unless the instruction writes
+    // storeLength bytes from storeAddress, wrapping at addressMask like the machine's memory.
+    DebugStop check(uint16_t pc, int storeAddress, int storeLength, int addressMask);
+
+private:
+    DebugStop stop(DebugStop reason);
+    std::bitset<DEBUGGER_ADDRESSES> breakpoints;
+    std::bitset<DEBUGGER_ADDRESSES> watchpoints;
+    int breakpointCount = 0;
+    int watchpointCount = 0;
+    bool paused = false;
+    bool stepping = false;
+    int stepsLeft = 0;
+    int framesLeft = 0;
+    int resumeFrom = -1; // PC whose breakpoint or watchpoint was just reported, -1 if none
+    DebugStop stopReason = DebugStop::None;
+    uint16_t watchAddress = 0;
+};
+
+#endif //CHIP8_DEBUGGER_H
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "Disassembly.h"
+
+constexpr int DATA_BYTES_PER_LINE = 8;
+constexpr int LISTING_PADDING = 4; // so opcodeAt() can read F000's second word at the end of the program
+
+namespace {
+
+std::string hex(int value, int width) {
+    std::stringstream text;
+    text << std::hex << std::uppercase << std::setw(width) << std::setfill('0') << value;
+    return text.str();
+}
+
+} // namespace
+
+Disassembly::Disassembly(const uint8_t* memory, int size, uint16_t entry) :
+        bytes(memory, memory + size), kinds(size, ByteKind::Unknown), labels(size, 0), programSize(size) {
+    bytes.resize(size + LISTING_PADDING, 0);
+    trace(entry);
+    markData();
+    buildBlocks();
+}
+
+void Disassembly::trace(uint16_t entry) {
+    std::vector<uint16_t> pending;
+    auto branchTo = [&](int address, uint8_t label) {
+        if (inProgram(address)) {
+            labels[address] |= label | LEADER;
+            pending.push_back(uint16_t(address));
+        }
+    };
+    branchTo(entry, JUMP_TARGET);
+    while (!pending.empty()) {
+        uint16_t address = pending.back();
+        pending.pop_back();
+        // Walk straight-line code until it ends or joins code that's already been traced
+        while (inProgram(address) && kinds[address] == ByteKind::Unknown) {
+            uint16_t opcode = opcodeAt(address);
+            const OpcodeInfo& info = decodeOpcode(opcode);
+            if (info.flow == Flow::Invalid || !inProgram(address, info.length)) {
+                break;
+            }
+            kinds[address] = ByteKind::Code;
+            std::fill(kinds.begin() + address + 1, kinds.begin() + address + info.length, ByteKind::Operand);
+            if ((opcode & 0xF000) == 0xA000 && inProgram(opcode & 0xFFF, 1)) {
+                labels[opcode & 0xFFF] |= DATA_REFERENCE;
+            } else if (info.length == 4 && inProgram(opcodeAt(address + 2), 1)) {
+                labels[opcodeAt(address + 2)] |= DATA_REFERENCE;
+            }
+            int next = address + info.length;
+            switch (info.flow) {
+            case Flow::Jump:
+                branchTo(opcode & 0xFFF, JUMP_TARGET);
+                next = -1;
+                break;
+            case Flow::Call:
+                branchTo(opcode & 0xFFF, CALL_TARGET);
+                branchTo(next, 0);
+                break;
+            case Flow::Skip:
+                branchTo(next, 0);
+                if (inProgram(next)) {
+                    branchTo(next + decodeOpcode(opcodeAt(uint16_t(next))).length, 0);
+                }
+                break;
+            case Flow::IndirectJump: // at least NNN itself, the rest of the table can't be known
+                branchTo(opcode & 0xFFF, JUMP_TARGET);
+                next = -1;
+                break;
+            case Flow::Return:
+            case Flow::Exit:
+                next = -1;
+                break;
+            default:
+                break;
+            }
+            if (next < 0) {
+                break;
+            }
+            address = uint16_t(next);
+        }
+    }
+}
+
+void Disassembly::markData() {
+    bool inData = false;
+    for (int address = 0; address < programSize; address++) {
+        if (kinds[address] != ByteKind::Unknown) {
+            inData = false;
+        } else {
+            inData = inData || (labels[address] & DATA_REFERENCE) != 0;
+            if (inData) {
+                kinds[address] = ByteKind::Data;
+            }
+        }
+    }
+}
+
+void Disassembly::buildBlocks() {
+    for (int address = 0; address < programSize; address++) {
+        if (kinds[address] != ByteKind::Code || (labels[address] & LEADER) == 0) {
+            continue;
+        }
+        BasicBlock block {uint16_t(address), 0, {}, 0, false, false};
+        int pc = address;
+        while (true) {
+            uint16_t opcode = opcodeAt(uint16_t(pc));
+            const OpcodeInfo& info = decodeOpcode(opcode);
+            int next = pc + info.length;
+            if (info.flow == Flow::Next) {
+                if (inProgram(next) && kinds[next] == ByteKind::Code && (labels[next] & LEADER) == 0) {
+                    pc = next;
+                    continue;
+                }
+                if (inProgram(next) && kinds[next] == ByteKind::Code) {
+                    block.successors.push_back(uint16_t(next));
+                }
+            } else if (info.flow == Flow::Jump || info.flow == Flow::IndirectJump) {
+                block.successors.push_back(opcode & 0xFFF);
+                block.endsWithIndirectJump = info.flow == Flow::IndirectJump;
+            } else if (info.flow == Flow::Call) {
+                block.successors.push_back(uint16_t(next));
+                block.call = opcode & 0xFFF;
+                block.endsWithCall = true;
+            } else if (info.flow == Flow::Skip) {
+                block.successors.push_back(uint16_t(next));
+                if (inProgram(next)) {
+                    block.successors.push_back(uint16_t(next + decodeOpcode(opcodeAt(uint16_t(next))).length));
+                }
+            }
+            block.end = uint16_t(next);
+            break;
+        }
+        if (block.endsWithCall && (callTargets.empty() || callTargets.back() != block.call)) {
+            callTargets.push_back(block.call);
+        }
+        basicBlocks.push_back(block);
+    }
+    std::sort(callTargets.begin(), callTargets.end());
+    callTargets.erase(std::unique(callTargets.begin(), callTargets.end()), callTargets.end());
+}
+
+int Disassembly::bytesOf(ByteKind byteKind) const {
+    return int(std::count(kinds.begin(), kinds.end(), byteKind));
+}
+
+std::string Disassembly::instructionText(uint16_t address) const {
+    return formatInstruction(opcodeAt(address), opcodeAt(uint16_t(address + 2)));
+}
+
+std::string Disassembly::labelName(uint16_t address) const {
+    if (address < programSize && (labels[address] & CALL_TARGET)) {
+        return "sub_" + hex(address, 3);
+    } else if (address < programSize && kinds[address] != ByteKind::Code && (labels[address] & DATA_REFERENCE)) {
+        return "data_" + hex(address, 3);
+    }
+    return "loc_" + hex(address, 3);
+}
+
+void Disassembly::writeListing(std::ostream& out) const {
+    int address = PROGRAM_OFFSET < programSize ? PROGRAM_OFFSET : 0;
+    while (address < programSize) {
+        uint8_t label = labels[address];
+        if ((label & (JUMP_TARGET | CALL_TARGET)) || ((label & DATA_REFERENCE) && kinds[address] != ByteKind::Code)) {
+            out << labelName(uint16_t(address)) << ":\n";
+        }
+        out << "    0x" << hex(address, 3) << "  ";
+        if (kinds[address] == ByteKind::Code) {
+            int length = decodeOpcode(opcodeAt(uint16_t(address))).length;
+            out << hex(opcodeAt(uint16_t(address)), 4)
+                << (length == 4 ? hex(opcodeAt(uint16_t(address + 2)), 4) : "    ") << "  " << instructionText(uint16_t(address)) << "\n";
+            address += length;
+            continue;
+        }
+        // Data and unknown bytes, stopping at the next label or change of kind
+        ByteKind run = kinds[address];
+        std::string values;
+        int count = 0;
+        do {
+            values += (count == 0 ? "DB 0x" : ", 0x") + hex(bytes[address], 2);
+            address++;
+            count++;
+        } while (count < DATA_BYTES_PER_LINE && address < programSize && kinds[address] == run && labels[address] == 0);
+        out << (run == ByteKind::Data ? "          " : "    ??    ") << values << "\n";
+    }
+}
+
+void Disassembly::writeGraphviz(std::ostream& out, const std::string& name) const {
+    out << "digraph \"" << name << "\" {\n";
+    out << "    node [shape=box fontname=monospace];\n";
+    for (const BasicBlock& block : basicBlocks) {
+        out << "    \"" << hex(block.start, 3) << "\" [label=\"" << labelName(block.start) << ":\\l";
+        for (int address = block.start; address < block.end;
+             address += decodeOpcode(opcodeAt(uint16_t(address))).length) {
+            out << hex(address, 3) << "  " << instructionText(uint16_t(address)) << "\\l";
+        }
+        out << "\"];\n";
+    }
+    for (const BasicBlock& block : basicBlocks) {
+        for (uint16_t successor : block.successors) {
+            out << "    \"" << hex(block.start, 3) << "\" -> \"" << hex(successor, 3) << "\"";
+            out << (block.endsWithIndirectJump ? " [style=dotted label=\"+V0\"]" : "") << ";\n";
+        }
+        if (block.endsWithCall) {
+            out << "    \"" << hex(block.start, 3) << "\" -> \"" << hex(block.call, 3) << "\" [style=dashed];\n";
+        }
+    }
+    out << "}\n";
+}
@@ -0,0 +1,72 @@
+#ifndef CHIP8_DISASSEMBLY_H
+#define CHIP8_DISASSEMBLY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+#include "Opcodes.h"
+
+// What each byte of the program turned out to be
+enum class ByteKind : uint8_t {
+    Unknown, // never reached and never pointed to by I
+    Code, // first byte of an instruction
+    Operand, // the rest of an instruction
+    Data, // from an address loaded into I up to the next code
+};
+
+// A straight run of instructions entered only at start
+struct BasicBlock {
+    uint16_t start;
+    uint16_t end; // one past the last instruction
+    std::vector<uint16_t> successors; // fall through, jump and skip targets
+    uint16_t call; // 2NNN target if the block ends with a call, which also falls through to the return address
+    bool endsWithCall;
+    bool endsWithIndirectJump; // BNNN, successors only holds NNN itself
+};
+
+// Recursive-descent disassembly of a program in memory: follows jumps, calls and both sides of skips from the entry
+// point, marks everything else as data or unknown and splits the code into basic blocks. Memory is only read
+// during construction.
+class Disassembly {
+public:
+    // size is where the program ends, memory must hold at least that many bytes
+    Disassembly(const uint8_t* memory, int size, uint16_t entry = PROGRAM_OFFSET);
+
+    uint16_t opcodeAt(uint16_t address) const {return uint16_t(bytes[address] << 8 | bytes[address + 1]);}
+    ByteKind kind(uint16_t address) const {return kinds[address];}
+    const std::vector<BasicBlock>& blocks() const {return basicBlocks;}
+    const std::vector<uint16_t>& subroutines() const {return callTargets;} // sorted 2NNN targets
+    int size() const {return programSize;}
+    int bytesOf(ByteKind byteKind) const;
+
+    // One line per instruction and up to 8 bytes of data per line, with labels at block starts
+    void writeListing(std::ostream& out) const;
+    // The control-flow graph, one node per basic block, calls dashed and indirect jumps dotted
+    void writeGraphviz(std::ostream& out, const std::string& name) const;
+
+private:
+    enum Label : uint8_t {
+        LEADER = 1, // starts a basic block
+        JUMP_TARGET = 2,
+        CALL_TARGET = 4,
+        DATA_REFERENCE = 8, // loaded into I
+    };
+    void trace(uint16_t entry);
+    bool inProgram(int address, int length = OPCODE_SIZE) const {
+        return address >= 0 && address + length <= programSize;
+    }
+    void markData();
+    void buildBlocks();
+    std::string instructionText(uint16_t address) const;
+    std::string labelName(uint16_t address) const;
+    std::vector<uint8_t> bytes; // copy of the program, padded so the last opcode can be read whole
+    std::vector<ByteKind> kinds;
+    std::vector<uint8_t> labels;
+    std::vector<BasicBlock> basicBlocks;
+    std::vector<uint16_t> callTargets;
+    int programSize;
+};
+
+#endif //CHIP8_DISASSEMBLY_H
@@ -1,22 +1,44 @@
 #include <iostream>
 #include "Display.h"
+#include "Tracer.h"
 
 Display::Display() : window(sf::VideoMode(DISPLAY_WIDTH * DISPLAY_SCALE, DISPLAY_HEIGHT * DISPLAY_SCALE), WIN_TITLE) {
-    dispImage.create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
-    dispTexture.create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    dispTexture.create(HIRES_WIDTH, HIRES_HEIGHT);
     dispSprite.setTexture(dispTexture);
-    dispSprite.setScale(DISPLAY_SCALE, DISPLAY_SCALE);
 }
 
-void Display::draw(vram_t& vram) {
-    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-        for (int x = 0; x < DISPLAY_WIDTH; x++) {
-            sf::Color color = vram[y][x] == 0 ? sf::Color::Black : sf::Color::White;
-            dispImage.setPixel(x, y, color);
+void Display::setPersistence(int frames) {
+    decay = persistenceDecay(frames);
+    shownWidth = 0;
+}
+
+void Display::draw(const vram_t& vram, const vram_t* plane2, int width, int height) {
+    TRACE_SCOPE("draw", "display");
+    {
+        TRACE_SCOPE("convert", "display");
+        vramToPixels(vram, plane2, pixels, width, height, palette);
+    }
+    const pixels_t* upload = &pixels;
+    if (decay != 0) {
+        TRACE_SCOPE("persistence", "display");
+        if (shownWidth != width) { // nothing to fade from after a change of resolution
+            shown = pixels;
+            shownWidth = width;
+        } else {
+            decayPixels(pixels, shown, width, height, decay, palette);
         }
+        upload = &shown;
+    }
+    {
+        TRACE_SCOPE("upload", "display");
+        dispTexture.update(upload->data(), width, height, 0, 0);
     }
-    dispTexture.loadFromImage(dispImage);
-    window.clear(sf::Color(255, 0, 0, 255));
+    // Both resolutions fill the window
+    float scale = float(DISPLAY_SCALE * DISPLAY_WIDTH) / float(width);
+    dispSprite.setTextureRect(sf::IntRect(0, 0, width, height));
+    dispSprite.setScale(scale, scale);
+    TRACE_SCOPE("present", "display");
+    window.clear(sf::Color(palette[0][0], palette[0][1], palette[0][2]));
     window.draw(dispSprite);
     window.display();
 }
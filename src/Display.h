@@ -3,21 +3,26 @@
 
 #include <cstdint>
 #include <SFML/Graphics.hpp>
+#include "Chip8.h"
+#include "Framebuffer.h"
 
-constexpr int DISPLAY_WIDTH = 64;
-constexpr int DISPLAY_HEIGHT = 32;
 constexpr int DISPLAY_SCALE = 4;
 const std::string WIN_TITLE = "Chip-8";
 
-using vram_t = std::array<std::array<uint8_t, DISPLAY_WIDTH>, DISPLAY_HEIGHT>;
-
 class Display {
 public:
     Display();
-    void draw(vram_t& vram);
+    // width and height of the current resolution, plane2 is XO-CHIP's second plane if there is one
+    void draw(const vram_t& vram, const vram_t* plane2, int width, int height);
+    void setPalette(const Palette& colors) {palette = colors;}
+    void setPersistence(int frames); // how long pixels take to fade, 0 to turn them off at once
     sf::RenderWindow window;
 private:
-    sf::Image dispImage;
+    pixels_t pixels;
+    Palette palette = GREY_PALETTE;
+    int decay = 0; // see persistenceDecay()
+    pixels_t shown; // the pixels faded over the last frames, with persistence
+    int shownWidth = 0; // the resolution they were faded at, 0 to start again
     sf::Texture dispTexture;
     sf::Sprite dispSprite;
 };
@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <cstring>
+#include "Environment.h"
+
+namespace {
+
+// splitmix64, so that neighbouring environments and episodes get unrelated seeds
+uint32_t episodeSeed(uint64_t seed, uint32_t episode) {
+    uint64_t value = seed + 0x9E3779B97F4A7C15 * (uint64_t(episode) + 1);
+    value = (value ^ value >> 30) * 0xBF58476D1CE4E5B9;
+    value = (value ^ value >> 27) * 0x94D049BB133111EB;
+    return uint32_t(value ^ value >> 31);
+}
+
+int64_t probeValue(Chip8& cpu, const RewardProbe& probe) {
+    const uint8_t* bytes = cpu.memory() + probe.address;
+    int64_t value = 0;
+    for (int n = 0; n < probe.bytes; n++) {
+        value = value * (probe.encoding == ProbeEncoding::Digits ? 10 : 256) + bytes[n];
+    }
+    return value;
+}
+
+// ORs each run of Across pixels of source into a pixel of row, a compile time Across letting the loop vectorize
+template <int Across>
+void poolRow(const uint8_t* source, uint8_t* row, int width) {
+    for (int x = 0; x < width; x++) {
+        uint8_t value = 0;
+        for (int k = 0; k < Across; k++) {
+            value |= source[x * Across + k];
+        }
+        row[x] = value;
+    }
+}
+
+} // namespace
+
+std::string checkOptions(const EnvironmentOptions& options) {
+    if (options.frameSkip < 1) {
+        return "the frame skip has to be at least 1";
+    }
+    if (options.downsample != 1 && options.downsample != 2 && options.downsample != 4 && options.downsample != 8) {
+        return "the downsampling has to be 1, 2, 4 or 8";
+    }
+    int memorySize = options.profile == QuirkProfile::XoChip ? XO_MEMORY_SIZE : MEMORY_SIZE;
+    for (const RewardProbe& probe : options.rewards) {
+        if (probe.bytes < 1 || probe.bytes > 4) {
+            return "reward probes read 1 to 4 bytes";
+        }
+        if (probe.address < 0 || probe.address + probe.bytes > memorySize) {
+            return "reward probe at " + std::to_string(probe.address) + " is outside memory";
+        }
+    }
+    return "";
+}
+
+VectorEnvironment::VectorEnvironment(std::vector<uint8_t> rom, int count, const EnvironmentOptions& options) :
+    rom(std::move(rom)), options(options), pool(options.threads) {
+    bool superChip = options.profile == QuirkProfile::SuperChip || options.profile == QuirkProfile::XoChip;
+    width = superChip ? HIRES_WIDTH : DISPLAY_WIDTH;
+    height = superChip ? HIRES_HEIGHT : DISPLAY_HEIGHT;
+    rewardVariable = options.probes.find("reward");
+    scoreVariable = options.probes.find("score");
+    doneVariable = options.probes.find("done");
+    instances.resize(size_t(std::max(count, 0)));
+    for (Instance& instance : instances) {
+        instance.cpu = std::make_unique<Chip8>();
+        instance.cpu->quirkProfile = options.profile;
+    }
+}
+
+void VectorEnvironment::reset(uint64_t seed, uint8_t* observations) {
+    pool.run(size(), [this, seed, observations](int begin, int end) {
+        for (int n = begin; n < end; n++) {
+            Instance& instance = instances[size_t(n)];
+            instance.seed = episodeSeed(seed, uint32_t(n));
+            instance.episode = 0;
+            restart(instance);
+            observe(*instance.cpu, observations + size_t(n) * size_t(observationSize()), false);
+        }
+    });
+}
+
+void VectorEnvironment::step(const int32_t* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+    pool.run(size(), [this, actions, observations, rewards, dones](int begin, int end) {
+        for (int n = begin; n < end; n++) {
+            Instance& instance = instances[size_t(n)];
+            if (instance.ended) {
+                instance.episode++;
+                restart(instance);
+            }
+            int32_t key = actions[n] >= 0 && actions[n] < NUMBER_OF_KEYS ? actions[n] : NO_ACTION;
+            uint8_t* observation = observations + size_t(n) * size_t(observationSize());
+            bool pooled = false;
+            float reward = 0;
+            uint8_t ending = EPISODE_RUNNING;
+            for (int frame = 0; frame < options.frameSkip && ending == EPISODE_RUNNING; frame++) {
+                if (options.maxOverFrames && frame == options.frameSkip - 1) {
+                    // The screen before the last frame, which the last one's is ORed into
+                    observe(*instance.cpu, observation, false);
+                    pooled = true;
+                }
+                ending = runFrame(instance, key, reward);
+            }
+            instance.ended = ending != EPISODE_RUNNING;
+            dones[n] = ending;
+            observe(*instance.cpu, observation, pooled);
+            reward += collectReward(instance);
+            if (rewards != nullptr) {
+                rewards[n] = reward;
+            }
+        }
+    });
+}
+
+bool VectorEnvironment::probeValues(const std::string& name, int64_t* values) const {
+    int variable = options.probes.find(name);
+    if (variable == -1) {
+        return false;
+    }
+    for (size_t n = 0; n < instances.size(); n++) {
+        values[n] = instances[n].variables.empty() ? 0 : instances[n].variables[size_t(variable)];
+    }
+    return true;
+}
+
+uint8_t VectorEnvironment::runFrame(Instance& instance, int32_t key, float& reward) {
+    Chip8& cpu = *instance.cpu;
+    for (int k = 0; k < NUMBER_OF_KEYS; k++) {
+        cpu.state.input[k] = k == key;
+    }
+    if (key != NO_ACTION && cpu.state.acceptingInputInto != -1) {
+        cpu.keyInput(uint8_t(key));
+    }
+    cpu.run(options.instructionsPerFrame);
+    cpu.tickTimers();
+    instance.frames++;
+    bool done = false;
+    if (!options.probes.empty()) {
+        options.probes.evaluate(cpu, instance.variables.data());
+        if (rewardVariable != -1) {
+            reward += float(instance.variables[size_t(rewardVariable)]);
+        }
+        done = doneVariable != -1 && instance.variables[size_t(doneVariable)] != 0;
+    }
+    if (done || (!cpu.state.running && cpu.state.acceptingInputInto == -1)) {
+        return EPISODE_TERMINATED;
+    }
+    if (options.maxEpisodeFrames > 0 && instance.frames >= options.maxEpisodeFrames) {
+        return EPISODE_TRUNCATED;
+    }
+    return EPISODE_RUNNING;
+}
+
+float VectorEnvironment::collectReward(Instance& instance) {
+    float reward = 0;
+    for (size_t p = 0; p < options.rewards.size(); p++) {
+        int64_t value = probeValue(*instance.cpu, options.rewards[p]);
+        reward += options.rewards[p].scale * float(value - instance.rewardValues[p]);
+        instance.rewardValues[p] = value;
+    }
+    if (scoreVariable != -1) {
+        int64_t score = instance.variables[size_t(scoreVariable)];
+        reward += float(score - instance.score);
+        instance.score = score;
+    }
+    return reward;
+}
+
+void VectorEnvironment::restart(Instance& instance) {
+    instance.cpu->load(rom.data(), rom.size());
+    instance.cpu->seedRandom(episodeSeed(instance.seed, instance.episode));
+    instance.frames = 0;
+    instance.ended = false;
+    instance.rewardValues.resize(options.rewards.size());
+    for (size_t p = 0; p < options.rewards.size(); p++) {
+        instance.rewardValues[p] = probeValue(*instance.cpu, options.rewards[p]);
+    }
+    // The score's starting value, what the program does otherwise only counts once frames run
+    instance.variables.assign(size_t(options.probes.variables()), 0);
+    if (!options.probes.empty()) {
+        options.probes.evaluate(*instance.cpu, instance.variables.data());
+    }
+    instance.score = scoreVariable != -1 ? instance.variables[size_t(scoreVariable)] : 0;
+}
+
+int VectorEnvironment::observationSize() const {
+    int pixels = observationWidth() * observationHeight();
+    return options.format == ObservationFormat::Packed ? pixels / 8 : pixels;
+}
+
+void VectorEnvironment::observe(const Chip8& cpu, uint8_t* observation, bool accumulate) const {
+    const vram_t& plane1 = cpu.state.vram;
+    const vram_t* plane2 = cpu.secondPlane();
+    // Low resolution screens are scaled up to fill a high resolution observation
+    const int scale = width / cpu.state.screenWidth();
+    const int factor = options.downsample;
+    if (options.format == ObservationFormat::Pixels && factor == 1 && !accumulate) {
+        for (int y = 0; y < height; y++) {
+            const auto& row1 = plane1[y / scale];
+            uint8_t* out = observation + y * width;
+            if (plane2 == nullptr && scale == 1) {
+                std::memcpy(out, row1.data(), size_t(width));
+            } else if (plane2 == nullptr) {
+                for (int x = 0; x < width; x++) {
+                    out[x] = row1[x / scale];
+                }
+            } else {
+                const auto& row2 = (*plane2)[y / scale];
+                for (int x = 0; x < width; x++) {
+                    out[x] = uint8_t(row1[x / scale] | row2[x / scale] << 1);
+                }
+            }
+        }
+        return;
+    }
+    // Otherwise the screen rows under each observation row are ORed together into line, at the screen's resolution,
+    // then pooled across into row, and stored, packed or ORed in
+    const int screenWidth = cpu.state.screenWidth();
+    const int outWidth = observationWidth();
+    const int across = factor / scale; // screen pixels per observation pixel, 0 if they're doubled instead
+    uint8_t line[HIRES_WIDTH];
+    uint8_t row[HIRES_WIDTH];
+    for (int outY = 0; outY < observationHeight(); outY++) {
+        const int first = outY * factor / scale;
+        const int last = ((outY + 1) * factor - 1) / scale;
+        const uint8_t* source = line;
+        if (first == last && plane2 == nullptr) {
+            source = plane1[first].data();
+        } else {
+            std::fill(line, line + screenWidth, uint8_t(0));
+            for (int y = first; y <= last; y++) {
+                const auto& row1 = plane1[y];
+                for (int x = 0; x < screenWidth; x++) {
+                    line[x] |= row1[x];
+                }
+                if (plane2 != nullptr) {
+                    const auto& row2 = (*plane2)[y];
+                    for (int x = 0; x < screenWidth; x++) {
+                        line[x] |= uint8_t(row2[x] << 1);
+                    }
+                }
+            }
+        }
+        const uint8_t* pooled = row;
+        if (across == 1) {
+            pooled = source;
+        } else if (across == 0) {
+            for (int x = 0; x < outWidth; x++) {
+                row[x] = source[x / 2];
+            }
+        } else if (across == 2) {
+            poolRow<2>(source, row, outWidth);
+        } else if (across == 4) {
+            poolRow<4>(source, row, outWidth);
+        } else {
+            poolRow<8>(source, row, outWidth);
+        }
+        if (options.format == ObservationFormat::Pixels) {
+            uint8_t* out = observation + outY * outWidth;
+            if (accumulate) {
+                // A word at a time, since the compiler can't tell out and pooled apart to vectorize
+                for (int x = 0; x < outWidth; x += 8) {
+                    uint64_t previous;
+                    uint64_t current;
+                    std::memcpy(&previous, out + x, sizeof(previous));
+                    std::memcpy(&current, pooled + x, sizeof(current));
+                    previous |= current;
+                    std::memcpy(out + x, &previous, sizeof(previous));
+                }
+            } else {
+                std::memcpy(out, pooled, size_t(outWidth));
+            }
+        } else {
+            uint8_t* out = observation + outY * outWidth / 8;
+            for (int x = 0; x < outWidth; x += 8) {
+                // Eight pixels a word, the first in the low byte, each folded to 0 or 1, and the multiplication
+                // gathers their bits into the top byte, the first pixel highest
+                uint64_t word;
+                std::memcpy(&word, pooled + x, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                word = __builtin_bswap64(word);
+#endif
+                word = (word | word >> 1) & 0x0101010101010101;
+                auto packed = uint8_t(word * 0x8040201008040201 >> 56);
+                out[x / 8] = accumulate ? uint8_t(out[x / 8] | packed) : packed;
+            }
+        }
+    }
+}
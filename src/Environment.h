@@ -0,0 +1,114 @@
+#ifndef CHIP8_ENVIRONMENT_H
+#define CHIP8_ENVIRONMENT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+#include "Probes.h"
+#include "ThreadPool.h"
+
+constexpr int32_t NO_ACTION = -1; // an action holding no key, the others are the key held, 0-F
+
+// Why an episode ended, as written to the dones array
+enum EpisodeEnd : uint8_t {
+    EPISODE_RUNNING = 0,
+    EPISODE_TERMINATED = 1, // the machine halted: 00FD, or a fault
+    EPISODE_TRUNCATED = 2, // it reached maxEpisodeFrames
+};
+
+enum class ObservationFormat {
+    Pixels, // a byte per pixel, bit 0 for the first plane and bit 1 for the second
+    Packed, // a bit per pixel, set if it's lit in either plane, eight to a byte with the leftmost in the high bit
+};
+
+// How a reward probe reads its value from guest memory
+enum class ProbeEncoding {
+    Binary, // an unsigned big endian number
+    Digits, // a decimal digit per byte, most significant first, like FX33 writes
+};
+
+// A number in guest memory, such as a score, whose change from one step to the next is a reward
+struct RewardProbe {
+    int address = 0;
+    int bytes = 1; // 1-4
+    ProbeEncoding encoding = ProbeEncoding::Binary;
+    float scale = 1; // the reward is scale times the change, so -1 makes lives lost negative
+};
+
+struct EnvironmentOptions {
+    QuirkProfile profile = QuirkProfile::Yachie;
+    int instructionsPerFrame = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+    int maxEpisodeFrames = 0; // 0 for no limit
+    int threads = 0; // 0 uses every core
+    int frameSkip = 1; // frames each step() runs, holding the same key
+    // Observations have one pixel per downsample x downsample block, the OR of the block's pixels: 1, 2, 4 or 8
+    int downsample = 1;
+    // Each pixel is lit if it was in either of the last two frames, which keeps sprites that flicker, being erased
+    // and redrawn in alternate frames. With a frameSkip of 1 that's the frame before the step and its own.
+    bool maxOverFrames = false;
+    ObservationFormat format = ObservationFormat::Pixels;
+    std::vector<RewardProbe> rewards; // summed into each step's reward
+    // Run after every frame. It can assign reward, added to the step's reward each frame, score, whose change over
+    // the step is, and done, which terminates the episode when it isn't 0.
+    ProbeProgram probes;
+};
+
+// Why options can't be used, or an empty string if they can, given the size of guest memory
+std::string checkOptions(const EnvironmentOptions& options);
+
+// A batch of headless machines running the same ROM, for reinforcement learning. step() runs frameSkip frames of
+// each with the key its action holds, and writes the screens and rewards straight into the caller's arrays, each
+// environment writing its own slice from one of the pool's threads. An environment whose episode ended restarts on
+// its next step(), so the observation that comes with the end of an episode is its last screen, as with Gym's
+// vector environments.
+class VectorEnvironment {
+public:
+    VectorEnvironment(std::vector<uint8_t> rom, int count, const EnvironmentOptions& options);
+
+    int size() const {return int(instances.size());}
+    // SUPER-CHIP and XO-CHIP ROMs get 128x64 screens, with low resolution pixels doubled, the others 64x32, which
+    // the observations divide by the downsampling. observationSize() is in bytes, see ObservationFormat.
+    int observationWidth() const {return width / options.downsample;}
+    int observationHeight() const {return height / options.downsample;}
+    int observationSize() const;
+
+    // Restarts every environment, seeding CXNN from seed and the environment's index. observations holds size()
+    // observations.
+    void reset(uint64_t seed, uint8_t* observations);
+    // actions holds size() actions, observations, rewards and dones size() of each. rewards may be null.
+    void step(const int32_t* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+    // Writes a variable of the probe program, as of each environment's last frame, to size() values. False if the
+    // program doesn't assign it.
+    bool probeValues(const std::string& name, int64_t* values) const;
+
+private:
+    struct Instance {
+        std::unique_ptr<Chip8> cpu;
+        uint64_t seed = 0; // the environment's own, from reset()'s
+        uint32_t episode = 0; // reseeds each new episode differently
+        int frames = 0; // in this episode
+        bool ended = true; // restarts on the next step(), which is also the first one without a reset()
+        std::vector<int64_t> rewardValues; // of each reward probe after the last step
+        std::vector<int64_t> variables; // of the probe program after the last frame
+        int64_t score = 0; // the score variable after the last step
+    };
+    void restart(Instance& instance);
+    uint8_t runFrame(Instance& instance, int32_t key, float& reward); // the EpisodeEnd
+    float collectReward(Instance& instance);
+    // Writes the observation, or ORs it into the one there with accumulate
+    void observe(const Chip8& cpu, uint8_t* observation, bool accumulate) const;
+    std::vector<uint8_t> rom;
+    EnvironmentOptions options;
+    int width;
+    int height;
+    // The probe program's outputs, -1 if it doesn't assign them
+    int rewardVariable;
+    int scoreVariable;
+    int doneVariable;
+    std::vector<Instance> instances;
+    ThreadPool pool;
+};
+
+#endif //CHIP8_ENVIRONMENT_H
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "ExecutionLog.h"
+
+namespace {
+
+void write8(std::ostream& out, uint8_t value) {
+    out.put(char(value));
+}
+
+void write16(std::ostream& out, uint16_t value) {
+    write8(out, uint8_t(value & 0xFF));
+    write8(out, uint8_t(value >> 8));
+}
+
+void write32(std::ostream& out, uint32_t value) {
+    write16(out, uint16_t(value & 0xFFFF));
+    write16(out, uint16_t(value >> 16));
+}
+
+void write64(std::ostream& out, uint64_t value) {
+    write32(out, uint32_t(value & 0xFFFFFFFF));
+    write32(out, uint32_t(value >> 32));
+}
+
+uint8_t read8(std::istream& in) {
+    return uint8_t(in.get());
+}
+
+uint16_t read16(std::istream& in) {
+    uint16_t low = read8(in);
+    return uint16_t(low | read8(in) << 8);
+}
+
+uint32_t read32(std::istream& in) {
+    uint32_t low = read16(in);
+    return low | uint32_t(read16(in)) << 16;
+}
+
+uint64_t read64(std::istream& in) {
+    uint64_t low = read32(in);
+    return low | uint64_t(read32(in)) << 32;
+}
+
+} // namespace
+
+ExecutionLog::ExecutionLog() : records(EXECUTION_LOG_SIZE) {
+    static_assert((EXECUTION_LOG_SIZE & (EXECUTION_LOG_SIZE - 1)) == 0, "EXECUTION_LOG_SIZE must be a power of two");
+    clear();
+}
+
+void ExecutionLog::clear() {
+    std::fill(records.begin(), records.end(), Record {});
+    written = 0;
+}
+
+std::vector<ExecutionLog::Record> ExecutionLog::last() const {
+    uint64_t count = std::min<uint64_t>(written, EXECUTION_LOG_SIZE);
+    std::vector<Record> result;
+    result.reserve(count);
+    for (uint64_t n = written - count; n < written; n++) {
+        result.push_back(records[n & (EXECUTION_LOG_SIZE - 1)]);
+    }
+    return result;
+}
+
+void ExecutionLog::writtenRegisters(uint16_t opcode, int& first, int& last) {
+    int x = (opcode & 0x0F00) >> 8;
+    int y = (opcode & 0x00F0) >> 4;
+    if ((opcode & 0xF0FF) == 0xF065 || (opcode & 0xF0FF) == 0xF085) {
+        first = 0;
+        last = x;
+    } else if ((opcode & 0xF00F) == 0x5003) {
+        first = std::min(x, y);
+        last = std::max(x, y);
+    } else {
+        first = x;
+        last = x;
+    }
+}
+
+bool ExecutionLog::write(const std::string& filename, const Registers& registers) {
+    std::ofstream out(filename, std::ios::out | std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Couldn't write execution log " << filename << std::endl;
+        return false;
+    }
+    complete(registers.i, registers.v); // the last instruction hasn't been completed by a fetch yet
+    std::vector<Record> log = last();
+    out.write(EXECUTION_LOG_MAGIC, sizeof(EXECUTION_LOG_MAGIC));
+    write16(out, EXECUTION_LOG_VERSION);
+    write32(out, uint32_t(log.size()));
+    write64(out, written);
+    for (uint8_t v : registers.v) {
+        write8(out, v);
+    }
+    write16(out, registers.i);
+    write16(out, registers.pc);
+    write16(out, registers.sp);
+    write8(out, registers.delayTimer);
+    write8(out, registers.soundTimer);
+    for (const Record& record : log) {
+        write16(out, record.pc);
+        write16(out, record.opcode);
+        write16(out, record.i);
+        for (uint8_t v : record.v) {
+            write8(out, v);
+        }
+    }
+    std::cerr << "Wrote the last " << log.size() << " instructions to " << filename << std::endl;
+    return bool(out);
+}
+
+bool ExecutionLog::read(const std::string& filename, Registers& registers, std::vector<Record>& records,
+                        uint64_t& executed) {
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    char magic[sizeof(EXECUTION_LOG_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), EXECUTION_LOG_MAGIC)) {
+        std::cerr << filename << " is not an execution log" << std::endl;
+        return false;
+    }
+    uint16_t version = read16(in);
+    if (version != EXECUTION_LOG_VERSION) {
+        std::cerr << filename << " has unsupported version " << version << std::endl;
+        return false;
+    }
+    uint32_t count = read32(in);
+    executed = read64(in);
+    for (uint8_t& v : registers.v) {
+        v = read8(in);
+    }
+    registers.i = read16(in);
+    registers.pc = read16(in);
+    registers.sp = read16(in);
+    registers.delayTimer = read8(in);
+    registers.soundTimer = read8(in);
+    records.clear();
+    for (uint32_t n = 0; n < count && in; n++) {
+        Record record {};
+        record.pc = read16(in);
+        record.opcode = read16(in);
+        record.i = read16(in);
+        for (uint8_t& v : record.v) {
+            v = read8(in);
+        }
+        records.push_back(record);
+    }
+    if (!in) {
+        std::cerr << filename << " is truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef CHIP8_EXECUTIONLOG_H
+#define CHIP8_EXECUTIONLOG_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// The execution log is compiled in unless YACHIE_EXECUTION_LOG is disabled (cmake -DYACHIE_EXECUTION_LOG=OFF)
+#ifdef YACHIE_EXECUTION_LOG
+#define EXECUTION_LOG(statement) statement
+#else
+#define EXECUTION_LOG(statement)
+#endif
+
+constexpr int EXECUTION_LOG_SIZE = 4096; // records kept, must be a power of two
+constexpr char EXECUTION_LOG_MAGIC[4] = {'Y', 'C', 'X', 'L'};
+constexpr uint16_t EXECUTION_LOG_VERSION = 2;
+
+// Ring buffer of the last EXECUTION_LOG_SIZE executed instructions, cheap enough to leave on so that there is
+// something to look at when a ROM faults. Each record is completed with I and V0-VF when the next instruction is
+// fetched, so that instructions writing several registers (FX65, FX85, 5XY3) are logged in full.
+class ExecutionLog {
+public:
+    struct Record {
+        uint16_t pc;
+        uint16_t opcode;
+        uint16_t i; // I after the instruction
+        uint8_t v[16]; // V0-VF after the instruction
+    };
+    // The range of V registers opcode may write, besides VF: V0-VX for FX65/FX85, VX-VY for 5XY3, otherwise VX
+    static void writtenRegisters(uint16_t opcode, int& first, int& last);
+    // Registers at the time the log was written, the last record is usually the instruction that faulted
+    struct Registers {
+        uint8_t v[16];
+        uint16_t i;
+        uint16_t pc;
+        uint16_t sp;
+        uint8_t delayTimer;
+        uint8_t soundTimer;
+    };
+
+    ExecutionLog();
+    void clear();
+    inline void record(uint16_t pc, uint16_t opcode, uint16_t i, const uint8_t* v) {
+        complete(i, v);
+        Record& next = records[written & (EXECUTION_LOG_SIZE - 1)];
+        next.pc = pc;
+        next.opcode = opcode;
+        written++;
+    }
+    std::vector<Record> last() const; // oldest first
+    uint64_t executed() const {return written;}
+    // Binary format: magic, version, record count, total executed, registers, then the records, all little endian
+    bool write(const std::string& filename, const Registers& registers);
+    static bool read(const std::string& filename, Registers& registers, std::vector<Record>& records,
+                     uint64_t& executed);
+
+private:
+    inline void complete(uint16_t i, const uint8_t* v) {
+        Record& previous = records[(written - 1) & (EXECUTION_LOG_SIZE - 1)];
+        previous.i = i;
+        std::memcpy(previous.v, v, sizeof(previous.v));
+    }
+    std::vector<Record> records;
+    uint64_t written;
+};
+
+#endif //CHIP8_EXECUTIONLOG_H
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include "Explorer.h"
+#include "ShardedHashSet.h"
+
+namespace {
+
+constexpr uint64_t HIRES_KEY = 0x9E3779B97F4A7C15; // XORed into the screen hash in high resolution mode
+
+struct Node {
+    Chip8::Snapshot snapshot;
+    std::vector<int8_t> inputs;
+    int staleness; // steps since the path last reached a new screen
+};
+
+// A forked state, kept until the end of its round
+struct Fork {
+    Node node;
+    uint64_t stateHash;
+    uint64_t screenHash;
+};
+
+// Shortest first, then lexicographically
+bool shorter(const std::vector<int8_t>& a, const std::vector<int8_t>& b) {
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+// The VRAM hashes are Zobrist hashes with different keys for each plane, so they can just be XORed together
+uint64_t screenHash(const Chip8& cpu) {
+    uint64_t hash = cpu.vramHash(0) ^ (cpu.state.hires ? HIRES_KEY : 0);
+    return cpu.xoChip ? hash ^ cpu.vramHash(1) : hash;
+}
+
+Screen capture(const Chip8& cpu, uint64_t hash, const std::vector<int8_t>& inputs) {
+    Screen screen {hash, cpu.state.screenWidth(), cpu.state.screenHeight(), {}, inputs};
+    const vram_t* plane2 = cpu.secondPlane();
+    screen.pixels.reserve(size_t(screen.width * screen.height));
+    for (int y = 0; y < screen.height; y++) {
+        for (int x = 0; x < screen.width; x++) {
+            screen.pixels.push_back(uint8_t((cpu.state.vram[y][x] != 0) | (plane2 && (*plane2)[y][x] != 0) << 1));
+        }
+    }
+    return screen;
+}
+
+// Holds key for holdFrames frames, answering FX0A with it
+void step(Chip8& cpu, int key, const ExploreOptions& options) {
+    for (int frame = 0; frame < options.holdFrames; frame++) {
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            cpu.state.input[n] = n == key;
+        }
+        if (key != NO_KEY && cpu.state.acceptingInputInto != -1) {
+            cpu.keyInput(uint8_t(key));
+        }
+        cpu.run(options.instructionsPerFrame);
+        cpu.tickTimers();
+    }
+}
+
+} // namespace
+
+ExploreResult Explorer::run(const Setup& setup) const {
+    const int threads = options.threads > 0 ? options.threads : int(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> keys = {NO_KEY};
+    for (int key = 0; key < NUMBER_OF_KEYS; key++) {
+        if ((options.keys >> key & 1) != 0) {
+            keys.push_back(key);
+        }
+    }
+    // Each worker restores the states it expands into its own machine, set up once for the profile and policies
+    std::vector<std::unique_ptr<Chip8>> machines;
+    for (int n = 0; n < threads; n++) {
+        machines.push_back(std::make_unique<Chip8>());
+        setup(*machines.back());
+    }
+
+    ExploreResult result;
+    ShardedHashSet<> seenStates;
+    ShardedHashSet<> seenScreens;
+    long long states = 1;
+    std::atomic<bool> limited {false};
+    Chip8& start = *machines[0];
+    seenStates.insert(start.stateHash());
+    seenScreens.insert(screenHash(start));
+    result.screens.push_back(capture(start, screenHash(start), {}));
+    std::map<int, std::vector<Node>> queue; // by priority, lowest first
+    queue[0].push_back({start.snapshot(), {}, 0});
+
+    while (!queue.empty() && !limited) {
+        // A round expands every state of the best priority, which is a whole depth when searching breadth-first
+        std::vector<Node> round = std::move(queue.begin()->second);
+        queue.erase(queue.begin());
+        std::atomic<size_t> next {0};
+        std::atomic<long long> forked {0};
+        std::vector<std::vector<Fork>> forks(static_cast<size_t>(threads));
+        auto expand = [&](int worker) {
+            Chip8& cpu = *machines[size_t(worker)];
+            for (size_t n = next++; n < round.size(); n = next++) {
+                const Node& node = round[n];
+                for (int key : keys) {
+                    if (states + forked >= options.maxStates) {
+                        limited = true;
+                        return;
+                    }
+                    cpu.restore(node.snapshot);
+                    step(cpu, key, options);
+                    uint64_t hash = cpu.stateHash();
+                    if (seenStates.contains(hash)) {
+                        continue;
+                    }
+                    forked++;
+                    std::vector<int8_t> inputs = node.inputs;
+                    inputs.push_back(int8_t(key));
+                    forks[size_t(worker)].push_back({{cpu.snapshot(), std::move(inputs), node.staleness + 1}, hash,
+                                                     screenHash(cpu)});
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        for (int worker = 1; worker < threads; worker++) {
+            workers.emplace_back(expand, worker);
+        }
+        expand(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const Node& node : round) {
+            result.depth = std::max(result.depth, int(node.inputs.size()) + 1);
+        }
+
+        // Forks of the same round can reach the same state or screen, the smallest inputs keep it whichever thread
+        // got there first
+        std::vector<Fork*> ordered;
+        for (auto& workerForks : forks) {
+            for (Fork& fork : workerForks) {
+                ordered.push_back(&fork);
+            }
+        }
+        std::sort(ordered.begin(), ordered.end(), [](const Fork* a, const Fork* b) {
+            return shorter(a->node.inputs, b->node.inputs);
+        });
+        for (Fork* fork : ordered) {
+            if (!seenStates.insert(fork->stateHash)) {
+                continue;
+            }
+            states++;
+            Node& node = fork->node;
+            if (seenScreens.insert(fork->screenHash)) {
+                start.restore(node.snapshot);
+                result.screens.push_back(capture(start, fork->screenHash, node.inputs));
+                node.staleness = 0;
+            }
+            if (int(node.inputs.size()) < options.maxDepth) {
+                int priority = options.bestFirst ? node.staleness : int(node.inputs.size());
+                queue[priority].push_back(std::move(node));
+            }
+        }
+    }
+
+    std::sort(result.screens.begin(), result.screens.end(), [](const Screen& a, const Screen& b) {
+        return shorter(a.inputs, b.inputs);
+    });
+    result.states = states;
+    result.exhausted = !limited;
+    return result;
+}
+
+std::string Explorer::formatInputs(const std::vector<int8_t>& inputs) {
+    static const char DIGITS[] = "0123456789ABCDEF";
+    std::string text;
+    for (int8_t key : inputs) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += key == NO_KEY ? '-' : DIGITS[key & 0xF];
+    }
+    return text;
+}
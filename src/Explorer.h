@@ -0,0 +1,58 @@
+#ifndef CHIP8_EXPLORER_H
+#define CHIP8_EXPLORER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+constexpr int NO_KEY = -1; // an input step that holds no key
+
+struct ExploreOptions {
+    int maxDepth = 12; // input steps from the start
+    long long maxStates = 20000; // distinct states to visit before giving up, each queued one takes about 20KB
+    int holdFrames = 10; // frames each input step holds its key for
+    int instructionsPerFrame = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+    uint16_t keys = 0xFFFF; // a bit per key tried at each step, besides holding none
+    bool bestFirst = false; // expand the states closest to a new screen first, rather than the shallowest
+    int threads = 0; // 0 uses every core
+};
+
+// A distinct screen and the shortest input sequence found to reach it
+struct Screen {
+    uint64_t hash;
+    int width;
+    int height;
+    std::vector<uint8_t> pixels; // width x height, bit 0 set for the first plane and bit 1 for the second
+    std::vector<int8_t> inputs; // the key held during each step, NO_KEY for none
+};
+
+struct ExploreResult {
+    std::vector<Screen> screens; // shortest input sequences first
+    long long states = 0; // distinct states visited
+    int depth = 0; // the deepest step taken
+    bool exhausted = false; // every reachable state within maxDepth was visited
+};
+
+// Searches the states a ROM can reach from the keypad. Each step forks every queued machine once per key (and once
+// for no key), runs the forks for holdFrames frames with that key held and keeps the ones whose Chip8::stateHash()
+// hasn't been seen before. Breadth-first, a round expands one depth, so every screen is reported with a shortest
+// input sequence. Best-first, it expands the states fewest steps away from the last new screen on their path. The
+// states of a round are spread over the worker threads, which share the states seen in earlier rounds in a
+// ShardedHashSet. The forks are then kept in order of their inputs, so when two reach the same state or screen the
+// lexicographically smallest inputs win and the result doesn't depend on the threads, short of hitting maxStates.
+class Explorer {
+public:
+    using Setup = std::function<void(Chip8& cpu)>; // loads the ROM and picks the profile and seed, run on each worker
+
+    explicit Explorer(ExploreOptions options) : options(options) {}
+    ExploreResult run(const Setup& setup) const;
+
+    static std::string formatInputs(const std::vector<int8_t>& inputs); // "5 5 - A", - holding no key
+
+private:
+    ExploreOptions options;
+};
+
+#endif //CHIP8_EXPLORER_H
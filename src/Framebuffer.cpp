@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "Framebuffer.h"
+
+namespace {
+
+struct PaletteName {
+    const char* name;
+    Palette palette;
+};
+
+const PaletteName PALETTE_NAMES[] = {
+    {"grey", GREY_PALETTE},
+    {"green", {{{0x00, 0x10, 0x00, 0xFF}, {0x33, 0xFF, 0x66, 0xFF}, {0x1F, 0x99, 0x40, 0xFF},
+                {0x0F, 0x4D, 0x20, 0xFF}}}},
+    {"amber", {{{0x14, 0x0A, 0x00, 0xFF}, {0xFF, 0xB0, 0x00, 0xFF}, {0xAA, 0x75, 0x00, 0xFF},
+                {0x55, 0x3A, 0x00, 0xFF}}}},
+    {"octo", {{{0x99, 0x66, 0x00, 0xFF}, {0xFF, 0xCC, 0x00, 0xFF}, {0xFF, 0x66, 0x00, 0xFF},
+               {0x66, 0x22, 0x00, 0xFF}}}}, // Octo's defaults
+    {"lcd", {{{0x9B, 0xBC, 0x0F, 0xFF}, {0x0F, 0x38, 0x0F, 0xFF}, {0x30, 0x62, 0x30, 0xFF},
+              {0x8B, 0xAC, 0x0F, 0xFF}}}},
+};
+
+constexpr double PERSISTENCE_RESIDUE = 1.0 / 16; // how much of a pixel is left after the persistence frames
+
+#ifdef __GNUC__
+// GCC and Clang turn these into SSE2 or NEON instructions, or split them up where there are none
+using Bytes = uint8_t __attribute__((vector_size(16)));
+using Lanes = uint16_t __attribute__((vector_size(16)));
+using Words = uint32_t __attribute__((vector_size(16)));
+#endif
+
+bool parseColor(const std::string& text, std::array<uint8_t, BYTES_PER_PIXEL>& color) {
+    if (text.size() != 6 || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        return false;
+    }
+    unsigned long value = std::stoul(text, nullptr, 16);
+    color = {uint8_t(value >> 16), uint8_t(value >> 8), uint8_t(value), 0xFF};
+    return true;
+}
+
+} // namespace
+
+bool parsePalette(const std::string& text, Palette& palette) {
+    for (const auto& paletteName : PALETTE_NAMES) {
+        if (text == paletteName.name) {
+            palette = paletteName.palette;
+            return true;
+        }
+    }
+    Palette parsed;
+    int colors = 0;
+    for (size_t start = 0; start <= text.size() && colors < 4; colors++) {
+        size_t end = std::min(text.find(',', start), text.size());
+        if (!parseColor(text.substr(start, end - start), parsed[size_t(colors)])) {
+            return false;
+        }
+        start = end + 1;
+    }
+    if (colors == 2) {
+        // Shaded like PLANE_LEVELS: two thirds and a third of the way from the background
+        for (int channel = 0; channel < 3; channel++) {
+            int background = parsed[0][size_t(channel)];
+            int difference = parsed[1][size_t(channel)] - background;
+            parsed[2][size_t(channel)] = uint8_t(background + difference * 2 / 3);
+            parsed[3][size_t(channel)] = uint8_t(background + difference / 3);
+        }
+        parsed[2][3] = parsed[3][3] = 0xFF;
+    } else if (colors != 4 || text.size() != 4 * 7 - 1) {
+        return false;
+    }
+    palette = parsed;
+    return true;
+}
+
+void vramToPixels(const vram_t& vram, const vram_t* plane2, pixels_t& pixels, int width, int height,
+                  const Palette& palette) {
+    uint32_t colors[4];
+    std::memcpy(colors, palette.data(), sizeof(colors));
+    uint8_t* out = pixels.data();
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row1 = vram[y].data();
+        const uint8_t* row2 = plane2 != nullptr ? (*plane2)[y].data() : nullptr;
+        for (int x = 0; x < width; x++) {
+            int planes = (row1[x] != 0) | (row2 != nullptr && row2[x] != 0) << 1;
+            std::memcpy(out, &colors[planes], BYTES_PER_PIXEL);
+            out += BYTES_PER_PIXEL;
+        }
+    }
+}
+
+int persistenceDecay(int frames) {
+    if (frames <= 0) {
+        return 0;
+    }
+    // Rounds up to 256 from about 1400 frames, which would never fade at all
+    return std::min(int(std::lround(256 * std::pow(PERSISTENCE_RESIDUE, 1.0 / frames))), 255);
+}
+
+void decayPixels(const pixels_t& current, pixels_t& shown, int width, int height, int decay,
+                 const Palette& palette) {
+    const uint8_t* background = palette[0].data();
+    const size_t size = size_t(width * height * BYTES_PER_PIXEL);
+    size_t n = 0;
+#ifdef __GNUC__
+    Bytes backgrounds;
+    for (size_t byte = 0; byte < sizeof(Bytes); byte++) {
+        backgrounds[byte] = background[byte % BYTES_PER_PIXEL];
+    }
+    Words backgroundPixels;
+    std::memcpy(&backgroundPixels, &backgrounds, sizeof(backgroundPixels));
+    for (; n + sizeof(Bytes) <= size; n += sizeof(Bytes)) {
+        Bytes now;
+        Bytes before;
+        std::memcpy(&now, current.data() + n, sizeof(now));
+        std::memcpy(&before, shown.data() + n, sizeof(before));
+        Bytes above = before > backgrounds;
+        Bytes distance = above ? before - backgrounds : backgrounds - before;
+        // A byte times a factor under 256 fits a 16 bit lane, so the even and odd bytes are scaled separately
+        Lanes lanes;
+        std::memcpy(&lanes, &distance, sizeof(lanes));
+        lanes = ((lanes & 0xFF) * uint16_t(decay)) >> 8 | ((lanes >> 8) * uint16_t(decay) & 0xFF00);
+        std::memcpy(&distance, &lanes, sizeof(distance));
+        Bytes faded = above ? backgrounds + distance : backgrounds - distance;
+        // Whole pixels are either lit or background
+        Words nowPixels;
+        std::memcpy(&nowPixels, &now, sizeof(nowPixels));
+        Words unlit = nowPixels == backgroundPixels;
+        Bytes unlitBytes;
+        std::memcpy(&unlitBytes, &unlit, sizeof(unlitBytes));
+        Bytes result = unlitBytes != 0 ? faded : now;
+        std::memcpy(shown.data() + n, &result, sizeof(result));
+    }
+#endif
+    for (; n < size; n += BYTES_PER_PIXEL) {
+        if (std::memcmp(current.data() + n, background, BYTES_PER_PIXEL) != 0) {
+            std::memcpy(shown.data() + n, current.data() + n, BYTES_PER_PIXEL);
+            continue;
+        }
+        for (size_t channel = n; channel < n + BYTES_PER_PIXEL; channel++) {
+            int offset = shown[channel] - background[channel - n];
+            int faded = std::abs(offset) * decay >> 8;
+            shown[channel] = uint8_t(background[channel - n] + (offset < 0 ? -faded : faded));
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef CHIP8_FRAMEBUFFER_H
+#define CHIP8_FRAMEBUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "Chip8.h"
+
+constexpr int BYTES_PER_PIXEL = 4; // RGBA, as expected by sf::Texture::update
+
+// Grey levels for each combination of the two planes: none, first only, second only, both
+constexpr uint8_t PLANE_LEVELS[] = {0x00, 0xFF, 0xAA, 0x55};
+
+using pixels_t = std::array<uint8_t, HIRES_WIDTH * HIRES_HEIGHT * BYTES_PER_PIXEL>;
+
+// An RGBA color for each combination of the two planes, in the same order as PLANE_LEVELS
+using Palette = std::array<std::array<uint8_t, BYTES_PER_PIXEL>, 4>;
+
+constexpr Palette GREY_PALETTE = {{
+    {PLANE_LEVELS[0], PLANE_LEVELS[0], PLANE_LEVELS[0], 0xFF},
+    {PLANE_LEVELS[1], PLANE_LEVELS[1], PLANE_LEVELS[1], 0xFF},
+    {PLANE_LEVELS[2], PLANE_LEVELS[2], PLANE_LEVELS[2], 0xFF},
+    {PLANE_LEVELS[3], PLANE_LEVELS[3], PLANE_LEVELS[3], 0xFF},
+}};
+
+// A named palette (grey, green, amber, octo or lcd), or two or four RRGGBB colors separated by commas: the background
+// and the first plane, then the second plane and both. With two, the other two are shaded between them.
+bool parsePalette(const std::string& text, Palette& palette);
+
+// Converts the top left width x height pixels of VRAM into tightly packed RGBA pixels, kept free of SFML so it can
+// run headless. plane2 is XO-CHIP's second bitplane, if there is one.
+void vramToPixels(const vram_t& vram, const vram_t* plane2, pixels_t& pixels, int width, int height,
+                  const Palette& palette = GREY_PALETTE);
+
+// Phosphor persistence: pixels light up at once but take about `frames` frames to fade, which smooths over ROMs that
+// erase and redraw their sprites every frame. The decay per frame, out of 256, or 0 for none when frames is 0.
+int persistenceDecay(int frames);
+// Fades shown towards current: pixels lit in current are shown as they are, the others move from shown towards the
+// palette's background, keeping (shown - background) * decay / 256 of each channel. Fading towards the background
+// rather than black works with light backgrounds too. Works on 16 bytes at a time with GCC and Clang's vector
+// extensions, so it costs less than converting the pixels.
+void decayPixels(const pixels_t& current, pixels_t& shown, int width, int height, int decay,
+                 const Palette& palette = GREY_PALETTE);
+
+#endif //CHIP8_FRAMEBUFFER_H
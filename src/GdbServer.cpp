@@ -0,0 +1,538 @@
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "GdbServer.h"
+#include "Options.h"
+
+constexpr int GDB_PACKET_SIZE = 0x4000; // advertised to GDB, in hex characters
+constexpr int GDB_POLL_MS = 10; // how often a running machine is checked for stops and the client for ^C
+constexpr int GDB_REGISTERS = 21; // V0-VF, I, PC, SP, DT and ST
+constexpr int GDB_REGISTER_BYTES = 23; // I and PC take two bytes
+constexpr size_t GDB_MAX_HEX_DIGITS = 8; // numbers in packets fit in 32 bits
+constexpr char INTERRUPT = 0x03; // ^C from GDB
+constexpr int SIGILL_SIGNAL = 4;
+constexpr int SIGTRAP_SIGNAL = 5;
+constexpr int SIGSEGV_SIGNAL = 11;
+
+namespace {
+
+const std::string TARGET_XML_QUERY = "qXfer:features:read:target.xml";
+const char* TARGET_XML =
+    "<?xml version=\"1.0\"?><!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\"><feature name=\"org.yachie.chip8\">"
+    "<reg name=\"v0\" bitsize=\"8\" regnum=\"0\"/><reg name=\"v1\" bitsize=\"8\"/><reg name=\"v2\" bitsize=\"8\"/>"
+    "<reg name=\"v3\" bitsize=\"8\"/><reg name=\"v4\" bitsize=\"8\"/><reg name=\"v5\" bitsize=\"8\"/>"
+    "<reg name=\"v6\" bitsize=\"8\"/><reg name=\"v7\" bitsize=\"8\"/><reg name=\"v8\" bitsize=\"8\"/>"
+    "<reg name=\"v9\" bitsize=\"8\"/><reg name=\"va\" bitsize=\"8\"/><reg name=\"vb\" bitsize=\"8\"/>"
+    "<reg name=\"vc\" bitsize=\"8\"/><reg name=\"vd\" bitsize=\"8\"/><reg name=\"ve\" bitsize=\"8\"/>"
+    "<reg name=\"vf\" bitsize=\"8\"/>"
+    "<reg name=\"i\" bitsize=\"16\" type=\"data_ptr\"/><reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "<reg name=\"sp\" bitsize=\"8\"/><reg name=\"dt\" bitsize=\"8\"/><reg name=\"st\" bitsize=\"8\"/>"
+    "</feature></target>";
+
+std::string hexByte(int value) {
+    char text[3];
+    std::snprintf(text, sizeof(text), "%02x", value & 0xFF);
+    return text;
+}
+
+int hexDigit(char c) {
+    auto character = static_cast<unsigned char>(c);
+    return std::isdigit(character) ? c - '0' : std::tolower(character) - 'a' + 10;
+}
+
+// Reads hex digits from position onwards, leaving position on the first other character. False if there are more
+// than GDB_MAX_HEX_DIGITS of them.
+bool parseHex(const std::string& text, size_t& position, uint32_t& value) {
+    value = 0;
+    size_t start = position;
+    while (position < text.size() && std::isxdigit(static_cast<unsigned char>(text[position]))) {
+        if (position - start == GDB_MAX_HEX_DIGITS) {
+            return false;
+        }
+        value = value << 4 | uint32_t(hexDigit(text[position]));
+        position++;
+    }
+    return true;
+}
+
+uint8_t hexByteAt(const std::string& text, size_t offset) {
+    return uint8_t(hexDigit(text[offset]) << 4 | hexDigit(text[offset + 1]));
+}
+
+int registerSize(int reg) {
+    return reg == 16 || reg == 17 ? 2 : 1; // I and PC
+}
+
+// Where a register starts in the g packet, in hex characters
+size_t registerOffset(int reg) {
+    size_t offset = 0;
+    for (int n = 0; n < reg; n++) {
+        offset += size_t(registerSize(n)) * 2;
+    }
+    return offset;
+}
+
+} // namespace
+
+GdbServer::GdbServer(Chip8& cpu) : cpu(cpu) {}
+
+GdbServer::~GdbServer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    done.notify_all();
+    if (listenSocket >= 0) {
+        shutdown(listenSocket, SHUT_RDWR); // wakes accept()
+    }
+    int client = clientSocket;
+    if (client >= 0) {
+        shutdown(client, SHUT_RDWR); // wakes recv()
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (listenSocket >= 0) {
+        close(listenSocket);
+    }
+    if (!unixPath.empty()) {
+        unlink(unixPath.c_str());
+    }
+}
+
+bool GdbServer::listen(const std::string& address) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        sockaddr_un local {};
+        local.sun_family = AF_UNIX;
+        unixPath = address.substr(5);
+        if (unixPath.size() >= sizeof(local.sun_path)) {
+            std::cerr << "GDB socket path too long: " << unixPath << std::endl;
+            return false;
+        }
+        std::strcpy(local.sun_path, unixPath.c_str());
+        unlink(unixPath.c_str());
+        listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket < 0 || bind(listenSocket, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Couldn't listen for GDB on " << unixPath << std::endl;
+            return false;
+        }
+    } else {
+        uint16_t port = 0;
+        if (!parseNumber(address, port) || port == 0) {
+            std::cerr << "Not a port for GDB: " << address << std::endl;
+            return false;
+        }
+        sockaddr_in local {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // never reachable from other machines
+        local.sin_port = htons(port);
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (listenSocket < 0 || bind(listenSocket, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Couldn't listen for GDB on port " << address << std::endl;
+            return false;
+        }
+    }
+    if (::listen(listenSocket, 1) != 0) {
+        return false;
+    }
+    std::cout << "Waiting for GDB on " << address << std::endl;
+    thread = std::thread(&GdbServer::serve, this);
+    return true;
+}
+
+void GdbServer::poll() {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return; // the server thread is busy, try again on the next poll
+    }
+    if (work) {
+        workReply = work();
+        work = nullptr;
+        workDone = true;
+        done.notify_all();
+    }
+    if (resumed && (cpu.debugger.isPaused() || !cpu.state.running)) {
+        resumed = false;
+        stopped = stopReply();
+        done.notify_all();
+    }
+}
+
+FaultPolicy GdbServer::trap(const FaultRecord& fault) {
+    trapped = fault;
+    return FaultPolicy::Pause;
+}
+
+void GdbServer::serve() {
+    while (!stopping) {
+        clientSocket = accept(listenSocket, nullptr, nullptr);
+        if (clientSocket < 0) {
+            break;
+        }
+        // GDB expects a stopped target when it attaches
+        onEmulator([this] {
+            cpu.debugger.pause();
+            return std::string();
+        });
+        session();
+        if (!stopping) { // detached, killed or gone: leave the emulator running without GDB's breakpoints
+            onEmulator([this] {
+                cpu.debugger.clear();
+                cpu.debugger.resume(cpu.state.pc);
+                return std::string();
+            });
+        }
+        close(clientSocket);
+        clientSocket = -1;
+        input.clear();
+        noAck = false;
+    }
+}
+
+void GdbServer::session() {
+    std::string packet;
+    while (!stopping && readPacket(packet)) {
+        if (packet.empty()) {
+            if (!sendPacket("")) {
+                return;
+            }
+        } else if (packet[0] == 'c' || packet[0] == 's') { // continue or step, optionally from an address
+            bool step = packet[0] == 's';
+            size_t position = 1;
+            bool hasAddress = packet.size() > 1;
+            uint32_t address = 0;
+            if (!parseHex(packet, position, address) || address >= uint32_t(DEBUGGER_ADDRESSES)) {
+                if (!sendPacket("E01")) {
+                    return;
+                }
+                continue;
+            }
+            onEmulator([this, step, hasAddress, address] {
+                if (hasAddress) {
+                    cpu.state.pc = uint16_t(address);
+                }
+                if (step) {
+                    cpu.debugger.step(cpu.state.pc, 1);
+                } else {
+                    cpu.debugger.resume(cpu.state.pc);
+                }
+                stopped.clear();
+                resumed = true;
+                return std::string();
+            });
+            if (!sendPacket(waitForStop())) {
+                return;
+            }
+        } else if (packet == "D" || packet.compare(0, 2, "D;") == 0) {
+            sendPacket("OK");
+            return;
+        } else if (packet == "k") {
+            return; // the emulator keeps running, only the session ends
+        } else if (!sendPacket(handle(packet))) {
+            return;
+        }
+    }
+}
+
+std::string GdbServer::handle(const std::string& packet) {
+    size_t position = 1;
+    switch (packet[0]) {
+    case '?':
+        return onEmulator([this] {return stopReply();});
+    case 'g':
+        return onEmulator([this] {return readRegisters();});
+    case 'G':
+        return onEmulator([this, packet] {
+            writeRegisters(packet.substr(1));
+            return std::string("OK");
+        });
+    case 'p': {
+        uint32_t number = 0;
+        if (!parseHex(packet, position, number) || number >= uint32_t(GDB_REGISTERS)) {
+            return "E01";
+        }
+        int reg = int(number);
+        return onEmulator([this, reg] {
+            return readRegisters().substr(registerOffset(reg), size_t(registerSize(reg)) * 2);
+        });
+    }
+    case 'P': {
+        uint32_t number = 0;
+        if (!parseHex(packet, position, number) || number >= uint32_t(GDB_REGISTERS)) {
+            return "E01";
+        }
+        int reg = int(number);
+        std::string value = packet.substr(position + 1);
+        if (value.size() != size_t(registerSize(reg) * 2)) {
+            return "E01";
+        }
+        return onEmulator([this, reg, value] {
+            std::string all = readRegisters();
+            all.replace(registerOffset(reg), value.size(), value);
+            writeRegisters(all);
+            return std::string("OK");
+        });
+    }
+    case 'm': {
+        uint32_t address = 0;
+        uint32_t length = 0;
+        bool valid = parseHex(packet, position, address);
+        position++;
+        if (!valid || !parseHex(packet, position, length)) {
+            return "E01";
+        }
+        return onEmulator([this, address, length] {return readMemory(address, length);});
+    }
+    case 'M': {
+        uint32_t address = 0;
+        uint32_t length = 0;
+        bool valid = parseHex(packet, position, address);
+        position++;
+        if (!valid || !parseHex(packet, position, length)) {
+            return "E01";
+        }
+        std::string data = packet.substr(position + 1);
+        return onEmulator([this, address, length, data] {
+            return std::string(writeMemory(address, length, data) ? "OK" : "E01");
+        });
+    }
+    case 'Z':
+    case 'z': {
+        bool insert = packet[0] == 'Z';
+        uint32_t type = 0;
+        uint32_t address = 0;
+        uint32_t length = 0;
+        bool valid = parseHex(packet, position, type);
+        position++;
+        valid = valid && parseHex(packet, position, address);
+        position++;
+        if (!valid || !parseHex(packet, position, length) || address >= uint32_t(DEBUGGER_ADDRESSES) ||
+            length > uint32_t(DEBUGGER_ADDRESSES)) {
+            return "E01";
+        }
+        if (type == 0 || type == 1) { // software and hardware breakpoints are the same thing here
+            return onEmulator([this, insert, address] {
+                cpu.debugger.setBreakpoint(uint16_t(address), insert);
+                return std::string("OK");
+            });
+        } else if (type == 2) { // write watchpoint
+            return onEmulator([this, insert, address, length] {
+                cpu.debugger.setWatchpoint(uint16_t(address), int(length), insert);
+                return std::string("OK");
+            });
+        }
+        return "";
+    }
+    case 'H':
+        return "OK"; // there's only one thread
+    case 'T':
+        return "OK";
+    case 'q':
+        if (packet.compare(0, 10, "qSupported") == 0) {
+            char features[64];
+            std::snprintf(features, sizeof(features), "PacketSize=%x;qXfer:features:read+;QStartNoAckMode+",
+                          GDB_PACKET_SIZE);
+            return features;
+        } else if (packet.compare(0, TARGET_XML_QUERY.size(), TARGET_XML_QUERY) == 0) {
+            position = TARGET_XML_QUERY.size() + 1; // after the colon
+            uint32_t offset = 0;
+            uint32_t length = 0;
+            bool valid = parseHex(packet, position, offset);
+            position++;
+            if (!valid || !parseHex(packet, position, length)) {
+                return "E01";
+            }
+            std::string xml = TARGET_XML;
+            if (offset >= xml.size()) {
+                return "l";
+            }
+            std::string part = xml.substr(offset, length);
+            return (offset + part.size() < xml.size() ? "m" : "l") + part;
+        } else if (packet == "qAttached") {
+            return "1";
+        } else if (packet == "qC") {
+            return "QC1";
+        } else if (packet == "qfThreadInfo") {
+            return "m1";
+        } else if (packet == "qsThreadInfo") {
+            return "l";
+        }
+        return "";
+    case 'Q':
+        if (packet == "QStartNoAckMode") {
+            noAck = true; // this packet was already acknowledged, GDB stops after the reply
+            return "OK";
+        }
+        return "";
+    default:
+        return "";
+    }
+}
+
+bool GdbServer::readPacket(std::string& packet) {
+    while (true) {
+        size_t start = input.find('$');
+        size_t end = start == std::string::npos ? std::string::npos : input.find('#', start);
+        if (end != std::string::npos && end + 2 < input.size()) {
+            packet = input.substr(start + 1, end - start - 1);
+            int checksum = hexByteAt(input, end + 1);
+            input.erase(0, end + 3);
+            int sum = 0;
+            for (char c : packet) {
+                sum += static_cast<unsigned char>(c);
+            }
+            if (!noAck && !sendRaw((sum & 0xFF) == checksum ? "+" : "-")) {
+                return false;
+            }
+            if ((sum & 0xFF) == checksum || noAck) {
+                return true;
+            }
+            continue;
+        }
+        if (start == std::string::npos) {
+            input.clear(); // acks and stray ^Cs while stopped
+        }
+        char buffer[4096];
+        ssize_t received = recv(clientSocket, buffer, sizeof(buffer), 0);
+        if (received <= 0 || stopping) {
+            return false;
+        }
+        input.append(buffer, size_t(received));
+    }
+}
+
+bool GdbServer::sendPacket(const std::string& payload) {
+    int sum = 0;
+    for (char c : payload) {
+        sum += static_cast<unsigned char>(c);
+    }
+    return sendRaw("$" + payload + "#" + hexByte(sum));
+}
+
+bool GdbServer::sendRaw(const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(clientSocket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0) {
+            return false;
+        }
+        sent += size_t(count);
+    }
+    return true;
+}
+
+std::string GdbServer::waitForStop() {
+    while (!stopping) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (done.wait_for(lock, std::chrono::milliseconds(GDB_POLL_MS), [this] {return !stopped.empty();})) {
+                std::string reply = stopped;
+                stopped.clear();
+                return reply;
+            }
+        }
+        pollfd client {clientSocket, POLLIN, 0};
+        if (::poll(&client, 1, 0) > 0) {
+            char buffer[256];
+            ssize_t received = recv(clientSocket, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return "";
+            }
+            if (std::memchr(buffer, INTERRUPT, size_t(received)) != nullptr) {
+                onEmulator([this] {
+                    cpu.debugger.pause();
+                    return std::string();
+                });
+            }
+        }
+    }
+    return "";
+}
+
+std::string GdbServer::onEmulator(std::function<std::string()> request) {
+    std::unique_lock<std::mutex> lock(mutex);
+    work = std::move(request);
+    workDone = false;
+    done.wait(lock, [this] {return workDone || stopping;});
+    work = nullptr;
+    return workReply;
+}
+
+std::string GdbServer::stopReply() {
+    if (!cpu.state.running) {
+        // Halted by a fault, or never started
+        return "S" + hexByte(cpu.state.pc > cpu.memorySize() - OPCODE_SIZE ? SIGSEGV_SIGNAL : SIGILL_SIGNAL);
+    }
+    switch (cpu.debugger.lastStop()) {
+    case DebugStop::Watchpoint: {
+        char reply[32];
+        std::snprintf(reply, sizeof(reply), "T%02xwatch:%x;", SIGTRAP_SIGNAL, cpu.debugger.watchHit());
+        return reply;
+    }
+    case DebugStop::Fault: {
+        bool memory = trapped.fault == Fault::PcOutOfBounds || trapped.fault == Fault::MemoryOutOfBounds;
+        return "S" + hexByte(memory ? SIGSEGV_SIGNAL : SIGILL_SIGNAL);
+    }
+    default:
+        return "S" + hexByte(SIGTRAP_SIGNAL);
+    }
+}
+
+std::string GdbServer::readRegisters() {
+    std::string hex;
+    for (uint8_t v : cpu.state.v) {
+        hex += hexByte(v);
+    }
+    hex += hexByte(cpu.state.i) + hexByte(cpu.state.i >> 8);
+    hex += hexByte(cpu.state.pc) + hexByte(cpu.state.pc >> 8);
+    hex += hexByte(cpu.state.sp) + hexByte(cpu.state.delayTimer) + hexByte(cpu.state.soundTimer);
+    return hex;
+}
+
+void GdbServer::writeRegisters(const std::string& hex) {
+    auto byte = [&hex](int n) {return hexByteAt(hex, size_t(n) * 2);};
+    if (hex.size() < GDB_REGISTER_BYTES * 2) {
+        return;
+    }
+    for (int n = 0; n < 16; n++) {
+        cpu.state.v[n] = byte(n);
+    }
+    cpu.state.i = uint16_t(byte(16) | byte(17) << 8);
+    cpu.state.pc = uint16_t(byte(18) | byte(19) << 8);
+    cpu.state.sp = byte(20);
+    cpu.state.delayTimer = byte(21);
+    cpu.state.soundTimer = byte(22);
+}
+
+std::string GdbServer::readMemory(uint32_t address, uint32_t length) {
+    const auto size = uint32_t(cpu.memorySize());
+    if (address > size || length > size - address) {
+        return "E01";
+    }
+    std::string hex;
+    for (uint32_t n = 0; n < length; n++) {
+        hex += hexByte(cpu.memory()[address + n]);
+    }
+    return hex;
+}
+
+bool GdbServer::writeMemory(uint32_t address, uint32_t length, const std::string& hex) {
+    const auto size = uint32_t(cpu.memorySize());
+    if (address > size || length > size - address || hex.size() < size_t(length) * 2) {
+        return false;
+    }
+    for (uint32_t n = 0; n < length; n++) {
+        cpu.memory()[address + n] = hexByteAt(hex, size_t(n) * 2);
+    }
+    cpu.rehash();
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef CHIP8_GDBSERVER_H
+#define CHIP8_GDBSERVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Chip8.h"
+
+// GDB remote serial protocol stub. Registers are V0-VF, I, PC, SP, DT and ST, described to GDB by a target.xml,
+// multi-byte registers being little-endian. Breakpoints and write watchpoints go through Chip8::debugger. GDB has no
+// CHIP-8 architecture to go with the description, so this is for clients that use target.xml's register layout.
+//
+// The protocol runs on its own thread. Anything touching the machine is handed to poll() on the emulation thread,
+// which never waits for the socket, so emulation only stops when GDB asks for it.
+class GdbServer {
+public:
+    explicit GdbServer(Chip8& cpu);
+    ~GdbServer();
+    GdbServer(const GdbServer&) = delete;
+    GdbServer& operator=(const GdbServer&) = delete;
+    // Listens on 127.0.0.1:port, or on a Unix socket for "unix:/path", and starts serving one client at a time
+    bool listen(const std::string& address);
+    // Runs the request GDB is waiting on, if any, and reports the machine stopping after a continue or step
+    void poll();
+    // A Chip8::trapHandler that pauses on the faulting instruction and reports it to GDB as SIGILL or SIGSEGV
+    FaultPolicy trap(const FaultRecord& fault);
+
+private:
+    void serve();
+    void session();
+    bool readPacket(std::string& packet); // false once the client has gone
+    bool sendPacket(const std::string& payload);
+    bool sendRaw(const std::string& data);
+    std::string handle(const std::string& packet); // returns the reply, "" for unsupported packets
+    std::string waitForStop(); // while the machine runs, also forwards ^C from the client
+    std::string onEmulator(std::function<std::string()> work); // runs work in poll() and waits for its reply
+    std::string stopReply();
+    std::string readRegisters();
+    void writeRegisters(const std::string& hex);
+    std::string readMemory(uint32_t address, uint32_t length);
+    bool writeMemory(uint32_t address, uint32_t length, const std::string& hex);
+    Chip8& cpu;
+    std::thread thread;
+    int listenSocket = -1;
+    std::atomic<int> clientSocket{-1};
+    std::string unixPath; // removed again on shutdown
+    std::atomic<bool> stopping{false};
+    std::string input; // received but not yet parsed
+    bool noAck = false;
+    // The request being handed to the emulation thread, guarded by mutex
+    std::mutex mutex;
+    std::condition_variable done;
+    std::function<std::string()> work;
+    std::string workReply;
+    bool workDone = false;
+    // Set by poll() while the machine runs on GDB's behalf
+    bool resumed = false;
+    std::string stopped; // stop reply once a resumed machine stops, guarded by mutex
+    FaultRecord trapped; // the fault of the last DebugStop::Fault, only used on the emulation thread
+};
+
+#endif //CHIP8_GDBSERVER_H
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "GridDisplay.h"
+#include "Tracer.h"
+
+namespace {
+
+const std::string GRID_TITLE = "Chip-8 grid";
+constexpr float SCREEN_FRACTION = 0.9f; // of the desktop the window can take up at most
+constexpr int TILE_GAP = 2; // texels between tiles on screen
+
+int gridColumnsFor(int tiles) {
+    return std::max(1, int(std::ceil(std::sqrt(double(tiles)))));
+}
+
+} // namespace
+
+GridDisplay::GridDisplay(int tiles, const Palette& palette) :
+    atlas(tiles, int(sf::Texture::getMaximumSize()), palette), vertices(sf::Quads, size_t(std::max(tiles, 0)) * 4),
+    placedWidths(size_t(std::max(tiles, 0)), 0), gridColumns(gridColumnsFor(tiles)),
+    background(sf::Uint8(palette[0][0] / 2), sf::Uint8(palette[0][1] / 2), sf::Uint8(palette[0][2] / 2)) {
+    if (!isOpen() || !texture.create(unsigned(atlas.width()), unsigned(atlas.height()))) {
+        atlas = TileAtlas(0, 0);
+        return;
+    }
+    // Left unsmoothed: filtering would blend in texels from the neighbouring tiles, and from the unused part of a tile
+    // in low resolution, at the edges of every tile shown smaller than it is
+    texture.setSmooth(false);
+    // The grid is laid out in texels and the view scales it to whatever size the window is
+    const int gridRows = (tiles + gridColumns - 1) / gridColumns;
+    const float gridWidth = float(gridColumns * (TILE_WIDTH + TILE_GAP) - TILE_GAP);
+    const float gridHeight = float(gridRows * (TILE_HEIGHT + TILE_GAP) - TILE_GAP);
+    sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+    float scale = std::min({1.f, SCREEN_FRACTION * float(desktop.width) / gridWidth,
+                            SCREEN_FRACTION * float(desktop.height) / gridHeight});
+    window.create(sf::VideoMode(unsigned(gridWidth * scale), unsigned(gridHeight * scale)), GRID_TITLE);
+    window.setView(sf::View(sf::FloatRect(0, 0, gridWidth, gridHeight)));
+    for (int tile = 0; tile < tiles; tile++) {
+        placeTile(tile);
+    }
+}
+
+// Points the tile's quad at the part of its atlas tile in use, stretched over the whole tile either way
+void GridDisplay::placeTile(int tile) {
+    const auto x = float(tile % gridColumns * (TILE_WIDTH + TILE_GAP));
+    const auto y = float(tile / gridColumns * (TILE_HEIGHT + TILE_GAP));
+    const auto u = float(atlas.tileX(tile));
+    const auto v = float(atlas.tileY(tile));
+    const auto width = float(atlas.screenWidth(tile));
+    const auto height = float(atlas.screenHeight(tile));
+    sf::Vertex* quad = &vertices[size_t(tile) * 4];
+    quad[0] = sf::Vertex(sf::Vector2f(x, y), sf::Vector2f(u, v));
+    quad[1] = sf::Vertex(sf::Vector2f(x + TILE_WIDTH, y), sf::Vector2f(u + width, v));
+    quad[2] = sf::Vertex(sf::Vector2f(x + TILE_WIDTH, y + TILE_HEIGHT), sf::Vector2f(u + width, v + height));
+    quad[3] = sf::Vertex(sf::Vector2f(x, y + TILE_HEIGHT), sf::Vector2f(u, v + height));
+    placedWidths[size_t(tile)] = atlas.screenWidth(tile);
+}
+
+void GridDisplay::draw() {
+    TRACE_SCOPE("draw", "display");
+    {
+        TRACE_SCOPE("upload", "display");
+        for (const TileUpload& upload : atlas.uploads()) {
+            texture.update(atlas.uploadPixels() + upload.offset, unsigned(upload.width), unsigned(upload.height),
+                           unsigned(upload.x), unsigned(upload.y));
+        }
+        atlas.clearUploads();
+    }
+    for (int tile = 0; tile < atlas.tiles(); tile++) {
+        if (placedWidths[size_t(tile)] != atlas.screenWidth(tile)) {
+            placeTile(tile);
+        }
+    }
+    TRACE_SCOPE("present", "display");
+    window.clear(background);
+    window.draw(vertices, &texture);
+    window.display();
+}
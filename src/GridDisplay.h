@@ -0,0 +1,29 @@
+#ifndef CHIP8_GRIDDISPLAY_H
+#define CHIP8_GRIDDISPLAY_H
+
+#include <SFML/Graphics.hpp>
+#include "Chip8.h"
+#include "TileAtlas.h"
+
+// One window showing many machines at once, in a grid about as many tiles wide as high. Their screens share a
+// TileAtlas texture that gets only the rectangles that changed each frame, and the grid is a single vertex array of a
+// quad per machine, so drawing it is one call however many machines there are.
+class GridDisplay {
+public:
+    GridDisplay(int tiles, const Palette& palette);
+    bool isOpen() const {return atlas.tiles() > 0;} // false if the tiles don't fit in a texture
+    void update(int tile, const Chip8& cpu) {atlas.update(tile, cpu);}
+    void draw();
+    sf::RenderWindow window;
+
+private:
+    void placeTile(int tile);
+    TileAtlas atlas;
+    sf::Texture texture;
+    sf::VertexArray vertices; // four per tile
+    std::vector<int> placedWidths; // the screen width each tile's texture coordinates are for
+    int gridColumns;
+    sf::Color background;
+};
+
+#endif //CHIP8_GRIDDISPLAY_H
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <sstream>
+#include "Lockstep.h"
+#include "Opcodes.h"
+
+namespace {
+
+// Random programs start with a jump over the area I can reach, so that stores never rewrite code
+constexpr int RANDOM_CODE_OFFSET = 0x600;
+constexpr int RANDOM_DATA_SIZE = 0x1C0; // ANNN and F000 NNNN targets, leaving room for a 64 byte XO-CHIP sprite
+constexpr int RANDOM_MAX_INSTRUCTIONS = 1024; // leaves BNNN + V0 room to land after the program
+// Fills memory after the program: read at either alignment it's 1616, a jump back into the program
+constexpr uint8_t RANDOM_PADDING = 0x16;
+constexpr int RANDOM_PADDING_TARGET = 0x616;
+
+template <typename T>
+std::string differs(const std::string& name, T expected, T actual) {
+    std::ostringstream text;
+    text << name << ": " << std::hex << "0x" << int(expected) << " != 0x" << int(actual);
+    return text.str();
+}
+
+template <typename T>
+std::string differs(const std::string& name, int index, T expected, T actual) {
+    std::ostringstream label;
+    label << name << "[0x" << std::hex << index << "]";
+    return differs(label.str(), expected, actual);
+}
+
+std::string comparePlane(const std::string& name, const vram_t& expected, const vram_t& actual) {
+    if (expected == actual) {
+        return "";
+    }
+    for (int y = 0; y < HIRES_HEIGHT; y++) {
+        for (int x = 0; x < HIRES_WIDTH; x++) {
+            if (expected[y][x] != actual[y][x]) {
+                std::ostringstream label;
+                label << name << " pixel (" << x << ", " << y << ")";
+                return differs(label.str(), expected[y][x], actual[y][x]);
+            }
+        }
+    }
+    return "";
+}
+
+template <typename T>
+std::string compareArray(const std::string& name, const T* expected, const T* actual, int size) {
+    if (std::memcmp(expected, actual, size * sizeof(T)) == 0) {
+        return "";
+    }
+    for (int n = 0; n < size; n++) {
+        if (expected[n] != actual[n]) {
+            return differs(name, n, expected[n], actual[n]);
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+RunResult runBatched(Chip8& cpu, int instructions) {
+    return cpu.run(instructions);
+}
+
+RunResult runStepped(Chip8& cpu, int instructions) {
+    RunResult result {0, {}};
+    while (result.executed < instructions) {
+        RunResult part = cpu.run(1);
+        result.executed += part.executed;
+        if (part.fault.fault != Fault::None) {
+            result.fault = part.fault;
+        }
+        result.stop = part.stop;
+        if (part.executed == 0) {
+            break;
+        }
+    }
+    return result;
+}
+
+RunResult runChecked(Chip8& cpu, int instructions) {
+    // A breakpoint on the entry point and a watchpoint on the font keep the debugger active, and stopping
+    // there now and then exercises resume() too
+    if (!cpu.debugger.active()) {
+        cpu.debugger.setBreakpoint(PROGRAM_OFFSET);
+        cpu.debugger.setWatchpoint(0, sizeof(FONT_SET));
+    }
+    RunResult result {0, {}};
+    while (result.executed < instructions) {
+        RunResult part = cpu.run(instructions - result.executed);
+        result.executed += part.executed;
+        if (part.fault.fault != Fault::None) {
+            result.fault = part.fault;
+        }
+        if (part.stop != DebugStop::Breakpoint && part.stop != DebugStop::Watchpoint) {
+            break;
+        }
+        cpu.debugger.resume(cpu.state.pc);
+    }
+    return result;
+}
+
+Divergence LockstepRunner::run(const Setup& setup, const Input& input, const LockstepOptions& options) const {
+    Divergence divergence = runBlocks(setup, input, options);
+    if (!divergence.found || options.blockSize == 1) {
+        return divergence;
+    }
+    // Somewhere in the last block, find the instruction
+    LockstepOptions single = options;
+    single.blockSize = 1;
+    Divergence exact = runBlocks(setup, input, single);
+    if (!exact.found) {
+        divergence.difference += " (not reproduced one instruction at a time)";
+        return divergence;
+    }
+    return exact;
+}
+
+Divergence LockstepRunner::runBlocks(const Setup& setup, const Input& input, const LockstepOptions& options) const {
+    auto expected = std::make_unique<Chip8>();
+    auto actual = std::make_unique<Chip8>();
+    setup(*expected);
+    setup(*actual);
+    Divergence divergence;
+    divergence.difference = compare(*expected, *actual);
+    if (divergence.difference.empty() && options.checkHashes) {
+        divergence.difference = compareHashes(*expected, *actual);
+    }
+    if (!divergence.difference.empty()) {
+        divergence.found = true;
+        divergence.difference = "after setup, " + divergence.difference;
+        return divergence;
+    }
+    std::deque<std::pair<uint16_t, uint16_t>> trace;
+    for (int frame = 0; frame < options.frames; frame++) {
+        divergence.frame = frame;
+        int remaining = options.instructionsPerFrame;
+        while (remaining > 0) {
+            input(*expected, frame);
+            input(*actual, frame);
+            if (!expected->state.running && !actual->state.running) {
+                break;
+            }
+            uint16_t pc = expected->state.pc;
+            const uint8_t* memory = expected->memory();
+            trace.emplace_back(pc, pc + 1 < expected->memorySize() ? uint16_t(memory[pc] << 8 | memory[pc + 1]) : 0);
+            if (int(trace.size()) > options.traceLength) {
+                trace.pop_front();
+            }
+            int block = std::min(options.blockSize, remaining);
+            RunResult expectedResult = reference(*expected, block);
+            RunResult actualResult = candidate(*actual, block);
+            divergence.difference = compare(expectedResult, actualResult);
+            if (divergence.difference.empty()) {
+                divergence.difference = compare(*expected, *actual);
+            }
+            if (divergence.difference.empty() && options.checkHashes) {
+                divergence.difference = compareHashes(*expected, *actual);
+            }
+            if (!divergence.difference.empty()) {
+                divergence.found = true;
+                divergence.trace.assign(trace.begin(), trace.end());
+                return divergence;
+            }
+            divergence.instruction += expectedResult.executed;
+            remaining -= std::max(expectedResult.executed, 1);
+        }
+        expected->tickTimers();
+        actual->tickTimers();
+    }
+    return divergence;
+}
+
+std::string LockstepRunner::compare(const RunResult& expected, const RunResult& actual) {
+    if (expected.executed != actual.executed) {
+        return "instructions executed: " + std::to_string(expected.executed) + " != " +
+               std::to_string(actual.executed);
+    }
+    if (expected.fault.fault != actual.fault.fault || expected.fault.pc != actual.fault.pc ||
+        expected.fault.opcode != actual.fault.opcode) {
+        return "fault: " + describeFault(expected.fault) + " != " + describeFault(actual.fault);
+    }
+    if (expected.stop != actual.stop) {
+        return differs("debugger stop", expected.stop, actual.stop);
+    }
+    return "";
+}
+
+std::string LockstepRunner::compare(const Chip8& expected, const Chip8& actual) {
+    const Chip8State& a = expected.state;
+    const Chip8State& b = actual.state;
+    std::string difference;
+    if (a.pc != b.pc) {
+        return differs("PC", a.pc, b.pc);
+    }
+    if (a.i != b.i) {
+        return differs("I", a.i, b.i);
+    }
+    if (!(difference = compareArray("V", a.v, b.v, 16)).empty()) {
+        return difference;
+    }
+    if (a.sp != b.sp) {
+        return differs("SP", a.sp, b.sp);
+    }
+    if (!(difference = compareArray("stack", a.stack, b.stack, STACK_SIZE)).empty()) {
+        return difference;
+    }
+    if (a.delayTimer != b.delayTimer) {
+        return differs("DT", a.delayTimer, b.delayTimer);
+    }
+    if (a.soundTimer != b.soundTimer) {
+        return differs("ST", a.soundTimer, b.soundTimer);
+    }
+    if (a.running != b.running) {
+        return differs("running", a.running, b.running);
+    }
+    if (a.acceptingInputInto != b.acceptingInputInto) {
+        return differs("FX0A register", a.acceptingInputInto, b.acceptingInputInto);
+    }
+    if (a.hires != b.hires) {
+        return differs("hires", a.hires, b.hires);
+    }
+    if (!(difference = compareArray("key", a.input, b.input, NUMBER_OF_KEYS)).empty()) {
+        return difference;
+    }
+    if (!(difference = compareArray("RPL", a.rpl, b.rpl, RPL_FLAGS)).empty()) {
+        return difference;
+    }
+    if (!(difference = comparePlane("plane 1", a.vram, b.vram)).empty()) {
+        return difference;
+    }
+    // The XO-CHIP memory replaces the classic one
+    const uint8_t* memoryA = expected.xoChip ? expected.xoChip->memory.data() : a.memory;
+    const uint8_t* memoryB = actual.xoChip ? actual.xoChip->memory.data() : b.memory;
+    if (expected.memorySize() != actual.memorySize()) {
+        return differs("memory size", expected.memorySize(), actual.memorySize());
+    }
+    if (!(difference = compareArray("memory", memoryA, memoryB, expected.memorySize())).empty()) {
+        return difference;
+    }
+    if (!expected.xoChip || !actual.xoChip) {
+        return "";
+    }
+    const XoChipState& xoA = *expected.xoChip;
+    const XoChipState& xoB = *actual.xoChip;
+    if (!(difference = comparePlane("plane 2", xoA.plane2, xoB.plane2)).empty()) {
+        return difference;
+    }
+    if (xoA.planes != xoB.planes) {
+        return differs("planes", xoA.planes, xoB.planes);
+    }
+    if (xoA.pitch != xoB.pitch) {
+        return differs("pitch", xoA.pitch, xoB.pitch);
+    }
+    return compareArray("audio pattern", xoA.audioPattern, xoB.audioPattern, AUDIO_PATTERN_SIZE);
+}
+
+std::string LockstepRunner::compareHashes(const Chip8& expected, const Chip8& actual) {
+    // Equal states have to hash the same, and the incremental hashes have to match hashing from scratch
+    const Chip8* machines[] = {&expected, &actual};
+    for (const Chip8* machine : machines) {
+        uint64_t hash = machine->stateHash();
+        uint64_t computed = machine->computeStateHash();
+        if (hash != computed) {
+            std::ostringstream text;
+            text << (machine == &expected ? "reference" : "candidate") << " state hash: " << std::hex << "0x" << hash
+                 << " != 0x" << computed << " from scratch";
+            return text.str();
+        }
+    }
+    return expected.stateHash() == actual.stateHash() ? "" : "state hash differs between equal states";
+}
+
+std::string LockstepRunner::describe(const Divergence& divergence) {
+    if (!divergence.found) {
+        return "No divergence";
+    }
+    std::ostringstream text;
+    text << "Diverged after " << divergence.instruction << " instructions, in frame " << divergence.frame << ": "
+         << divergence.difference << "\n";
+    for (const auto& [pc, opcode] : divergence.trace) {
+        char address[16];
+        std::snprintf(address, sizeof(address), "  %04X  %04X  ", pc, opcode);
+        text << address << formatInstruction(opcode) << "\n";
+    }
+    return text.str();
+}
+
+std::vector<uint8_t> randomProgram(std::mt19937& rng, int instructions) {
+    instructions = std::clamp(instructions, (RANDOM_PADDING_TARGET - RANDOM_CODE_OFFSET) / OPCODE_SIZE + 1,
+                              RANDOM_MAX_INSTRUCTIONS);
+    std::vector<uint8_t> program(RANDOM_CODE_OFFSET - PROGRAM_OFFSET, 0);
+    program[0] = uint8_t(0x10 | RANDOM_CODE_OFFSET >> 8);
+    program[1] = uint8_t(RANDOM_CODE_OFFSET & 0xFF);
+    const int codeEnd = RANDOM_CODE_OFFSET + instructions * OPCODE_SIZE;
+    auto emit = [&program](uint16_t word) {
+        program.push_back(uint8_t(word >> 8));
+        program.push_back(uint8_t(word & 0xFF));
+    };
+    for (int n = 0; n < instructions; n++) {
+        // Any instruction but the unknown one at the end of the table
+        const OpcodeInfo& info = OPCODE_TABLE[rng() % (OPCODE_TABLE_SIZE - 1)];
+        uint16_t opcode = uint16_t((rng() & ~info.mask) | info.value);
+        if (opcode == 0x00FD) {
+            opcode = 0x00E0; // exiting would end most programs after a few instructions
+        } else if ((opcode & 0xF0FF) == 0xF01E) {
+            opcode = uint16_t((opcode & 0xFF00) | 0x29); // FX29 instead, FX1E could move I onto the code
+        }
+        switch (info.flow) {
+        case Flow::Jump:
+        case Flow::Call:
+            opcode = uint16_t((opcode & 0xF000) | (RANDOM_CODE_OFFSET + OPCODE_SIZE * (rng() % instructions)));
+            break;
+        case Flow::IndirectJump:
+            // Lands in the padding whatever V0 (or Vx) holds
+            opcode = uint16_t(0xB000 | codeEnd);
+            break;
+        default:
+            if ((opcode & 0xF000) == 0xA000) {
+                opcode = uint16_t(0xA000 | rng() % RANDOM_DATA_SIZE);
+            }
+            break;
+        }
+        if (info.length == 2 * OPCODE_SIZE && n + 1 < instructions) {
+            emit(opcode);
+            emit(uint16_t(rng() % RANDOM_DATA_SIZE)); // also a harmless 0NNN when reached by a jump
+            n++;
+            continue;
+        }
+        emit(info.length == 2 * OPCODE_SIZE ? uint16_t(0x00E0) : opcode);
+    }
+    return program;
+}
+
+void loadProgram(Chip8& cpu, const std::vector<uint8_t>& program) {
+    cpu.initState();
+    uint8_t* memory = cpu.memory();
+    std::fill(memory + PROGRAM_OFFSET, memory + cpu.memorySize(), RANDOM_PADDING);
+    std::copy(program.begin(), program.begin() + std::min<size_t>(program.size(), cpu.memorySize() - PROGRAM_OFFSET),
+              memory + PROGRAM_OFFSET);
+    cpu.rehash();
+    cpu.state.running = true;
+}
@@ -0,0 +1,72 @@
+#ifndef CHIP8_LOCKSTEP_H
+#define CHIP8_LOCKSTEP_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+// An execution engine: runs up to the given number of instructions and stops early in the same cases as
+// Chip8::run(), which is what any other decoder or executor has to be indistinguishable from
+using Engine = std::function<RunResult(Chip8& cpu, int instructions)>;
+
+// The engines there are so far, all of them different paths into Chip8::execute()
+RunResult runBatched(Chip8& cpu, int instructions); // Chip8::run()
+RunResult runStepped(Chip8& cpu, int instructions); // one Chip8::run(1) per instruction, like step()
+RunResult runChecked(Chip8& cpu, int instructions); // the debugger's checked loop, resuming from its stops
+
+struct LockstepOptions {
+    int frames = 600;
+    int instructionsPerFrame = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+    int blockSize = 1; // instructions each engine runs between comparisons
+    int traceLength = 16; // instructions reported before a divergence
+    // Also checks Chip8::stateHash() against computeStateHash() after every block. Hashing from scratch costs tens of
+    // microseconds a machine, far more than the block, so this is for a dedicated run rather than every one.
+    bool checkHashes = false;
+};
+
+struct Divergence {
+    bool found = false;
+    long long instruction = 0; // instructions both engines completed identically
+    int frame = 0;
+    std::string difference; // the first thing that differs, reference value first
+    std::vector<std::pair<uint16_t, uint16_t>> trace; // PC and opcode of the last instructions, the divergent one last
+};
+
+// Runs a reference and a candidate engine side by side on two machines prepared the same way and compares their
+// whole state after every block. A divergence found between blocks is narrowed down to the instruction by running
+// again from the start one instruction at a time, so setup and input have to be deterministic.
+class LockstepRunner {
+public:
+    using Setup = std::function<void(Chip8& cpu)>; // loads the program, picks the profile and seeds the RNG
+    // Sets the keys and answers FX0A, called before each block
+    using Input = std::function<void(Chip8& cpu, int frame)>;
+
+    LockstepRunner(Engine reference, Engine candidate) : reference(std::move(reference)),
+        candidate(std::move(candidate)) {}
+    Divergence run(const Setup& setup, const Input& input, const LockstepOptions& options) const;
+
+    // The first difference between two machines, "" if there is none
+    static std::string compare(const Chip8& expected, const Chip8& actual);
+    static std::string compare(const RunResult& expected, const RunResult& actual);
+    static std::string compareHashes(const Chip8& expected, const Chip8& actual); // after compare() found nothing
+    static std::string describe(const Divergence& divergence);
+
+private:
+    Divergence runBlocks(const Setup& setup, const Input& input, const LockstepOptions& options) const;
+    Engine reference;
+    Engine candidate;
+};
+
+// A random program of the given number of instructions from every instruction set, so some fault as unknown opcodes
+// under the other profiles. Jumps and calls stay inside the program and BNNN lands in the memory after it, which
+// loadProgram() fills with jumps back in. I only ever points below the code, so stores never rewrite it, and
+// FX1E and 00FD are left out: one could move I onto the code, the other would end most programs early.
+std::vector<uint8_t> randomProgram(std::mt19937& rng, int instructions);
+// Resets cpu and loads a program from randomProgram() at PROGRAM_OFFSET, filling the rest of memory as it expects
+void loadProgram(Chip8& cpu, const std::vector<uint8_t>& program);
+
+#endif //CHIP8_LOCKSTEP_H
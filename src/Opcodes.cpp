@@ -0,0 +1,108 @@
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include "Opcodes.h"
+
+const OpcodeInfo OPCODE_TABLE[] = {
+    {0xFFFF, 0x00E0, "00E0 CLS", "CLS", Flow::Next, 2},
+    {0xFFFF, 0x00EE, "00EE RET", "RET", Flow::Return, 2},
+    {0xFFF0, 0x00C0, "00CN SCD", "SCD {n}", Flow::Next, 2},
+    {0xFFF0, 0x00D0, "00DN SCU", "SCU {n}", Flow::Next, 2},
+    {0xFFFF, 0x00FB, "00FB SCR", "SCR", Flow::Next, 2},
+    {0xFFFF, 0x00FC, "00FC SCL", "SCL", Flow::Next, 2},
+    {0xFFFF, 0x00FD, "00FD EXIT", "EXIT", Flow::Exit, 2},
+    {0xFFFF, 0x00FE, "00FE LOW", "LOW", Flow::Next, 2},
+    {0xFFFF, 0x00FF, "00FF HIGH", "HIGH", Flow::Next, 2},
+    {0xF000, 0x0000, "0NNN SYS", "SYS {nnn}", Flow::Next, 2},
+    {0xF000, 0x1000, "1NNN JP", "JP {nnn}", Flow::Jump, 2},
+    {0xF000, 0x2000, "2NNN CALL", "CALL {nnn}", Flow::Call, 2},
+    {0xF000, 0x3000, "3XNN SE", "SE V{x}, {nn}", Flow::Skip, 2},
+    {0xF000, 0x4000, "4XNN SNE", "SNE V{x}, {nn}", Flow::Skip, 2},
+    {0xF00F, 0x5000, "5XY0 SE", "SE V{x}, V{y}", Flow::Skip, 2},
+    {0xF00F, 0x5002, "5XY2 SAVE", "SAVE V{x}-V{y}", Flow::Next, 2},
+    {0xF00F, 0x5003, "5XY3 LOAD", "LOAD V{x}-V{y}", Flow::Next, 2},
+    {0xF000, 0x6000, "6XNN LD", "LD V{x}, {nn}", Flow::Next, 2},
+    {0xF000, 0x7000, "7XNN ADD", "ADD V{x}, {nn}", Flow::Next, 2},
+    {0xF00F, 0x8000, "8XY0 LD", "LD V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8001, "8XY1 OR", "OR V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8002, "8XY2 AND", "AND V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8003, "8XY3 XOR", "XOR V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8004, "8XY4 ADD", "ADD V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8005, "8XY5 SUB", "SUB V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8006, "8XY6 SHR", "SHR V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x8007, "8XY7 SUBN", "SUBN V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x800E, "8XYE SHL", "SHL V{x}, V{y}", Flow::Next, 2},
+    {0xF00F, 0x9000, "9XY0 SNE", "SNE V{x}, V{y}", Flow::Skip, 2},
+    {0xF000, 0xA000, "ANNN LD I", "LD I, {nnn}", Flow::Next, 2},
+    {0xF000, 0xB000, "BNNN JP V0", "JP V0, {nnn}", Flow::IndirectJump, 2},
+    {0xF000, 0xC000, "CXNN RND", "RND V{x}, {nn}", Flow::Next, 2},
+    {0xF000, 0xD000, "DXYN DRW", "DRW V{x}, V{y}, {n}", Flow::Next, 2},
+    {0xF0FF, 0xE09E, "EX9E SKP", "SKP V{x}", Flow::Skip, 2},
+    {0xF0FF, 0xE0A1, "EXA1 SKNP", "SKNP V{x}", Flow::Skip, 2},
+    {0xFFFF, 0xF000, "F000 LD I LONG", "LD I, {long}", Flow::Next, 4},
+    {0xF0FF, 0xF001, "FN01 PLANE", "PLANE {x}", Flow::Next, 2},
+    {0xFFFF, 0xF002, "F002 AUDIO", "AUDIO", Flow::Next, 2},
+    {0xF0FF, 0xF007, "FX07 LD DT", "LD V{x}, DT", Flow::Next, 2},
+    {0xF0FF, 0xF00A, "FX0A LD K", "LD V{x}, K", Flow::Next, 2},
+    {0xF0FF, 0xF015, "FX15 LD DT", "LD DT, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF018, "FX18 LD ST", "LD ST, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF01E, "FX1E ADD I", "ADD I, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF029, "FX29 LD F", "LD F, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF030, "FX30 LD HF", "LD HF, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF033, "FX33 BCD", "LD B, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF03A, "FX3A PITCH", "PITCH V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF055, "FX55 LD [I]", "LD [I], V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF065, "FX65 LD Vx", "LD V{x}, [I]", Flow::Next, 2},
+    {0xF0FF, 0xF075, "FX75 LD R", "LD R, V{x}", Flow::Next, 2},
+    {0xF0FF, 0xF085, "FX85 LD Vx R", "LD V{x}, R", Flow::Next, 2},
+    {0x0000, 0x0000, "unknown", "DW {opcode}", Flow::Invalid, 2},
+};
+const int OPCODE_TABLE_SIZE = sizeof(OPCODE_TABLE) / sizeof(OPCODE_TABLE[0]);
+
+int opcodeIndex(uint16_t opcode) {
+    // Built on first use from the ordered table, so the table stays the single definition
+    static const auto lookup = [] {
+        auto table = std::make_unique<std::array<uint8_t, 0x10000>>();
+        for (int op = 0; op < 0x10000; op++) {
+            int n = 0;
+            while ((op & OPCODE_TABLE[n].mask) != OPCODE_TABLE[n].value) {
+                n++;
+            }
+            (*table)[op] = uint8_t(n);
+        }
+        return table;
+    }();
+    return (*lookup)[opcode];
+}
+
+std::string formatInstruction(uint16_t opcode, uint16_t next) {
+    std::string text;
+    char field[8];
+    for (const char* c = decodeOpcode(opcode).syntax; *c != '\0'; c++) {
+        if (*c != '{') {
+            text += *c;
+            continue;
+        }
+        const char* end = std::strchr(c, '}');
+        std::string name(c + 1, end);
+        if (name == "x") {
+            std::snprintf(field, sizeof(field), "%X", (opcode >> 8) & 0xF);
+        } else if (name == "y") {
+            std::snprintf(field, sizeof(field), "%X", (opcode >> 4) & 0xF);
+        } else if (name == "n") {
+            std::snprintf(field, sizeof(field), "%d", opcode & 0xF);
+        } else if (name == "nn") {
+            std::snprintf(field, sizeof(field), "0x%02X", opcode & 0xFF);
+        } else if (name == "nnn") {
+            std::snprintf(field, sizeof(field), "0x%03X", opcode & 0xFFF);
+        } else if (name == "long") {
+            std::snprintf(field, sizeof(field), "0x%04X", next);
+        } else { // opcode
+            std::snprintf(field, sizeof(field), "0x%04X", opcode);
+        }
+        text += field;
+        c = end;
+    }
+    return text;
+}
@@ -0,0 +1,41 @@
+#ifndef CHIP8_OPCODES_H
+#define CHIP8_OPCODES_H
+
+#include <cstdint>
+#include <string>
+
+// How an instruction affects the PC, for control-flow analysis
+enum class Flow : uint8_t {
+    Next, // carries on with the following instruction
+    Jump, // 1NNN
+    Call, // 2NNN
+    Return, // 00EE
+    Skip, // may skip the following instruction
+    IndirectJump, // BNNN, the target depends on a register
+    Exit, // 00FD
+    Invalid, // not an instruction
+};
+
+struct OpcodeInfo {
+    uint16_t mask;
+    uint16_t value; // opcode & mask == value
+    const char* name; // pattern and short mnemonic, one per opcode class in profiles
+    // Assembly with {x} {y} {n} {nn} {nnn} standing for the opcode fields, {long} for F000's second word
+    // and {opcode} for the whole opcode
+    const char* syntax;
+    Flow flow;
+    uint8_t length; // bytes, F000 NNNN is the only 4 byte instruction
+};
+
+// Every CHIP-8, SCHIP and XO-CHIP instruction, checked in order with the first match winning. The last entry
+// matches anything and stands for unknown opcodes.
+extern const OpcodeInfo OPCODE_TABLE[];
+extern const int OPCODE_TABLE_SIZE;
+
+// Index of opcode's entry in OPCODE_TABLE, a table lookup
+int opcodeIndex(uint16_t opcode);
+inline const OpcodeInfo& decodeOpcode(uint16_t opcode) {return OPCODE_TABLE[opcodeIndex(opcode)];}
+// Formats an instruction using its syntax, next is the word after it (only used by F000 NNNN)
+std::string formatInstruction(uint16_t opcode, uint16_t next = 0);
+
+#endif //CHIP8_OPCODES_H
@@ -0,0 +1,33 @@
+#ifndef CHIP8_OPTIONS_H
+#define CHIP8_OPTIONS_H
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+// Parses a whole decimal number that fits in T, false for anything else: an empty string, a sign, spaces or other
+// characters around the digits. Unlike std::stoi, it doesn't throw, so command line options can print a usage error.
+template <typename T>
+bool parseNumber(const std::string& text, T& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    T parsed = 0;
+    for (char c : text) {
+        T digit = T(c - '0');
+        if (parsed > (std::numeric_limits<T>::max() - digit) / 10) {
+            return false;
+        }
+        parsed = T(parsed * 10 + digit);
+    }
+    value = parsed;
+    return true;
+}
+
+// For the tools' main(): reports an option whose value parseNumber() rejected and returns the exit code
+inline int notANumber(const std::string& option) {
+    std::cerr << "Not a number: " << option << ", see --help" << std::endl;
+    return 1;
+}
+
+#endif //CHIP8_OPTIONS_H
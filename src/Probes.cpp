@@ -0,0 +1,463 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include "Probes.h"
+
+namespace {
+
+struct CompileError {
+    std::string message;
+};
+
+struct BinaryOperator {
+    const char* symbol;
+    int precedence; // higher binds tighter
+};
+
+constexpr int MAX_NESTING = 256; // parentheses and unary operators, which the parser recurses into
+
+constexpr const char* RESERVED[] = {"mem", "v", "bcd", "min", "max", "abs", "i", "pc", "sp", "dt", "st", "running",
+                                    "hires"};
+
+constexpr BinaryOperator BINARY_OPERATORS[] = {
+    {"||", 1}, {"&&", 2}, {"|", 3}, {"^", 4}, {"&", 5}, {"==", 6}, {"!=", 6}, {"<", 7}, {"<=", 7}, {">", 7},
+    {">=", 7}, {"<<", 8}, {">>", 8}, {"+", 9}, {"-", 9}, {"*", 10}, {"/", 10}, {"%", 10},
+};
+
+// Longest first, so that "<=" isn't read as "<" then "="
+constexpr const char* SYMBOLS[] = {
+    "||", "&&", "==", "!=", "<=", ">=", "<<", ">>", "..",
+    "|", "^", "&", "<", ">", "+", "-", "*", "/", "%", "!", "~", "=", "(", ")", "[", "]", ",", ";",
+};
+
+inline int64_t binary(ProbeOp op, int64_t a, int64_t b) {
+    using Op = ProbeOp;
+    // Unsigned arithmetic wraps rather than overflowing
+    auto ua = uint64_t(a);
+    auto ub = uint64_t(b);
+    switch (op) {
+    case Op::Add: return int64_t(ua + ub);
+    case Op::Subtract: return int64_t(ua - ub);
+    case Op::Multiply: return int64_t(ua * ub);
+    case Op::Divide: return b == 0 ? 0 : b == -1 ? int64_t(0 - ua) : a / b;
+    case Op::Modulo: return b == 0 || b == -1 ? 0 : a % b;
+    case Op::ShiftLeft: return int64_t(ua << (ub & 63));
+    case Op::ShiftRight: return a >> (ub & 63);
+    case Op::And: return a & b;
+    case Op::Xor: return a ^ b;
+    case Op::Or: return a | b;
+    case Op::Equal: return a == b;
+    case Op::NotEqual: return a != b;
+    case Op::Less: return a < b;
+    case Op::LessEqual: return a <= b;
+    case Op::Greater: return a > b;
+    case Op::GreaterEqual: return a >= b;
+    case Op::LogicalAnd: return a != 0 && b != 0;
+    case Op::LogicalOr: return a != 0 || b != 0;
+    case Op::Min: return std::min(a, b);
+    case Op::Max: return std::max(a, b);
+    default: return 0;
+    }
+}
+
+} // namespace
+
+// Recursive descent straight to ProbeProgram's code, one token of lookahead
+class ProbeCompiler {
+public:
+    using Op = ProbeProgram::Op;
+
+    ProbeCompiler(const std::string& source, ProbeProgram& program) : source(source), program(program) {}
+
+    void compile() {
+        next();
+        while (kind != Kind::End) {
+            if (kind == Kind::Name) {
+                statement();
+            } else if (kind != Kind::Newline && !isSymbol(";")) {
+                fail("expected name = expression");
+            }
+            if (kind != Kind::End && kind != Kind::Newline && !isSymbol(";")) {
+                fail("expected the end of the statement");
+            }
+            if (kind != Kind::End) {
+                next();
+            }
+        }
+    }
+
+private:
+    enum class Kind {End, Newline, Number, Name, Symbol};
+
+    void statement() {
+        std::string name = text;
+        for (const char* reserved : RESERVED) {
+            if (name == reserved) {
+                fail(name + " can't be assigned");
+            }
+        }
+        next();
+        expect("=");
+        expression(0);
+        if (program.find(name) == -1) {
+            program.names.push_back(name);
+        }
+        emit(Op::Store, program.find(name));
+    }
+
+    // Precedence climbing: parses operators that bind tighter than minimum
+    void expression(int minimum) {
+        unary();
+        while (kind == Kind::Symbol) {
+            const BinaryOperator* found = nullptr;
+            for (const BinaryOperator& candidate : BINARY_OPERATORS) {
+                if (text == candidate.symbol) {
+                    found = &candidate;
+                }
+            }
+            if (found == nullptr || found->precedence <= minimum) {
+                return;
+            }
+            std::string symbol = text;
+            next();
+            expression(found->precedence);
+            emitBinary(binaryOp(symbol));
+        }
+    }
+
+    static Op binaryOp(const std::string& symbol) {
+        static const std::pair<const char*, Op> OPS[] = {
+            {"||", Op::LogicalOr}, {"&&", Op::LogicalAnd}, {"|", Op::Or}, {"^", Op::Xor}, {"&", Op::And},
+            {"==", Op::Equal}, {"!=", Op::NotEqual}, {"<", Op::Less}, {"<=", Op::LessEqual}, {">", Op::Greater},
+            {">=", Op::GreaterEqual}, {"<<", Op::ShiftLeft}, {">>", Op::ShiftRight}, {"+", Op::Add},
+            {"-", Op::Subtract}, {"*", Op::Multiply}, {"/", Op::Divide}, {"%", Op::Modulo},
+        };
+        for (const auto& op : OPS) {
+            if (symbol == op.first) {
+                return op.second;
+            }
+        }
+        return Op::Add; // unreachable, BINARY_OPERATORS and OPS hold the same symbols
+    }
+
+    void unary() {
+        if (++nesting > MAX_NESTING) {
+            fail("the expression nests too deeply");
+        }
+        if (isSymbol("-") || isSymbol("!") || isSymbol("~")) {
+            Op op = isSymbol("-") ? Op::Negate : isSymbol("!") ? Op::Not : Op::Complement;
+            next();
+            unary();
+            emit(op);
+        } else {
+            primary();
+        }
+        nesting--;
+    }
+
+    void primary() {
+        if (kind == Kind::Number) {
+            emit(Op::Constant, value);
+            next();
+            return;
+        }
+        if (isSymbol("(")) {
+            next();
+            expression(0);
+            expect(")");
+            return;
+        }
+        if (kind != Kind::Name) {
+            fail("expected a value");
+        }
+        std::string name = text;
+        next();
+        if (name == "mem") {
+            memory();
+        } else if (name == "v") {
+            expect("[");
+            expression(0);
+            expect("]");
+            if (!foldConstant(Op::Register, NUMBER_OF_REGISTERS)) {
+                emit(Op::RegisterAt);
+            }
+        } else if (name == "bcd") {
+            expect("(");
+            if (kind != Kind::Name || text != "mem") {
+                fail("bcd() takes mem[a..b]");
+            }
+            next();
+            memory();
+            expect(")");
+            // A single byte is its own digit
+            if (program.code.back().op == Op::MemoryRange) {
+                program.code.back().op = Op::MemoryDigits;
+            } else if (program.code.back().op != Op::Memory) {
+                fail("bcd() takes mem[a..b]");
+            }
+        } else if (name == "min" || name == "max") {
+            expect("(");
+            expression(0);
+            expect(",");
+            expression(0);
+            expect(")");
+            emitBinary(name == "min" ? Op::Min : Op::Max);
+        } else if (name == "abs") {
+            expect("(");
+            expression(0);
+            expect(")");
+            emit(Op::Abs);
+        } else if (name == "i" || name == "pc" || name == "sp" || name == "dt" || name == "st" ||
+                   name == "running" || name == "hires") {
+            static const std::pair<const char*, Op> MACHINE[] = {
+                {"i", Op::I}, {"pc", Op::Pc}, {"sp", Op::Sp}, {"dt", Op::DelayTimer}, {"st", Op::SoundTimer},
+                {"running", Op::Running}, {"hires", Op::Hires},
+            };
+            for (const auto& field : MACHINE) {
+                if (name == field.first) {
+                    emit(field.second);
+                }
+            }
+        } else if (program.find(name) != -1) {
+            emit(Op::Load, program.find(name));
+        } else {
+            fail(name + " isn't assigned before this");
+        }
+    }
+
+    // After "mem": [address] or [first..last], the bounds of a range being constants
+    void memory() {
+        expect("[");
+        expression(0);
+        if (isSymbol("..")) {
+            int64_t first = takeConstant();
+            next();
+            expression(0);
+            int64_t last = takeConstant();
+            if (first < 0 || last < first || last - first >= PROBE_RANGE_BYTES || last >= XO_MEMORY_SIZE) {
+                fail("mem[a..b] has to be 1 to " + std::to_string(PROBE_RANGE_BYTES) + " bytes in memory");
+            }
+            emit(Op::MemoryRange, first | (last - first + 1) << 16);
+        } else if (!foldConstant(Op::Memory, XO_MEMORY_SIZE)) {
+            emit(Op::MemoryAt);
+        }
+        expect("]");
+    }
+
+    // Turns a constant just emitted into op with it as the operand, if it's in [0, limit)
+    bool foldConstant(Op op, int64_t limit) {
+        Instruction& last = program.code.back();
+        if (last.op != Op::Constant || last.operand < 0 || last.operand >= limit) {
+            return false;
+        }
+        last.op = op;
+        return true;
+    }
+
+    int64_t takeConstant() {
+        if (program.code.back().op != Op::Constant) {
+            fail("the bounds of mem[a..b] have to be numbers");
+        }
+        int64_t constant = program.code.back().operand;
+        program.code.pop_back();
+        depth--;
+        return constant;
+    }
+
+    // A right operand that's a constant becomes the immediate operand, and so does the result if both are
+    void emitBinary(Op op) {
+        if (program.code.back().op != Op::Constant) {
+            emit(op);
+            return;
+        }
+        int64_t right = takeConstant();
+        if (program.code.back().op == Op::Constant) {
+            program.code.back().operand = binary(op, program.code.back().operand, right);
+        } else {
+            program.code.push_back({op, true, right});
+        }
+    }
+
+    void emit(Op op, int64_t operand = 0) {
+        switch (op) {
+        case Op::Constant: case Op::Load: case Op::Register: case Op::Memory: case Op::MemoryRange:
+        case Op::MemoryDigits: case Op::I: case Op::Pc: case Op::Sp: case Op::DelayTimer: case Op::SoundTimer:
+        case Op::Running: case Op::Hires:
+            depth++;
+            break;
+        case Op::RegisterAt: case Op::MemoryAt: case Op::Negate: case Op::Not: case Op::Complement: case Op::Abs:
+            break;
+        default: // Store and the binary operators
+            depth--;
+            break;
+        }
+        if (depth > PROBE_STACK_SIZE) {
+            fail("the expression nests too deeply");
+        }
+        program.code.push_back({op, false, operand});
+    }
+
+    void expect(const char* symbol) {
+        if (!isSymbol(symbol)) {
+            fail(std::string("expected ") + symbol);
+        }
+        next();
+    }
+
+    bool isSymbol(const char* symbol) const {
+        return kind == Kind::Symbol && text == symbol;
+    }
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw CompileError {"line " + std::to_string(line) + ", column " + std::to_string(column) + ": " +
+                            message};
+    }
+
+    void next() {
+        while (position < source.size()) {
+            char c = source[position];
+            if (c == '#') {
+                while (position < source.size() && source[position] != '\n') {
+                    position++;
+                }
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                position++;
+            } else {
+                break;
+            }
+        }
+        line = currentLine;
+        column = int(position - lineStart) + 1;
+        if (position >= source.size()) {
+            kind = Kind::End;
+            return;
+        }
+        char c = source[position];
+        if (c == '\n') {
+            kind = Kind::Newline;
+            position++;
+            currentLine++;
+            lineStart = position;
+            return;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            size_t end = position;
+            while (end < source.size() && std::isalnum(static_cast<unsigned char>(source[end]))) {
+                end++;
+            }
+            text = source.substr(position, end - position);
+            char* parsed = nullptr;
+            value = int64_t(std::strtoull(text.c_str(), &parsed, 0));
+            if (*parsed != '\0') {
+                fail("bad number " + text);
+            }
+            kind = Kind::Number;
+            position = end;
+            return;
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t end = position;
+            while (end < source.size() && (std::isalnum(static_cast<unsigned char>(source[end])) ||
+                                           source[end] == '_')) {
+                end++;
+            }
+            text = source.substr(position, end - position);
+            kind = Kind::Name;
+            position = end;
+            return;
+        }
+        for (const char* symbol : SYMBOLS) {
+            if (source.compare(position, std::char_traits<char>::length(symbol), symbol) == 0) {
+                text = symbol;
+                kind = Kind::Symbol;
+                position += text.size();
+                return;
+            }
+        }
+        fail(std::string("unexpected ") + c);
+    }
+
+    using Instruction = ProbeProgram::Instruction;
+    const std::string& source;
+    ProbeProgram& program;
+    size_t position = 0;
+    size_t lineStart = 0;
+    int currentLine = 1;
+    int depth = 0; // of the stack at run time
+    int nesting = 0;
+    // The current token
+    Kind kind = Kind::End;
+    std::string text;
+    int64_t value = 0;
+    int line = 1;
+    int column = 1;
+};
+
+std::string ProbeProgram::compile(const std::string& source) {
+    code.clear();
+    names.clear();
+    try {
+        ProbeCompiler(source, *this).compile();
+    } catch (const CompileError& error) {
+        code.clear();
+        names.clear();
+        return error.message;
+    }
+    return "";
+}
+
+int ProbeProgram::find(const std::string& name) const {
+    for (size_t n = 0; n < names.size(); n++) {
+        if (names[n] == name) {
+            return int(n);
+        }
+    }
+    return -1;
+}
+
+
+void ProbeProgram::evaluate(const Chip8& cpu, int64_t* values) const {
+    int64_t stack[PROBE_STACK_SIZE];
+    int top = -1;
+    const uint8_t* memory = cpu.memory();
+    const int mask = cpu.memorySize() - 1;
+    for (const Instruction& instruction : code) {
+        const int64_t operand = instruction.operand;
+        switch (instruction.op) {
+        case Op::Constant: stack[++top] = operand; break;
+        case Op::Load: stack[++top] = values[operand]; break;
+        case Op::Store: values[operand] = stack[top--]; break;
+        case Op::Register: stack[++top] = cpu.state.v[operand]; break;
+        case Op::RegisterAt: stack[top] = cpu.state.v[stack[top] & (NUMBER_OF_REGISTERS - 1)]; break;
+        case Op::Memory: stack[++top] = memory[operand & mask]; break;
+        case Op::MemoryAt: stack[top] = memory[stack[top] & mask]; break;
+        case Op::MemoryRange:
+        case Op::MemoryDigits: {
+            const uint64_t base = instruction.op == Op::MemoryDigits ? 10 : 256;
+            const int address = int(operand & 0xFFFF);
+            uint64_t number = 0;
+            for (int n = 0; n < int(operand >> 16); n++) {
+                number = number * base + memory[(address + n) & mask];
+            }
+            stack[++top] = int64_t(number);
+            break;
+        }
+        case Op::I: stack[++top] = cpu.state.i; break;
+        case Op::Pc: stack[++top] = cpu.state.pc; break;
+        case Op::Sp: stack[++top] = cpu.state.sp; break;
+        case Op::DelayTimer: stack[++top] = cpu.state.delayTimer; break;
+        case Op::SoundTimer: stack[++top] = cpu.state.soundTimer; break;
+        case Op::Running: stack[++top] = cpu.state.running; break;
+        case Op::Hires: stack[++top] = cpu.state.hires; break;
+        case Op::Negate: stack[top] = int64_t(0 - uint64_t(stack[top])); break;
+        case Op::Not: stack[top] = stack[top] == 0; break;
+        case Op::Complement: stack[top] = ~stack[top]; break;
+        case Op::Abs: stack[top] = stack[top] < 0 ? int64_t(0 - uint64_t(stack[top])) : stack[top]; break;
+        default: { // the binary operators
+            int64_t right = instruction.immediate ? operand : stack[top--];
+            stack[top] = binary(instruction.op, stack[top], right);
+            break;
+        }
+        }
+    }
+}
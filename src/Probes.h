@@ -0,0 +1,63 @@
+#ifndef CHIP8_PROBES_H
+#define CHIP8_PROBES_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+constexpr int PROBE_STACK_SIZE = 32; // the deepest an expression can nest
+constexpr int PROBE_RANGE_BYTES = 8; // the longest mem[a..b]
+
+// The instructions of the stack machine probe programs compile to
+enum class ProbeOp : uint8_t {
+    Constant, Load, Store,
+    Register, RegisterAt, Memory, MemoryAt, MemoryRange, MemoryDigits,
+    I, Pc, Sp, DelayTimer, SoundTimer, Running, Hires,
+    Negate, Not, Complement, Abs,
+    // The binary operators, from here on
+    Add, Subtract, Multiply, Divide, Modulo, ShiftLeft, ShiftRight, And, Xor, Or,
+    Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, LogicalAnd, LogicalOr, Min, Max,
+};
+
+struct ProbeInstruction {
+    ProbeOp op;
+    bool immediate; // a binary operator whose right operand is operand, a constant, rather than on the stack
+    int64_t operand; // the constant, variable, register or address, with the length above bit 16 for ranges
+};
+
+// Watches on guest memory and registers, written as assignments, one per line or separated by semicolons:
+//
+//     score = bcd(mem[0x2F0..0x2F2])   # FX33's digits, most significant first
+//     lives = mem[0x2F8]
+//     done = v[0xE] == 0 || lives == 0
+//
+// Expressions are 64 bit integers with C's operators and precedence, comparisons and logic giving 0 or 1, and
+// division by zero giving 0. mem[x] is a byte, mem[a..b] the big endian number in bytes a to b, bcd(mem[a..b]) the
+// decimal number with a digit per byte. Addresses wrap at the end of memory. v[x] is a register, and i, pc, sp, dt,
+// st, running and hires the rest of the machine. min(a, b), max(a, b) and abs(a) are there too. A name can be used
+// once it has been assigned, earlier in the program.
+//
+// compile() turns the source into code for a small stack machine, folding constants into the instructions that use
+// them, so evaluate() is one pass over a short array of instructions that doesn't allocate, cheap enough to run
+// after every frame.
+class ProbeProgram {
+public:
+    // Replaces the program with the compiled source. Returns why it doesn't compile, or an empty string.
+    std::string compile(const std::string& source);
+    bool empty() const {return code.empty();}
+    int variables() const {return int(names.size());}
+    int find(const std::string& name) const; // the variable's index, or -1 if the program never assigns it
+    const std::string& name(int variable) const {return names[size_t(variable)];}
+    // Runs the program on the machine, leaving each variable in values[index]
+    void evaluate(const Chip8& cpu, int64_t* values) const;
+
+private:
+    using Op = ProbeOp;
+    using Instruction = ProbeInstruction;
+    friend class ProbeCompiler;
+    std::vector<Instruction> code;
+    std::vector<std::string> names;
+};
+
+#endif //CHIP8_PROBES_H
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "Opcodes.h"
+#include "Profiler.h"
+
+namespace {
+
+std::string hexAddress(uint16_t address) {
+    std::stringstream name;
+    name << "0x" << std::hex << std::setw(3) << std::setfill('0') << address;
+    return name.str();
+}
+
+} // namespace
+
+Profiler::Profiler() : opcodeCounts(0x10000), pcCounts(PROFILER_ADDRESSES) {
+    reset();
+}
+
+void Profiler::reset() {
+    std::fill(opcodeCounts.begin(), opcodeCounts.end(), 0);
+    std::fill(pcCounts.begin(), pcCounts.end(), 0);
+    drawTime = std::chrono::nanoseconds::zero();
+    frames.clear();
+    children.clear();
+    frames.push_back({0x200, 0, 0}); // PROGRAM_OFFSET
+    currentFrame = 0;
+}
+
+void Profiler::call(uint16_t address) {
+    uint64_t key = uint64_t(currentFrame) << 16 | address;
+    auto child = children.find(key);
+    if (child == children.end()) {
+        uint32_t frame = uint32_t(frames.size());
+        frames.push_back({address, currentFrame, 0});
+        child = children.emplace(key, frame).first;
+    }
+    currentFrame = child->second;
+}
+
+void Profiler::ret() {
+    currentFrame = frames[currentFrame].parent; // the root is its own parent, so unbalanced returns stay there
+}
+
+std::string Profiler::stackName(uint32_t frame) const {
+    std::string name = hexAddress(frames[frame].address);
+    while (frame != 0) {
+        frame = frames[frame].parent;
+        name.insert(0, hexAddress(frames[frame].address) + ";");
+    }
+    return name;
+}
+
+void Profiler::writeReport(std::ostream& out) const {
+    uint64_t total = 0;
+    std::vector<uint64_t> classCounts(OPCODE_TABLE_SIZE);
+    for (int opcode = 0; opcode < int(opcodeCounts.size()); opcode++) {
+        classCounts[opcodeIndex(uint16_t(opcode))] += opcodeCounts[opcode];
+        total += opcodeCounts[opcode];
+    }
+    auto percent = [total](uint64_t count) {return total == 0 ? 0.0 : 100.0 * double(count) / double(total);};
+
+    uint64_t draws = classCounts[opcodeIndex(0xD000)];
+    out << "Instructions executed: " << total << "\n";
+    out << "Time in DXYN: " << std::chrono::duration<double, std::milli>(drawTime).count() << " ms";
+    if (draws != 0) {
+        out << " (" << drawTime.count() / int64_t(draws) << " ns per draw)";
+    }
+    out << "\n\nOpcode classes:\n";
+    std::vector<int> classOrder;
+    for (int n = 0; n < OPCODE_TABLE_SIZE; n++) {
+        if (classCounts[n] != 0) {
+            classOrder.push_back(n);
+        }
+    }
+    std::sort(classOrder.begin(), classOrder.end(), [&](int a, int b) {return classCounts[a] > classCounts[b];});
+    out << std::fixed << std::setprecision(2);
+    for (int n : classOrder) {
+        out << std::setw(14) << classCounts[n] << std::setw(8) << percent(classCounts[n]) << "%  "
+            << OPCODE_TABLE[n].name << "\n";
+    }
+
+    out << "\nHot PCs:\n";
+    std::vector<int> pcOrder;
+    for (int pc = 0; pc < PROFILER_ADDRESSES; pc++) {
+        if (pcCounts[pc] != 0) {
+            pcOrder.push_back(pc);
+        }
+    }
+    std::sort(pcOrder.begin(), pcOrder.end(), [&](int a, int b) {return pcCounts[a] > pcCounts[b];});
+    if (pcOrder.size() > PROFILER_HOT_PCS) {
+        pcOrder.resize(PROFILER_HOT_PCS);
+    }
+    for (int pc : pcOrder) {
+        out << std::setw(14) << pcCounts[pc] << std::setw(8) << percent(pcCounts[pc]) << "%  "
+            << hexAddress(uint16_t(pc)) << "\n";
+    }
+}
+
+void Profiler::writeFoldedStacks(std::ostream& out) const {
+    for (uint32_t frame = 0; frame < frames.size(); frame++) {
+        if (frames[frame].samples != 0) {
+            out << stackName(frame) << " " << frames[frame].samples << "\n";
+        }
+    }
+}
+
+void Profiler::dump(const std::string& reportFilename, const std::string& foldedFilename) const {
+    std::ofstream report(reportFilename);
+    writeReport(report);
+    std::ofstream folded(foldedFilename);
+    writeFoldedStacks(folded);
+    std::cerr << "Wrote profile to " << reportFilename << " and " << foldedFilename << std::endl;
+}
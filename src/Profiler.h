@@ -0,0 +1,64 @@
+#ifndef CHIP8_PROFILER_H
+#define CHIP8_PROFILER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Profiling hooks are compiled out unless YACHIE_PROFILE is defined (cmake -DYACHIE_PROFILE=ON)
+#ifdef YACHIE_PROFILE
+#define PROFILE(statement) statement
+#else
+#define PROFILE(statement)
+#endif
+
+constexpr int PROFILER_ADDRESSES = 0x10000; // enough for XO-CHIP
+constexpr int PROFILER_HOT_PCS = 32; // number of PCs listed in the report
+
+// Counts executions per opcode and per PC, the time spent drawing sprites and samples per call stack
+class Profiler {
+public:
+    // Adds the time between construction and destruction to a counter
+    class Timer {
+    public:
+        explicit Timer(std::chrono::nanoseconds& total) : total(total), start(std::chrono::steady_clock::now()) {}
+        ~Timer() {total += std::chrono::steady_clock::now() - start;}
+    private:
+        std::chrono::nanoseconds& total;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    Profiler();
+    void reset();
+    inline void instruction(uint16_t pc, uint16_t opcode) {
+        opcodeCounts[opcode]++;
+        pcCounts[pc % PROFILER_ADDRESSES]++;
+        frames[currentFrame].samples++;
+    }
+    void call(uint16_t address);
+    void ret();
+    void writeReport(std::ostream& out) const;
+    // One "frame;frame;frame samples" line per stack, for flamegraph.pl
+    void writeFoldedStacks(std::ostream& out) const;
+    void dump(const std::string& reportFilename, const std::string& foldedFilename) const;
+    std::chrono::nanoseconds drawTime;
+
+private:
+    struct Frame {
+        uint16_t address;
+        uint32_t parent;
+        uint64_t samples;
+    };
+    std::string stackName(uint32_t frame) const;
+    std::vector<uint64_t> opcodeCounts; // indexed by opcode, heap allocated since Chip8 usually lives on the stack
+    std::vector<uint64_t> pcCounts;
+    std::vector<Frame> frames; // call tree, frames[0] is the program entry point
+    std::unordered_map<uint64_t, uint32_t> children; // (parent << 16 | address) -> frame
+    uint32_t currentFrame;
+};
+
+#endif //CHIP8_PROFILER_H
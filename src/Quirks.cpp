@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cctype>
+#include "Quirks.h"
+
+namespace {
+
+struct ProfileName {
+    QuirkProfile profile;
+    const char* name;
+};
+
+constexpr ProfileName PROFILE_NAMES[] = {
+    {QuirkProfile::Yachie, "yachie"},
+    {QuirkProfile::CosmacVip, "vip"},
+    {QuirkProfile::Chip48, "chip48"},
+    {QuirkProfile::SuperChip, "schip"},
+    {QuirkProfile::XoChip, "xochip"},
+};
+
+struct ExtensionProfile {
+    const char* extension;
+    QuirkProfile profile;
+};
+
+constexpr ExtensionProfile EXTENSION_PROFILES[] = {
+    {".sc8", QuirkProfile::SuperChip},
+    {".xo8", QuirkProfile::XoChip},
+};
+
+} // namespace
+
+bool parseQuirkProfile(const std::string& name, QuirkProfile& profile) {
+    for (const auto& profileName : PROFILE_NAMES) {
+        if (name == profileName.name) {
+            profile = profileName.profile;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* quirkProfileName(QuirkProfile profile) {
+    for (const auto& profileName : PROFILE_NAMES) {
+        if (profile == profileName.profile) {
+            return profileName.name;
+        }
+    }
+    return "unknown";
+}
+
+QuirkProfile quirkProfileForRom(const std::string& filename) {
+    size_t dot = filename.find_last_of("./\\");
+    if (dot == std::string::npos || filename[dot] != '.') {
+        return QuirkProfile::Yachie;
+    }
+    std::string extension = filename.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return char(std::tolower(c));
+    });
+    for (const auto& extensionProfile : EXTENSION_PROFILES) {
+        if (extension == extensionProfile.extension) {
+            return extensionProfile.profile;
+        }
+    }
+    return QuirkProfile::Yachie;
+}
@@ -0,0 +1,91 @@
+#ifndef CHIP8_QUIRKS_H
+#define CHIP8_QUIRKS_H
+
+#include <cstdint>
+#include <string>
+
+// Interpretations of the opcodes that CHIP-8 implementations disagree on. Each profile is a set of compile time
+// constants that Chip8::execute() is specialized on, so choosing one costs a single switch per Chip8::run() call.
+
+enum class QuirkProfile : uint8_t {
+    Yachie, // yachie's original behaviour
+    CosmacVip,
+    Chip48,
+    SuperChip,
+    XoChip,
+};
+
+// What FX55/FX65 do to I after the transfer
+enum class IndexQuirk : uint8_t {
+    Unchanged,
+    IncrementByX, // CHIP-48's off by one
+    IncrementByXPlusOne, // the original COSMAC VIP behaviour, I ends up after the last register
+};
+
+struct YachieQuirks {
+    static constexpr bool shiftUsesVy = true; // 8XY6/8XYE shift Vy into Vx rather than shifting Vx in place
+    static constexpr IndexQuirk loadStoreIndex = IndexQuirk::Unchanged;
+    static constexpr bool wrapSprites = true; // DXYN wraps pixels around the screen rather than clipping them
+    static constexpr bool logicResetsVF = false; // 8XY1/8XY2/8XY3 clear VF
+    static constexpr bool jumpUsesVx = false; // BXNN jumps to XNN + Vx rather than NNN + V0
+    static constexpr bool carryIsLowBit = true; // 8XY4 sets VF to bit 0 of the sum rather than the carry
+    static constexpr bool superChip = false; // 00CN, 00FB-00FF, DXY0, FX30, FX75 and FX85
+    static constexpr bool resolutionClears = false; // 00FE/00FF clear the screen, which SCHIP 1.1 leaves alone
+    static constexpr bool xoChip = false; // 64KB of memory, bitplanes, audio pattern and their opcodes
+};
+
+struct CosmacVipQuirks {
+    static constexpr bool shiftUsesVy = true;
+    static constexpr IndexQuirk loadStoreIndex = IndexQuirk::IncrementByXPlusOne;
+    static constexpr bool wrapSprites = false;
+    static constexpr bool logicResetsVF = true;
+    static constexpr bool jumpUsesVx = false;
+    static constexpr bool carryIsLowBit = false;
+    static constexpr bool superChip = false;
+    static constexpr bool resolutionClears = false;
+    static constexpr bool xoChip = false;
+};
+
+struct Chip48Quirks {
+    static constexpr bool shiftUsesVy = false;
+    static constexpr IndexQuirk loadStoreIndex = IndexQuirk::IncrementByX;
+    static constexpr bool wrapSprites = false;
+    static constexpr bool logicResetsVF = false;
+    static constexpr bool jumpUsesVx = true;
+    static constexpr bool carryIsLowBit = false;
+    static constexpr bool superChip = false;
+    static constexpr bool resolutionClears = false;
+    static constexpr bool xoChip = false;
+};
+
+struct SuperChipQuirks {
+    static constexpr bool shiftUsesVy = false;
+    static constexpr IndexQuirk loadStoreIndex = IndexQuirk::Unchanged;
+    static constexpr bool wrapSprites = false;
+    static constexpr bool logicResetsVF = false;
+    static constexpr bool jumpUsesVx = true;
+    static constexpr bool carryIsLowBit = false;
+    static constexpr bool superChip = true;
+    static constexpr bool resolutionClears = false;
+    static constexpr bool xoChip = false;
+};
+
+struct XoChipQuirks {
+    static constexpr bool shiftUsesVy = true;
+    static constexpr IndexQuirk loadStoreIndex = IndexQuirk::IncrementByXPlusOne;
+    static constexpr bool wrapSprites = true;
+    static constexpr bool logicResetsVF = false;
+    static constexpr bool jumpUsesVx = false;
+    static constexpr bool carryIsLowBit = false;
+    static constexpr bool superChip = true;
+    static constexpr bool resolutionClears = true;
+    static constexpr bool xoChip = true;
+};
+
+// Accepts yachie, vip, chip48, schip and xochip
+bool parseQuirkProfile(const std::string& name, QuirkProfile& profile);
+const char* quirkProfileName(QuirkProfile profile);
+// The profile a ROM's extension asks for: .sc8 for schip, .xo8 for xochip, yachie for anything else
+QuirkProfile quirkProfileForRom(const std::string& filename);
+
+#endif //CHIP8_QUIRKS_H
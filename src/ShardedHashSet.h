@@ -0,0 +1,58 @@
+#ifndef CHIP8_SHARDEDHASHSET_H
+#define CHIP8_SHARDEDHASHSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+
+// A set of 64 bit hashes that any number of threads can insert into. It's split into Shards sets, each with its own
+// lock, picked by the top bits of the hash, so threads inserting different hashes rarely wait for each other.
+// The hashes are expected to be well mixed already, like Chip8::stateHash().
+template <size_t Shards = 64>
+class ShardedHashSet {
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards must be a power of two");
+public:
+    // True if the hash wasn't in the set yet, so exactly one of the threads inserting the same hash sees true
+    bool insert(uint64_t hash) {
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.hashes.insert(hash).second;
+    }
+
+    bool contains(uint64_t hash) {
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.hashes.count(hash) != 0;
+    }
+
+    // Only a snapshot while other threads are inserting
+    size_t size() {
+        size_t size = 0;
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.hashes.size();
+        }
+        return size;
+    }
+
+private:
+    struct alignas(64) Shard { // on separate cache lines so that the locks aren't shared
+        std::mutex mutex;
+        std::unordered_set<uint64_t> hashes;
+    };
+    static constexpr int shardBits() {
+        int bits = 0;
+        while ((size_t(1) << bits) < Shards) {
+            bits++;
+        }
+        return bits;
+    }
+    Shard& shardOf(uint64_t hash) {
+        // The top bits, unordered_set buckets by the bottom ones
+        return shards[shardBits() == 0 ? 0 : hash >> (64 - shardBits())];
+    }
+    Shard shards[Shards];
+};
+
+#endif //CHIP8_SHARDEDHASHSET_H
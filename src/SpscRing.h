@@ -0,0 +1,52 @@
+#ifndef CHIP8_SPSCRING_H
+#define CHIP8_SPSCRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free ring buffer for exactly one producer thread and one consumer thread. Neither side ever waits,
+// push() and pop() move as many items as currently fit and return how many that was.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+public:
+    size_t push(const T* items, size_t count) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t head = headIndex.load(std::memory_order_acquire);
+        count = std::min(count, Capacity - (tail - head));
+        for (size_t n = 0; n < count; n++) {
+            buffer[(tail + n) & MASK] = items[n];
+        }
+        tailIndex.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t pop(T* items, size_t count) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        size_t tail = tailIndex.load(std::memory_order_acquire);
+        count = std::min(count, tail - head);
+        for (size_t n = 0; n < count; n++) {
+            items[n] = buffer[(head + n) & MASK];
+        }
+        headIndex.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Both are only a snapshot when called from the other thread
+    size_t size() const {
+        size_t head = headIndex.load(std::memory_order_acquire); // head first, so tail can't be behind it
+        return std::min(tailIndex.load(std::memory_order_acquire) - head, Capacity);
+    }
+    size_t space() const {return Capacity - size();}
+    static constexpr size_t capacity() {return Capacity;}
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    // The indices only ever increase and are masked on access, on separate cache lines so the threads don't share one
+    alignas(64) std::atomic<size_t> headIndex{0}; // next item to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tailIndex{0}; // next free slot, written by the producer
+    alignas(64) T buffer[Capacity];
+};
+
+#endif //CHIP8_SPSCRING_H
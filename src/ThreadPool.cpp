@@ -0,0 +1,81 @@
+#include <algorithm>
+#include "ThreadPool.h"
+
+namespace {
+
+// The share of [0, count) of one of threads threads, the first ones taking the remainder
+std::pair<int, int> share(int count, int threads, int index) {
+    int size = count / threads;
+    int remainder = count % threads;
+    int begin = index * size + std::min(index, remainder);
+    return {begin, begin + size + (index < remainder ? 1 : 0)};
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int index = 1; index < threads; index++) {
+        workers.emplace_back(&ThreadPool::work, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(int count, const Task& function) {
+    if (workers.empty() || count <= 1) {
+        function(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &function;
+        this->count = count;
+        pending = int(workers.size());
+        generation++;
+    }
+    started.notify_all();
+    auto [begin, end] = share(count, size(), 0);
+    function(begin, end);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] {return pending == 0;});
+    task = nullptr;
+}
+
+void ThreadPool::work(int index) {
+    long long done = 0;
+    while (true) {
+        const Task* current;
+        int total;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [this, done] {return stopping || generation != done;});
+            if (stopping) {
+                return;
+            }
+            done = generation;
+            current = task;
+            total = count;
+        }
+        auto [begin, end] = share(total, size(), index);
+        if (begin < end) {
+            (*current)(begin, end);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        finished.notify_one();
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef CHIP8_THREADPOOL_H
+#define CHIP8_THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads that stay alive between calls, for work that's split up many times a second, like stepping a batch
+// of environments. run() splits [0, count) into one contiguous range per thread, the calling thread taking the first,
+// and returns once all of them are done. Only one thread may call run() at a time.
+class ThreadPool {
+public:
+    using Task = std::function<void(int begin, int end)>;
+
+    explicit ThreadPool(int threads = 0); // 0 uses every core
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void run(int count, const Task& task);
+    int size() const {return int(workers.size()) + 1;}
+
+private:
+    void work(int index);
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const Task* task = nullptr;
+    int count = 0;
+    long long generation = 0; // bumped by each run(), which is how the workers tell a new batch from the last one
+    int pending = 0; // workers still busy with the current batch
+    bool stopping = false;
+};
+
+#endif //CHIP8_THREADPOOL_H
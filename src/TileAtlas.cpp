@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstring>
+#include "TileAtlas.h"
+
+TileAtlas::TileAtlas(int tiles, int maxTextureSize, const Palette& palette) {
+    std::memcpy(colors, palette.data(), sizeof(colors));
+    if (tiles <= 0 || maxTextureSize < TILE_WIDTH) {
+        return;
+    }
+    columns = std::min(tiles, maxTextureSize / TILE_WIDTH);
+    rows = (tiles + columns - 1) / columns;
+    if (rows * TILE_HEIGHT > maxTextureSize) {
+        columns = rows = 0;
+        return;
+    }
+    screens.resize(size_t(tiles));
+    for (TileScreen& screen : screens) {
+        screen.planes.resize(size_t(TILE_WIDTH * TILE_HEIGHT));
+    }
+    row.resize(TILE_WIDTH);
+}
+
+void TileAtlas::update(int tile, const Chip8& cpu) {
+    TileScreen& screen = screens[size_t(tile)];
+    const uint64_t hashes[3] = {cpu.vramHash(0), cpu.xoChip ? cpu.vramHash(1) : 0,
+                                uint64_t(cpu.state.hires)};
+    if (screen.valid && std::equal(hashes, hashes + 3, screen.hashes)) {
+        return;
+    }
+    const int width = cpu.state.screenWidth();
+    const int height = cpu.state.screenHeight();
+    const bool resized = !screen.valid || width != screen.width; // the whole screen is new
+    const vram_t* plane2 = cpu.secondPlane();
+    int left = width;
+    int right = -1;
+    int top = -1;
+    int bottom = -1;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row1 = cpu.state.vram[y].data();
+        if (plane2 == nullptr) {
+            std::memcpy(row.data(), row1, size_t(width));
+        } else {
+            const uint8_t* row2 = (*plane2)[y].data();
+            for (int x = 0; x < width; x++) {
+                row[size_t(x)] = uint8_t(row1[x] | row2[x] << 1);
+            }
+        }
+        uint8_t* before = screen.planes.data() + y * TILE_WIDTH;
+        if (!resized && std::memcmp(row.data(), before, size_t(width)) == 0) {
+            continue;
+        }
+        for (int x = 0; x < width; x++) {
+            if (resized || row[size_t(x)] != before[x]) {
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+        std::memcpy(before, row.data(), size_t(width));
+        top = top == -1 ? y : top;
+        bottom = y;
+    }
+    std::copy(hashes, hashes + 3, screen.hashes);
+    screen.valid = true;
+    screen.width = width;
+    screen.height = height;
+    if (right == -1) {
+        return;
+    }
+
+    TileUpload upload {tileX(tile) + left, tileY(tile) + top, right - left + 1, bottom - top + 1, staging.size()};
+    staging.resize(staging.size() + size_t(upload.width * upload.height * BYTES_PER_PIXEL));
+    uint8_t* out = staging.data() + upload.offset;
+    for (int y = top; y <= bottom; y++) {
+        const uint8_t* planes = screen.planes.data() + y * TILE_WIDTH;
+        for (int x = left; x <= right; x++) {
+            std::memcpy(out, &colors[planes[x]], BYTES_PER_PIXEL);
+            out += BYTES_PER_PIXEL;
+        }
+    }
+    pending.push_back(upload);
+}
+
+void TileAtlas::clearUploads() {
+    pending.clear();
+    staging.clear();
+}
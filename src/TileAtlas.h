@@ -0,0 +1,63 @@
+#ifndef CHIP8_TILEATLAS_H
+#define CHIP8_TILEATLAS_H
+
+#include <cstdint>
+#include <vector>
+#include "Chip8.h"
+#include "Framebuffer.h"
+
+// Every tile has room for a high resolution screen, a low resolution one uses the top left quarter
+constexpr int TILE_WIDTH = HIRES_WIDTH;
+constexpr int TILE_HEIGHT = HIRES_HEIGHT;
+
+// A rectangle of the atlas to upload, its RGBA pixels tightly packed at offset in TileAtlas::uploadPixels()
+struct TileUpload {
+    int x;
+    int y;
+    int width;
+    int height;
+    size_t offset;
+};
+
+// The screens of many machines in one texture, for drawing them all at once. Tiles are laid out in rows as wide as
+// the largest texture allows. update() goes by the incremental VRAM hashes, so a screen that didn't change costs a
+// comparison, and otherwise converts and queues only the rectangle that changed since the last update. Free of SFML
+// like vramToPixels(), the frontend uploads the queue to its texture and clears it once per frame.
+class TileAtlas {
+public:
+    // maxTextureSize is the largest width and height the texture can have. Check tiles() afterwards: it's 0 if they
+    // don't fit.
+    TileAtlas(int tiles, int maxTextureSize, const Palette& palette = GREY_PALETTE);
+    int tiles() const {return int(screens.size());}
+    int width() const {return columns * TILE_WIDTH;}
+    int height() const {return rows * TILE_HEIGHT;}
+    int tileX(int tile) const {return tile % columns * TILE_WIDTH;}
+    int tileY(int tile) const {return tile / columns * TILE_HEIGHT;}
+    // The part of the tile in use, as of the last update()
+    int screenWidth(int tile) const {return screens[size_t(tile)].width;}
+    int screenHeight(int tile) const {return screens[size_t(tile)].height;}
+
+    void update(int tile, const Chip8& cpu);
+    const std::vector<TileUpload>& uploads() const {return pending;}
+    const uint8_t* uploadPixels() const {return staging.data();}
+    void clearUploads();
+
+private:
+    struct TileScreen {
+        bool valid = false; // nothing has been uploaded yet
+        uint64_t hashes[3] = {}; // the planes and the resolution, as for Capture
+        int width = DISPLAY_WIDTH;
+        int height = DISPLAY_HEIGHT;
+        std::vector<uint8_t> planes; // what was last uploaded, a byte per pixel as for PLANE_LEVELS
+    };
+
+    int columns = 0;
+    int rows = 0;
+    uint32_t colors[4] = {}; // the palette as RGBA words
+    std::vector<TileScreen> screens;
+    std::vector<TileUpload> pending;
+    std::vector<uint8_t> staging;
+    std::vector<uint8_t> row; // one row of planes being compared
+};
+
+#endif //CHIP8_TILEATLAS_H
@@ -0,0 +1,28 @@
+#include <algorithm>
+#include <cmath>
+#include "Tone.h"
+
+constexpr int PATTERN_BITS = AUDIO_PATTERN_SIZE * 8;
+
+float patternBitRate(uint8_t pitch) {
+    return PATTERN_BIT_RATE * std::exp2((float(pitch) - DEFAULT_PITCH) / 48.f);
+}
+
+void ToneGenerator::generate(const Chip8& cpu, int16_t* samples, int count) {
+    if (cpu.state.soundTimer == 0) {
+        std::fill(samples, samples + count, 0);
+        position = 0; // the next beep starts at the beginning of the pattern
+        return;
+    }
+    const uint8_t* pattern = cpu.xoChip ? cpu.xoChip->audioPattern : DEFAULT_AUDIO_PATTERN;
+    const float step = patternBitRate(cpu.xoChip ? cpu.xoChip->pitch : DEFAULT_PITCH) / AUDIO_SAMPLE_RATE;
+    for (int n = 0; n < count; n++) {
+        int bit = int(position);
+        bool high = (pattern[bit >> 3] >> (7 - (bit & 7))) & 1;
+        samples[n] = high ? TONE_AMPLITUDE : -TONE_AMPLITUDE;
+        position += step;
+        if (position >= PATTERN_BITS) {
+            position -= PATTERN_BITS;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef CHIP8_TONE_H
+#define CHIP8_TONE_H
+
+#include <cstdint>
+#include "Chip8.h"
+
+constexpr int AUDIO_SAMPLE_RATE = 44100;
+constexpr int16_t TONE_AMPLITUDE = 6000; // a square wave at full scale is unpleasant
+constexpr float PATTERN_BIT_RATE = 4000.f; // bits per second of the audio pattern at DEFAULT_PITCH
+
+// Bits per second the XO-CHIP audio pattern is played at for a pitch register value
+float patternBitRate(uint8_t pitch);
+
+// Turns the sound timer into samples, kept free of SFML so it can run headless. Everything plays a 1-bit
+// pattern, the classic buzzer being DEFAULT_AUDIO_PATTERN at DEFAULT_PITCH, XO-CHIP ROMs can load their own.
+class ToneGenerator {
+public:
+    // Writes count samples for the machine's current sound timer, pattern and pitch
+    void generate(const Chip8& cpu, int16_t* samples, int count);
+private:
+    float position = 0; // bit in the pattern, carried over so the waveform doesn't jump between calls
+};
+
+#endif //CHIP8_TONE_H
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Tracer.h"
+
+namespace {
+
+struct ThreadBuffer {
+    std::array<Tracer::Event, TRACE_BUFFER_SIZE> events;
+    uint64_t written = 0; // total events recorded, the ring holds the last TRACE_BUFFER_SIZE
+    std::atomic_flag lock = ATOMIC_FLAG_INIT; // only contended while exporting
+    int tid;
+    std::string threadName;
+};
+
+const auto EPOCH = std::chrono::steady_clock::now();
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry; // buffers outlive their threads so they can still be exported
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> guard(registryMutex);
+        buffer->tid = int(registry.size()) + 1;
+        buffer->threadName = buffer->tid == 1 ? "main" : "thread " + std::to_string(buffer->tid);
+        registry.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void lock(ThreadBuffer& buffer) {
+    while (buffer.lock.test_and_set(std::memory_order_acquire)) {
+        ; // spin, the exporter holds it for a single copy
+    }
+}
+
+void unlock(ThreadBuffer& buffer) {
+    buffer.lock.clear(std::memory_order_release);
+}
+
+void writeString(std::ostream& out, const std::string& string) {
+    out << '"';
+    for (char c : string) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+// Chrome traces use microseconds
+void writeMicroseconds(std::ostream& out, int64_t nanoseconds) {
+    out << nanoseconds / 1000 << "." << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+} // namespace
+
+std::atomic<bool> Tracer::enabledFlag(false);
+
+int64_t Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - EPOCH).count();
+}
+
+void Tracer::record(const Event& event) {
+    ThreadBuffer& buffer = threadBuffer();
+    lock(buffer);
+    buffer.events[buffer.written % TRACE_BUFFER_SIZE] = event;
+    buffer.written++;
+    unlock(buffer);
+}
+
+void Tracer::instant(const char* name, const char* category, const char* argName, int64_t arg) {
+    if (enabled()) {
+        record({name, category, argName, arg, now(), -1});
+    }
+}
+
+void Tracer::setThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> guard(registryMutex);
+    buffer.threadName = name;
+}
+
+bool Tracer::writeChromeTrace(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+        std::cerr << "Couldn't write trace " << filename << std::endl;
+        return false;
+    }
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> guard(registryMutex);
+        buffers = registry;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    std::vector<Event> events;
+    for (auto& buffer : buffers) {
+        std::string threadName;
+        lock(*buffer);
+        uint64_t count = std::min<uint64_t>(buffer->written, TRACE_BUFFER_SIZE);
+        events.clear();
+        for (uint64_t n = buffer->written - count; n < buffer->written; n++) {
+            events.push_back(buffer->events[n % TRACE_BUFFER_SIZE]);
+        }
+        unlock(*buffer);
+        {
+            std::lock_guard<std::mutex> guard(registryMutex);
+            threadName = buffer->threadName;
+        }
+
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":";
+        writeString(out, threadName);
+        out << "}}";
+        first = false;
+        for (const Event& event : events) {
+            out << ",\n{\"name\":";
+            writeString(out, event.name);
+            out << ",\"cat\":";
+            writeString(out, event.category);
+            out << ",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            writeMicroseconds(out, event.start);
+            if (event.duration >= 0) {
+                out << ",\"ph\":\"X\",\"dur\":";
+                writeMicroseconds(out, event.duration);
+            } else {
+                out << ",\"ph\":\"i\",\"s\":\"t\"";
+            }
+            if (event.argName != nullptr) {
+                out << ",\"args\":{";
+                writeString(out, event.argName);
+                out << ":" << event.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    std::cerr << "Wrote trace to " << filename << std::endl;
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef CHIP8_TRACER_H
+#define CHIP8_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+constexpr int TRACE_BUFFER_SIZE = 1 << 16; // events kept per thread, older events are overwritten
+
+// Records timestamped spans and instant events into per-thread ring buffers and exports them as Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev). Recording is off until enabled, which leaves a relaxed load per event.
+class Tracer {
+public:
+    struct Event {
+        const char* name; // must be string literals, only the pointers are stored
+        const char* category;
+        const char* argName; // nullptr if the event has no argument
+        int64_t arg;
+        int64_t start; // ns since the tracer's epoch
+        int64_t duration; // ns, -1 for instant events
+    };
+
+    static void setEnabled(bool enabled) {enabledFlag.store(enabled, std::memory_order_relaxed);}
+    static bool enabled() {return enabledFlag.load(std::memory_order_relaxed);}
+    static int64_t now();
+    static void record(const Event& event);
+    static void instant(const char* name, const char* category, const char* argName = nullptr, int64_t arg = 0);
+    static void setThreadName(const char* name);
+    static bool writeChromeTrace(const std::string& filename);
+
+private:
+    static std::atomic<bool> enabledFlag;
+};
+
+// Records a span covering its own lifetime
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category) : name(name), category(category),
+                                                         start(Tracer::enabled() ? Tracer::now() : -1) {}
+    ~TraceScope() {
+        if (start >= 0) {
+            Tracer::record({name, category, nullptr, 0, start, Tracer::now() - start});
+        }
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+
+#endif //CHIP8_TRACER_H
@@ -1,7 +1,26 @@
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include "Audio.h"
+#include "Capture.h"
 #include "Chip8.h"
+#include "DebugConsole.h"
+#include "Display.h"
+#ifdef YACHIE_GDB_SERVER
+#include "GdbServer.h"
+#endif
+#include "Options.h"
+#include "Tracer.h"
 #include "tinyfiledialogs.h"
 
+const std::string TRACE_FILENAME = "yachie-trace.json";
+const std::string EXECUTION_LOG_FILENAME = "yachie-fault.ylog";
+constexpr int MAX_BATCH = int(TIMER_FREQUENCY / CPU_FREQUENCY); // don't try to catch up more than a frame at once
+constexpr int SAMPLES_PER_FRAME = int(AUDIO_SAMPLE_RATE * TIMER_FREQUENCY); // 735, one 60Hz tick of audio
+constexpr double INSTRUCTIONS_PER_SAMPLE = 1.0 / (CPU_FREQUENCY * AUDIO_SAMPLE_RATE);
+constexpr int RECORD_SCALE = 4; // --record canvas pixels per high resolution pixel, 512x256
+
 constexpr sf::Keyboard::Key KEYMAP[] = {
     sf::Keyboard::X, sf::Keyboard::Num1, sf::Keyboard::Num2, sf::Keyboard::Num3,    // 0 1 2 3
     sf::Keyboard::Q, sf::Keyboard::W, sf::Keyboard::E, sf::Keyboard::A,             // 4 5 6 7
@@ -9,73 +28,301 @@ constexpr sf::Keyboard::Key KEYMAP[] = {
     sf::Keyboard::Num4, sf::Keyboard::R, sf::Keyboard::F, sf::Keyboard::V,          // C D E F
 };
 
+std::optional<QuirkProfile> forcedQuirks; // --quirks=, otherwise each ROM's extension picks its profile
+
+void loadROM(Chip8& cpu, const std::string& filename) {
+    cpu.quirkProfile = forcedQuirks ? *forcedQuirks : quirkProfileForRom(filename);
+    cpu.load(filename);
+}
+
 void openROM(Chip8& cpu) {
     const char* filename = tinyfd_openFileDialog("Open ROM", nullptr, 0, nullptr, nullptr, 0); // Sorry about the default location...
     if (filename != nullptr) {
-        cpu.load(filename);
+        loadROM(cpu, filename);
     }
 }
 
-int main(int argc, char* argv[]) {
-    Display display;
-    Chip8 cpu;
-    sf::Clock cpuTimer;
-    sf::Clock delayTimer;
+void handleEvents(Display& display, Chip8& cpu) {
+    // Only traced when something happened, the main loop polls far too often to record every call
+    int64_t traceStart = Tracer::enabled() ? Tracer::now() : -1;
+    int handled = 0;
+    sf::Event event; // NOLINT
+    while (display.window.pollEvent(event)) {
+        handled++;
+        if (event.type == sf::Event::Closed) {
+            display.window.close();
+        } else if (event.type == sf::Event::KeyPressed) {
+            Tracer::instant("key pressed", "input", "code", event.key.code);
+            if (event.key.control && event.key.code == sf::Keyboard::O) {
+                openROM(cpu);
+            } else if (event.key.code == sf::Keyboard::F12 && Tracer::enabled()) {
+                Tracer::writeChromeTrace(TRACE_FILENAME);
+            } else if (cpu.state.acceptingInputInto != -1) { // might be a bit of a hack having this here
+                for (int i = 0; i < NUMBER_OF_KEYS; i++) {
+                    if (event.key.code == KEYMAP[i]) {
+                        cpu.keyInput(i);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    if (traceStart >= 0 && handled > 0) {
+        Tracer::record({"poll events", "input", "events", handled, traceStart, Tracer::now() - traceStart});
+    }
+}
 
-    if (argc == 2) {
-        std::string arg = argv[1];
-        if (arg == "-h" || arg == "--help") {
-            std::cout << "Usage: chip8 [rom]" << std::endl;
-            exit(0);
-        } else {
-            cpu.load(arg);
+// The optional debugger frontends, polled from the emulation loop
+struct Debugging {
+    std::unique_ptr<DebugConsole> console;
+#ifdef YACHIE_GDB_SERVER
+    std::unique_ptr<GdbServer> gdb;
+#endif
+    bool enabled() const {
+#ifdef YACHIE_GDB_SERVER
+        return console || gdb;
+#else
+        return bool(console);
+#endif
+    }
+    // Pauses the frontends on a faulting instruction for --on-fault=trap, halts without any
+    FaultPolicy trap(const FaultRecord& fault) {
+        FaultPolicy policy = FaultPolicy::Halt;
+        if (console) {
+            policy = console->trap(fault);
         }
-    } else {
-        openROM(cpu);
+#ifdef YACHIE_GDB_SERVER
+        if (gdb) {
+            policy = gdb->trap(fault);
+        }
+#endif
+        return policy;
+    }
+    void poll() {
+        if (console) {
+            console->poll();
+        }
+#ifdef YACHIE_GDB_SERVER
+        if (gdb) {
+            gdb->poll();
+        }
+#endif
     }
+};
 
-    while (display.window.isOpen()) {
-        sf::Event event; // NOLINT
-        while (display.window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
+// Runs up to instructions with the current keyboard state, returns false once the machine has halted.
+// Halting closes the window, unless a debugger is there to inspect the machine with.
+bool runBatch(Display& display, Chip8& cpu, Debugging& debugging, int instructions) {
+    TRACE_SCOPE("cpu batch", "cpu");
+    for (int i = 0; i < NUMBER_OF_KEYS; i++) {
+        cpu.state.input[i] = sf::Keyboard::isKeyPressed(KEYMAP[i]); // Setup input
+    }
+    RunResult result = cpu.run(instructions);
+    if (result.fault.fault != Fault::None) {
+        std::cerr << describeFault(result.fault) << std::endl;
+        if (!cpu.state.running) { // halted
+            EXECUTION_LOG(cpu.writeExecutionLog(EXECUTION_LOG_FILENAME));
+            if (debugging.console) {
+                debugging.console->halted(result.fault);
+            } else if (!debugging.enabled()) {
                 display.window.close();
-            } else if (event.type == sf::Event::KeyPressed) {
-                if (event.key.control && event.key.code == sf::Keyboard::O) {
-                    openROM(cpu);
-                } else if (cpu.state.acceptingInputInto != -1) { // might be a bit of a hack having this here
-                    for (int i = 0; i < NUMBER_OF_KEYS; i++) {
-                        if (event.key.code == KEYMAP[i]) {
-                            cpu.keyInput(i);
-                            break;
-                        }
-                    }
-                }
             }
+            return false;
         }
+    }
+    return true;
+}
+
+void drawFrame(Display& display, Chip8& cpu, Capture* capture) {
+    TRACE_SCOPE("frame", "frame");
+    bool ticked = cpu.state.running && !cpu.debugger.isPaused();
+    if (ticked) {
+        cpu.tickTimers();
+        cpu.debugger.endFrame();
+    }
+    display.draw(cpu.state.vram, cpu.secondPlane(), cpu.state.screenWidth(), cpu.state.screenHeight());
+    if (capture != nullptr && ticked) { // emulated time, so pauses don't show up in the recording
+        capture->submit(cpu);
+    }
+}
+
+// Paces emulation from wall-clock time, polling sf::Clocks
+void runClockPaced(Display& display, Audio& audio, Chip8& cpu, Debugging& debugging, Capture* capture) {
+    sf::Clock cpuTimer;
+    sf::Clock delayTimer;
+    while (display.window.isOpen()) {
+        handleEvents(display, cpu);
+        debugging.poll();
 
         if (delayTimer.getElapsedTime().asSeconds() > TIMER_FREQUENCY) {
-            if (cpu.state.running) {
-                cpu.tickTimers();
-            }
-            display.draw(cpu.state.vram);
+            drawFrame(display, cpu, capture);
             delayTimer.restart();
         }
 
         if (cpu.state.running) {
-            if (cpuTimer.getElapsedTime().asSeconds() > CPU_FREQUENCY) {
-                try {
-                    for (int i = 0; i < NUMBER_OF_KEYS; i++) {
-                        cpu.state.input[i] = sf::Keyboard::isKeyPressed(KEYMAP[i]); // Setup input
-                    }
-                    cpu.step();
-                } catch (const std::exception& e) {
-                    std::cerr << e.what() << std::endl;
-                    display.window.close();
-                }
+            float elapsed = cpuTimer.getElapsedTime().asSeconds();
+            if (elapsed > CPU_FREQUENCY) {
+                runBatch(display, cpu, debugging, std::min(int(elapsed / CPU_FREQUENCY), MAX_BATCH));
                 cpuTimer.restart();
             }
         }
+        audio.update(cpu);
+    }
+}
+
+// Paces emulation from the audio device: sleeps until the ring has drained by a chunk, then emulates exactly the
+// time those samples cover. Timer ticks and frames happen every SAMPLES_PER_FRAME samples, so the emulation
+// runs at the sound card's rate whatever the display's refresh rate is.
+void runAudioPaced(Display& display, Audio& audio, Chip8& cpu, Debugging& debugging, Capture* capture) {
+    int samplesUntilFrame = SAMPLES_PER_FRAME;
+    double instructionsOwed = 0; // fractional instructions carried between slices
+    while (display.window.isOpen()) {
+        handleEvents(display, cpu);
+        debugging.poll();
+        audio.waitForSpace(AUDIO_CHUNK_SAMPLES);
+        int samples = audio.space();
+        while (samples > 0 && display.window.isOpen()) {
+            int slice = std::min(samples, samplesUntilFrame);
+            instructionsOwed += slice * INSTRUCTIONS_PER_SAMPLE;
+            int instructions = int(instructionsOwed);
+            instructionsOwed -= instructions;
+            if (cpu.state.running && instructions > 0 && !runBatch(display, cpu, debugging, instructions)) {
+                break;
+            }
+            audio.push(cpu, slice);
+            samples -= slice;
+            samplesUntilFrame -= slice;
+            if (samplesUntilFrame == 0) {
+                drawFrame(display, cpu, capture);
+                samplesUntilFrame = SAMPLES_PER_FRAME;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Display display;
+    Audio audio;
+    Chip8 cpu;
+    bool audioSync = false;
+    Debugging debugging;
+    std::unique_ptr<Capture> capture;
+
+    std::string romFilename;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: chip8 [options] [rom]" << std::endl;
+            std::cout << "  --trace           record a Chrome trace, press F12 to write it to " << TRACE_FILENAME
+                      << std::endl;
+            std::cout << "  --audio-sync      pace emulation from the audio device instead of the system clock"
+                      << std::endl;
+            std::cout << "  --debug           start paused, with a debugger reading commands from the terminal"
+                      << std::endl;
+#ifdef YACHIE_GDB_SERVER
+            std::cout << "  --gdb=PORT        start paused, with a GDB remote stub on localhost:PORT (or unix:PATH)"
+                      << std::endl;
+#endif
+            std::cout << "  --on-fault=skip   skip faulting instructions instead of stopping" << std::endl;
+            std::cout << "  --on-fault=trap   pause the debugger on faulting instructions, stop without one"
+                      << std::endl;
+            std::cout << "  --memory=POLICY   handle accesses past the end of memory: guarded (default), wrap or"
+                         " checked" << std::endl;
+            std::cout << "  --quirks=PROFILE  interpret ambiguous opcodes like yachie, vip, chip48, schip or xochip,"
+                      << " for every ROM rather than by extension" << std::endl;
+            std::cout << "  --record=FILE     record what's on screen to an animated .gif or a .y4m video" << std::endl;
+            std::cout << "  --palette=COLORS  grey (default), green, amber, octo, lcd, or RRGGBB colors for the"
+                      << " background and planes, like 000000,33FF66" << std::endl;
+            std::cout << "  --persistence=N   fade pixels out over N frames like phosphor, which hides flicker"
+                      << std::endl;
+            exit(0);
+        } else if (option == "--trace") {
+            Tracer::setEnabled(true);
+        } else if (option == "--audio-sync") {
+            audioSync = true;
+        } else if (option == "--debug") {
+            debugging.console = std::make_unique<DebugConsole>(cpu, std::cin, std::cout);
+#ifdef YACHIE_GDB_SERVER
+        } else if (option.compare(0, 6, "--gdb=") == 0) {
+            debugging.gdb = std::make_unique<GdbServer>(cpu);
+            if (!debugging.gdb->listen(option.substr(6))) {
+                exit(1);
+            }
+#endif
+        } else if (option == "--on-fault=halt") {
+            cpu.faultPolicy = FaultPolicy::Halt;
+        } else if (option == "--on-fault=skip") {
+            cpu.faultPolicy = FaultPolicy::Skip;
+        } else if (option == "--on-fault=trap") {
+            cpu.faultPolicy = FaultPolicy::Trap;
+        } else if (option.compare(0, 9, "--memory=") == 0) {
+            if (!parseMemoryPolicy(option.substr(9), cpu.memoryPolicy)) {
+                std::cerr << "Unknown memory policy " << option.substr(9) << std::endl;
+                exit(1);
+            }
+        } else if (option.compare(0, 9, "--quirks=") == 0) {
+            QuirkProfile profile;
+            if (!parseQuirkProfile(option.substr(9), profile)) {
+                std::cerr << "Unknown quirk profile " << option.substr(9) << std::endl;
+                exit(1);
+            }
+            forcedQuirks = profile;
+        } else if (option.compare(0, 10, "--palette=") == 0) {
+            Palette palette;
+            if (!parsePalette(option.substr(10), palette)) {
+                std::cerr << "Unknown palette " << option.substr(10) << std::endl;
+                exit(1);
+            }
+            display.setPalette(palette);
+        } else if (option.compare(0, 14, "--persistence=") == 0) {
+            int frames = 0;
+            if (!parseNumber(option.substr(14), frames)) {
+                std::cerr << "Persistence must be a number of frames, not " << option.substr(14) << std::endl;
+                exit(1);
+            }
+            display.setPersistence(frames);
+        } else if (option.compare(0, 9, "--record=") == 0) {
+            std::string filename = option.substr(9);
+            CaptureFormat format;
+            if (!captureFormatFor(filename, format)) {
+                std::cerr << "Can only record to .gif or .y4m, not " << filename << std::endl;
+                exit(1);
+            }
+            capture = std::make_unique<Capture>(filename, format, RECORD_SCALE);
+            if (!capture->isOpen()) {
+                std::cerr << "Can't write " << filename << std::endl;
+                exit(1);
+            }
+        } else {
+            romFilename = option;
+        }
+    }
+    if (romFilename.empty()) {
+        openROM(cpu);
+    } else {
+        loadROM(cpu, romFilename);
     }
 
+    if (debugging.enabled()) {
+        cpu.debugger.pause(); // before the first instruction, to set breakpoints
+    }
+    cpu.trapHandler = [&debugging](Chip8&, const FaultRecord& fault) {return debugging.trap(fault);};
+    if (debugging.console) {
+        debugging.console->start();
+    }
+    audio.play();
+    if (audioSync) {
+        runAudioPaced(display, audio, cpu, debugging, capture.get());
+    } else {
+        runClockPaced(display, audio, cpu, debugging, capture.get());
+    }
+
+    if (capture) {
+        capture->finish();
+        if (capture->dropped() > 0) {
+            std::cerr << capture->dropped() << " frames were dropped from the recording" << std::endl;
+        }
+    }
+    PROFILE(cpu.profiler.dump("yachie-profile.txt", "yachie-profile.folded"));
     return 0;
 }
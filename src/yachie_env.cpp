@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <exception>
+#include <string>
+#include "Environment.h"
+#include "yachie_env.h"
+
+// The C API is a thin layer over VectorEnvironment, which keeps all the state
+
+struct yachie_env {
+    VectorEnvironment environment;
+};
+
+namespace {
+
+thread_local std::string lastError;
+
+} // namespace
+
+int yachie_env_api_version(void) {
+    return YACHIE_ENV_API_VERSION;
+}
+
+yachie_env_config yachie_env_default_config(void) {
+    EnvironmentOptions defaults;
+    return {nullptr, defaults.instructionsPerFrame, defaults.maxEpisodeFrames, defaults.threads, defaults.frameSkip,
+            defaults.downsample, defaults.maxOverFrames, YACHIE_ENV_PIXELS, nullptr, 0, nullptr};
+}
+
+yachie_env* yachie_env_create(const uint8_t* rom, size_t rom_size, int count, const yachie_env_config* config) {
+    yachie_env_config settings = config ? *config : yachie_env_default_config();
+    EnvironmentOptions options;
+    if (settings.quirks != nullptr && !parseQuirkProfile(settings.quirks, options.profile)) {
+        lastError = std::string("unknown quirk profile ") + settings.quirks;
+        return nullptr;
+    }
+    if (rom == nullptr || rom_size == 0) {
+        lastError = "no ROM given";
+        return nullptr;
+    }
+    if (count <= 0) {
+        lastError = "there has to be at least one environment";
+        return nullptr;
+    }
+    if (settings.instructions_per_frame > 0) {
+        options.instructionsPerFrame = settings.instructions_per_frame;
+    }
+    options.maxEpisodeFrames = std::max(settings.max_episode_frames, 0);
+    options.threads = settings.threads;
+    options.frameSkip = settings.frame_skip > 0 ? settings.frame_skip : 1;
+    options.downsample = settings.downsample;
+    options.maxOverFrames = settings.max_over_frames != 0;
+    if (settings.observation_format != YACHIE_ENV_PIXELS && settings.observation_format != YACHIE_ENV_PACKED) {
+        lastError = "unknown observation format " + std::to_string(settings.observation_format);
+        return nullptr;
+    }
+    options.format = settings.observation_format == YACHIE_ENV_PACKED ? ObservationFormat::Packed
+                                                                      : ObservationFormat::Pixels;
+    for (int p = 0; p < settings.reward_probe_count; p++) {
+        const yachie_env_probe& probe = settings.reward_probes[p];
+        if (probe.encoding != YACHIE_ENV_BINARY && probe.encoding != YACHIE_ENV_DIGITS) {
+            lastError = "unknown reward probe encoding " + std::to_string(probe.encoding);
+            return nullptr;
+        }
+        options.rewards.push_back({probe.address, probe.bytes,
+                                   probe.encoding == YACHIE_ENV_DIGITS ? ProbeEncoding::Digits : ProbeEncoding::Binary,
+                                   probe.scale});
+    }
+    if (settings.probes != nullptr) {
+        std::string error = options.probes.compile(settings.probes);
+        if (!error.empty()) {
+            lastError = "probes, " + error;
+            return nullptr;
+        }
+    }
+    lastError = checkOptions(options);
+    if (!lastError.empty()) {
+        return nullptr;
+    }
+    try {
+        return new yachie_env {VectorEnvironment(std::vector<uint8_t>(rom, rom + rom_size), count, options)};
+    } catch (const std::exception& exception) { // out of memory or threads
+        lastError = exception.what();
+        return nullptr;
+    }
+}
+
+void yachie_env_destroy(yachie_env* env) {
+    delete env;
+}
+
+const char* yachie_env_error(void) {
+    return lastError.c_str();
+}
+
+int yachie_env_count(const yachie_env* env) {
+    return env->environment.size();
+}
+
+int yachie_env_observation_width(const yachie_env* env) {
+    return env->environment.observationWidth();
+}
+
+int yachie_env_observation_height(const yachie_env* env) {
+    return env->environment.observationHeight();
+}
+
+int yachie_env_observation_size(const yachie_env* env) {
+    return env->environment.observationSize();
+}
+
+int yachie_env_probe_values(const yachie_env* env, const char* name, int64_t* values) {
+    return env->environment.probeValues(name, values) ? 0 : -1;
+}
+
+void yachie_env_reset(yachie_env* env, uint64_t seed, uint8_t* observations) {
+    env->environment.reset(seed, observations);
+}
+
+void yachie_env_step(yachie_env* env, const int32_t* actions, uint8_t* observations, float* rewards,
+                     uint8_t* dones) {
+    env->environment.step(actions, observations, rewards, dones);
+}
@@ -0,0 +1,98 @@
+#ifndef YACHIE_ENV_H
+#define YACHIE_ENV_H
+
+/* C API for batches of headless CHIP-8 environments, for reinforcement learning from any language with a C FFI.
+ * See python/yachie_env.py for the Python binding. Every buffer belongs to the caller and is written in place:
+ * nothing is allocated or copied per step. The functions aren't thread safe for a single yachie_env, which runs its
+ * environments on its own threads. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#define YACHIE_ENV_API __declspec(dllexport)
+#else
+#define YACHIE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#define YACHIE_ENV_API_VERSION 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct yachie_env yachie_env;
+
+/* Observation formats */
+#define YACHIE_ENV_PIXELS 0 /* a byte per pixel: bit 0 is the first plane and bit 1 XO-CHIP's second */
+#define YACHIE_ENV_PACKED 1 /* a bit per pixel lit in either plane, eight to a byte, leftmost in the high bit */
+
+/* Reward probe encodings */
+#define YACHIE_ENV_BINARY 0 /* an unsigned big endian number */
+#define YACHIE_ENV_DIGITS 1 /* a decimal digit per byte, most significant first, as FX33 writes them */
+
+/* A number in guest memory, such as a score. Each step's reward is the sum over the probes of scale times the
+ * change of their number during the step. */
+typedef struct yachie_env_probe {
+    int address;
+    int bytes; /* 1-4 */
+    int encoding;
+    float scale;
+} yachie_env_probe;
+
+typedef struct yachie_env_config {
+    const char* quirks; /* a quirk profile, as for yachie --quirks, NULL for the default */
+    int instructions_per_frame; /* 0 for the default, 16 */
+    int max_episode_frames; /* episodes are truncated after this many frames, 0 for no limit */
+    int threads; /* 0 uses every core */
+    int frame_skip; /* frames per step, all holding the step's action, 0 for 1 */
+    int downsample; /* observations get a pixel per downsample x downsample block, the OR of the block: 1, 2, 4 or 8 */
+    int max_over_frames; /* non-zero ORs the step's last two frames together, to keep flickering sprites */
+    int observation_format;
+    const yachie_env_probe* reward_probes; /* copied by yachie_env_create() */
+    int reward_probe_count;
+    /* A probe program, see src/Probes.h, run after every frame, or NULL. The reward it assigns is added to the
+     * step's reward each frame, the change in its score over the step too, and a done that isn't 0 terminates the
+     * episode. For example "score = bcd(mem[0x314..0x316])\ndone = v[0xE] == 0". */
+    const char* probes;
+} yachie_env_config;
+
+/* Possible values of the dones array */
+#define YACHIE_ENV_RUNNING 0
+#define YACHIE_ENV_TERMINATED 1 /* the machine halted */
+#define YACHIE_ENV_TRUNCATED 2 /* the episode reached max_episode_frames */
+
+#define YACHIE_ENV_NO_KEY (-1) /* the action that holds no key, the others are the key held, 0-15 */
+
+YACHIE_ENV_API int yachie_env_api_version(void);
+YACHIE_ENV_API yachie_env_config yachie_env_default_config(void);
+/* count environments running the rom, or NULL with yachie_env_error() set. config may be NULL for the defaults. */
+YACHIE_ENV_API yachie_env* yachie_env_create(const uint8_t* rom, size_t rom_size, int count,
+                                             const yachie_env_config* config);
+YACHIE_ENV_API void yachie_env_destroy(yachie_env* env);
+/* Why the last yachie_env_create() on this thread failed */
+YACHIE_ENV_API const char* yachie_env_error(void);
+
+YACHIE_ENV_API int yachie_env_count(const yachie_env* env);
+/* An observation is width x height pixels, in observation_size bytes depending on the observation format */
+YACHIE_ENV_API int yachie_env_observation_width(const yachie_env* env);
+YACHIE_ENV_API int yachie_env_observation_height(const yachie_env* env);
+YACHIE_ENV_API int yachie_env_observation_size(const yachie_env* env);
+
+/* Writes the variable name of the probe program, as of the last frame, to count values. Returns -1 if the program
+ * doesn't assign name, 0 otherwise. */
+YACHIE_ENV_API int yachie_env_probe_values(const yachie_env* env, const char* name, int64_t* values);
+
+/* Restarts every environment, seeding each from seed and its index, and writes count observations */
+YACHIE_ENV_API void yachie_env_reset(yachie_env* env, uint64_t seed, uint8_t* observations);
+/* Runs frame_skip frames of each environment holding the key of its action, stopping early if the episode ends.
+ * Writes count observations, rewards and dones, rewards may be NULL. An environment whose episode ended restarts
+ * on the next step, the observation given with the end being the last screen of the episode. */
+YACHIE_ENV_API void yachie_env_step(yachie_env* env, const int32_t* actions, uint8_t* observations, float* rewards,
+                                    uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* YACHIE_ENV_H */
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TileAtlas.h"
+
+// Runs many machines into a TileAtlas and applies its uploads to a copy of the texture, which has to match each
+// machine's screen after every frame, with nothing uploaded for screens that didn't change. Exits non-zero on the
+// first failure.
+
+namespace {
+
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+constexpr int FRAMES = 120;
+constexpr int MAX_TEXTURE_SIZE = 1024; // small, so the tiles take several rows
+constexpr int INSTANCES = 100;
+
+// Switches between the resolutions every few frames, drawing in each
+const std::vector<uint8_t> RESOLUTION_ROM = {
+    0x00, 0xFF, // HIGH
+    0xD0, 0x15, // DRW V0, V0, 5
+    0x70, 0x09, // ADD V0, 9
+    0x00, 0xFE, // LOW
+    0xD0, 0x15, // DRW V0, V0, 5
+    0x12, 0x00, // JP 0x200
+};
+
+std::string checkLayout() {
+    if (TileAtlas(0, MAX_TEXTURE_SIZE).tiles() != 0 || TileAtlas(1, TILE_WIDTH - 1).tiles() != 0 ||
+        TileAtlas(129, MAX_TEXTURE_SIZE).tiles() != 0) {
+        return "tiles that don't fit were accepted";
+    }
+    TileAtlas atlas(INSTANCES, MAX_TEXTURE_SIZE);
+    if (atlas.width() != MAX_TEXTURE_SIZE || atlas.height() != 13 * TILE_HEIGHT || atlas.tileX(9) != TILE_WIDTH ||
+        atlas.tileY(9) != TILE_HEIGHT) {
+        return "unexpected layout";
+    }
+    return atlas.tiles() == INSTANCES && TileAtlas(3, MAX_TEXTURE_SIZE).width() == 3 * TILE_WIDTH ? "" :
+           "unexpected size";
+}
+
+std::string checkUploads() {
+    std::vector<std::string> roms;
+    for (const auto& entry : std::filesystem::directory_iterator(YACHIE_ROM_DIR)) {
+        roms.push_back(entry.path().string());
+    }
+    std::sort(roms.begin(), roms.end());
+    std::vector<std::unique_ptr<Chip8>> machines;
+    for (int n = 0; n < INSTANCES; n++) {
+        auto cpu = std::make_unique<Chip8>();
+        if (n % 10 == 0) {
+            cpu->quirkProfile = n % 20 == 0 ? QuirkProfile::SuperChip : QuirkProfile::XoChip;
+            cpu->load(RESOLUTION_ROM.data(), RESOLUTION_ROM.size());
+        } else {
+            cpu->load(roms[size_t(n) % roms.size()]);
+        }
+        cpu->seedRandom(uint32_t(n));
+        machines.push_back(std::move(cpu));
+    }
+
+    TileAtlas atlas(INSTANCES, MAX_TEXTURE_SIZE);
+    std::vector<uint8_t> texture(size_t(atlas.width() * atlas.height() * BYTES_PER_PIXEL));
+    pixels_t pixels;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        int changed = 0;
+        for (int n = 0; n < INSTANCES; n++) {
+            Chip8& cpu = *machines[size_t(n)];
+            for (int key = 0; key < NUMBER_OF_KEYS; key++) {
+                cpu.state.input[key] = key == (frame / 10 + n) % NUMBER_OF_KEYS;
+            }
+            uint64_t hash = cpu.vramHash();
+            bool hires = cpu.state.hires;
+            cpu.run(STEPS_PER_FRAME);
+            cpu.tickTimers();
+            changed += frame == 0 || cpu.vramHash() != hash || cpu.state.hires != hires ||
+                       cpu.secondPlane() != nullptr;
+            atlas.update(n, cpu);
+        }
+        if (int(atlas.uploads().size()) > changed) {
+            return std::to_string(atlas.uploads().size()) + " uploads for " + std::to_string(changed) +
+                   " changed screens";
+        }
+        for (const TileUpload& upload : atlas.uploads()) {
+            for (int y = 0; y < upload.height; y++) {
+                std::copy_n(atlas.uploadPixels() + upload.offset + size_t(y * upload.width * BYTES_PER_PIXEL),
+                            upload.width * BYTES_PER_PIXEL,
+                            texture.begin() + ((upload.y + y) * atlas.width() + upload.x) * BYTES_PER_PIXEL);
+            }
+        }
+        atlas.clearUploads();
+        for (int n = 0; n < INSTANCES; n++) {
+            const Chip8& cpu = *machines[size_t(n)];
+            const int width = cpu.state.screenWidth();
+            const int height = cpu.state.screenHeight();
+            if (atlas.screenWidth(n) != width || atlas.screenHeight(n) != height) {
+                return "tile " + std::to_string(n) + " has the wrong resolution";
+            }
+            vramToPixels(cpu.state.vram, cpu.secondPlane(), pixels, width, height);
+            for (int y = 0; y < height; y++) {
+                auto tileRow = texture.begin() +
+                               ((atlas.tileY(n) + y) * atlas.width() + atlas.tileX(n)) * BYTES_PER_PIXEL;
+                if (!std::equal(tileRow, tileRow + width * BYTES_PER_PIXEL,
+                                pixels.begin() + y * width * BYTES_PER_PIXEL)) {
+                    return "tile " + std::to_string(n) + " differs from its screen after frame " +
+                           std::to_string(frame);
+                }
+            }
+        }
+    }
+
+    // Nothing to upload when nothing changed
+    for (int n = 0; n < INSTANCES; n++) {
+        atlas.update(n, *machines[size_t(n)]);
+    }
+    return atlas.uploads().empty() ? "" : "screens that didn't change were uploaded";
+}
+
+} // namespace
+
+int main() {
+    for (auto check : {checkLayout, checkUploads}) {
+        std::string error = check();
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "The atlas matches every screen" << std::endl;
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "Capture.h"
+#include "Framebuffer.h"
+
+// Records ROMs to GIF and Y4M and reads the files back: the GIF's LZW data is decoded and its frames composed, and
+// both have to show what the machine showed, for as long as it showed it. Exits non-zero on the first failure.
+
+namespace {
+
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+constexpr int KEY_HOLD_FRAMES = 6;
+constexpr int SCALE = 2;
+constexpr int CANVAS_WIDTH = HIRES_WIDTH * SCALE;
+constexpr int CANVAS_HEIGHT = HIRES_HEIGHT * SCALE;
+
+using Canvas = std::vector<uint8_t>;
+
+Canvas canvasOf(const Chip8& cpu) {
+    const int factor = CANVAS_WIDTH / cpu.state.screenWidth();
+    const vram_t* plane2 = cpu.secondPlane();
+    Canvas canvas(size_t(CANVAS_WIDTH * CANVAS_HEIGHT));
+    for (int y = 0; y < CANVAS_HEIGHT; y++) {
+        for (int x = 0; x < CANVAS_WIDTH; x++) {
+            int row = y / factor;
+            int column = x / factor;
+            canvas[size_t(y * CANVAS_WIDTH + x)] =
+                uint8_t(cpu.state.vram[row][column] | (plane2 ? (*plane2)[row][column] << 1 : 0));
+        }
+    }
+    return canvas;
+}
+
+// Runs the ROM like the golden tests, recording every frame and keeping what it should look like
+void record(const std::vector<uint8_t>& rom, QuirkProfile profile, int frames, Capture& capture,
+            std::vector<Canvas>& expected) {
+    Chip8 cpu;
+    cpu.quirkProfile = profile;
+    cpu.load(rom.data(), rom.size());
+    cpu.seedRandom(1);
+    for (int frame = 1; frame <= frames; frame++) {
+        int step = frame / KEY_HOLD_FRAMES;
+        int key = (step / 2) % NUMBER_OF_KEYS;
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            cpu.state.input[n] = step % 2 == 0 && n == key;
+        }
+        int remaining = STEPS_PER_FRAME;
+        while (remaining > 0 && cpu.state.running) {
+            if (cpu.state.acceptingInputInto != -1) {
+                cpu.keyInput(uint8_t(key));
+            }
+            RunResult result = cpu.run(remaining);
+            remaining -= std::max(result.executed, 1);
+        }
+        cpu.tickTimers();
+        capture.waitForSpace();
+        capture.submit(cpu);
+        expected.push_back(canvasOf(cpu));
+    }
+    capture.finish();
+}
+
+std::vector<uint8_t> readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+struct Gif {
+    std::vector<Canvas> frames; // composed, as a viewer shows them
+    std::vector<int> delays; // centiseconds
+    int clears = 0; // clear codes after the first in each frame
+};
+
+// Variable width LZW, straight from the GIF89a specification
+bool decompress(const std::vector<uint8_t>& data, int codeSize, std::vector<uint8_t>& out, int& clears) {
+    const int clearCode = 1 << codeSize;
+    const int endCode = clearCode + 1;
+    std::vector<std::vector<uint8_t>> table(4096);
+    for (int code = 0; code < clearCode; code++) {
+        table[size_t(code)] = {uint8_t(code)};
+    }
+    int width = codeSize + 1;
+    int next = endCode + 1;
+    int previous = -1;
+    size_t bit = 0;
+    bool first = true;
+    while (bit + size_t(width) <= data.size() * 8) {
+        int code = 0;
+        for (int n = 0; n < width; n++, bit++) {
+            code |= (data[bit / 8] >> (bit % 8) & 1) << n;
+        }
+        if (code == clearCode) {
+            clears += first ? 0 : 1;
+            first = false;
+            width = codeSize + 1;
+            next = endCode + 1;
+            previous = -1;
+            continue;
+        }
+        first = false;
+        if (code == endCode) {
+            return true;
+        }
+        if (previous == -1) {
+            if (code >= clearCode) {
+                return false;
+            }
+            out.push_back(uint8_t(code));
+            previous = code;
+            continue;
+        }
+        std::vector<uint8_t> entry;
+        if (code < next) {
+            entry = table[size_t(code)];
+        } else if (code == next) {
+            entry = table[size_t(previous)];
+            entry.push_back(entry[0]);
+        } else {
+            return false;
+        }
+        if (next < 4096) {
+            table[size_t(next)] = table[size_t(previous)];
+            table[size_t(next)].push_back(entry[0]);
+            next++;
+            if (next == 1 << width && width < 12) {
+                width++;
+            }
+        }
+        out.insert(out.end(), entry.begin(), entry.end());
+        previous = code;
+    }
+    return false;
+}
+
+std::string readGif(const std::string& filename, Gif& gif) {
+    std::vector<uint8_t> file = readFile(filename);
+    size_t at = 0;
+    auto byte = [&]() {return at < file.size() ? file[at++] : 0;};
+    auto little16 = [&]() {int low = byte(); return low | byte() << 8;};
+    if (file.size() < 13 || std::string(file.begin(), file.begin() + 6) != "GIF89a") {
+        return "no GIF89a header";
+    }
+    at = 6;
+    if (little16() != CANVAS_WIDTH || little16() != CANVAS_HEIGHT) {
+        return "the canvas isn't " + std::to_string(CANVAS_WIDTH) + "x" + std::to_string(CANVAS_HEIGHT);
+    }
+    int flags = byte();
+    at += 2 + 3 * (2 << (flags & 7));
+    Canvas canvas(size_t(CANVAS_WIDTH * CANVAS_HEIGHT));
+    int delay = 0;
+    while (at < file.size()) {
+        int block = byte();
+        if (block == 0x3B) {
+            return at == file.size() ? "" : "data after the trailer";
+        }
+        if (block == 0x21) {
+            int label = byte();
+            if (label == 0xF9) {
+                at += 2;
+                delay = little16();
+                at -= 4;
+            }
+            for (int length = byte(); length != 0; length = byte()) {
+                at += size_t(length);
+            }
+            continue;
+        }
+        if (block != 0x2C) {
+            return "unknown block " + std::to_string(block);
+        }
+        int left = little16();
+        int top = little16();
+        int width = little16();
+        int height = little16();
+        byte();
+        if (left + width > CANVAS_WIDTH || top + height > CANVAS_HEIGHT) {
+            return "a frame outside the canvas";
+        }
+        int codeSize = byte();
+        std::vector<uint8_t> data;
+        for (int length = byte(); length != 0; length = byte()) {
+            data.insert(data.end(), file.begin() + long(at), file.begin() + long(at + size_t(length)));
+            at += size_t(length);
+        }
+        std::vector<uint8_t> pixels;
+        if (!decompress(data, codeSize, pixels, gif.clears) || pixels.size() != size_t(width * height)) {
+            return "frame " + std::to_string(gif.frames.size()) + " didn't decompress";
+        }
+        for (int y = 0; y < height; y++) {
+            std::copy_n(pixels.begin() + y * width, width, canvas.begin() + (top + y) * CANVAS_WIDTH + left);
+        }
+        gif.frames.push_back(canvas);
+        gif.delays.push_back(delay);
+    }
+    return "no trailer";
+}
+
+// Each frame in the GIF has to be one the machine showed at about the time the GIF shows it
+std::string checkGif(const std::string& filename, const std::vector<Canvas>& expected) {
+    Gif gif;
+    std::string error = readGif(filename, gif);
+    if (!error.empty()) {
+        return error;
+    }
+    int time = 0; // centiseconds
+    for (size_t n = 0; n < gif.frames.size(); n++) {
+        const int frame = time * CAPTURE_FRAME_RATE / 100;
+        bool found = false;
+        for (int near = std::max(frame - 2, 0); near <= std::min(frame + 2, int(expected.size()) - 1); near++) {
+            found = found || gif.frames[n] == expected[size_t(near)];
+        }
+        if (!found) {
+            return "frame " + std::to_string(n) + ", at " + std::to_string(time) + "cs, wasn't on screen then";
+        }
+        time += gif.delays[n];
+    }
+    if (gif.frames.empty() || gif.frames.back() != expected.back()) {
+        return "the last frame isn't the last screen";
+    }
+    int length = int(expected.size()) * 100 / CAPTURE_FRAME_RATE;
+    if (std::abs(time - length) > 2) {
+        return "lasts " + std::to_string(time) + "cs instead of " + std::to_string(length) + "cs";
+    }
+    return "";
+}
+
+std::string checkY4m(const std::string& filename, const std::vector<Canvas>& expected) {
+    std::vector<uint8_t> file = readFile(filename);
+    auto newline = std::find(file.begin(), file.end(), '\n');
+    std::string header(file.begin(), newline);
+    if (header.rfind("YUV4MPEG2 W" + std::to_string(CANVAS_WIDTH) + " H" + std::to_string(CANVAS_HEIGHT) + " F60:1",
+                     0) != 0) {
+        return "unexpected header " + header;
+    }
+    size_t at = size_t(newline - file.begin()) + 1;
+    const size_t lumaSize = size_t(CANVAS_WIDTH * CANVAS_HEIGHT);
+    const size_t frameSize = 6 + lumaSize * 3 / 2;
+    if (file.size() - at != frameSize * expected.size()) {
+        return std::to_string((file.size() - at) / frameSize) + " frames instead of " +
+               std::to_string(expected.size());
+    }
+    for (size_t n = 0; n < expected.size(); n++, at += frameSize) {
+        for (size_t pixel = 0; pixel < lumaSize; pixel++) {
+            if (file[at + 6 + pixel] != PLANE_LEVELS[expected[n][pixel]]) {
+                return "frame " + std::to_string(n) + " differs";
+            }
+        }
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string gifFilename = (directory / "yachie_capture_test.gif").string();
+    const std::string y4mFilename = (directory / "yachie_capture_test.y4m").string();
+    const std::vector<uint8_t> brix = readFile(std::string(YACHIE_ROM_DIR) + "/BRIX");
+    const std::vector<uint8_t> ibm = readFile(std::string(YACHIE_ROM_DIR) + "/IBM");
+    struct Run {
+        const char* name;
+        const std::vector<uint8_t>& rom;
+        QuirkProfile profile;
+        int frames;
+    };
+    for (const Run& run : {Run{"BRIX", brix, QuirkProfile::Yachie, 600},
+                           Run{"IBM", ibm, QuirkProfile::Yachie, 600}}) {
+        std::vector<Canvas> expected;
+        Capture gifCapture(gifFilename, CaptureFormat::Gif, SCALE);
+        record(run.rom, run.profile, run.frames, gifCapture, expected);
+        std::string error = checkGif(gifFilename, expected);
+        if (!error.empty()) {
+            std::cerr << run.name << " as a GIF: " << error << std::endl;
+            return 1;
+        }
+        expected.clear();
+        Capture y4mCapture(y4mFilename, CaptureFormat::Y4m, SCALE);
+        record(run.rom, run.profile, run.frames, y4mCapture, expected);
+        error = checkY4m(y4mFilename, expected);
+        if (!error.empty()) {
+            std::cerr << run.name << " as Y4M: " << error << std::endl;
+            return 1;
+        }
+    }
+
+    // IBM draws its logo and stops, which should take one image however long it stays up, and the noise has to fill
+    // the code table
+    Gif gif;
+    std::vector<Canvas> expected;
+    {
+        Capture capture(gifFilename, CaptureFormat::Gif, SCALE);
+        record(ibm, QuirkProfile::Yachie, 600, capture, expected);
+    }
+    readGif(gifFilename, gif);
+    if (gif.frames.size() > 3) {
+        std::cerr << "a still screen took " << gif.frames.size() << " images" << std::endl;
+        return 1;
+    }
+    // Random pixels don't compress, so the table fills up and has to be cleared within a frame
+    gif = Gif();
+    expected.clear();
+    {
+        Capture capture(gifFilename, CaptureFormat::Gif, SCALE);
+        Chip8 cpu;
+        cpu.quirkProfile = QuirkProfile::XoChip;
+        cpu.initState();
+        cpu.state.hires = true;
+        std::mt19937 random(1);
+        for (int frame = 0; frame < 10; frame++) {
+            for (vram_t* plane : {&cpu.state.vram, &cpu.xoChip->plane2}) {
+                for (auto& row : *plane) {
+                    for (uint8_t& pixel : row) {
+                        pixel = uint8_t(random() & 1);
+                    }
+                }
+            }
+            cpu.rehash();
+            capture.submit(cpu);
+            expected.push_back(canvasOf(cpu));
+        }
+    }
+    std::string error = checkGif(gifFilename, expected);
+    readGif(gifFilename, gif);
+    if (!error.empty()) {
+        std::cerr << "random pixels as a GIF: " << error << std::endl;
+        return 1;
+    }
+    if (gif.clears == 0) {
+        std::cerr << "the GIF code table never filled up" << std::endl;
+        return 1;
+    }
+    std::filesystem::remove(gifFilename);
+    std::filesystem::remove(y4mFilename);
+    std::cout << "Recordings decode to the frames that were on screen" << std::endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DebugConsole.h"
+
+// Checks that breakpoints, watchpoints, stepping and running frames stop Chip8::run() where they should, before the
+// instruction, and that the console lists and sets them. Exits non-zero on any difference.
+
+namespace {
+
+const std::vector<uint8_t> COUNTING_ROM = {
+    0x60, 0x01, // 200: LD V0, 1
+    0x61, 0x02, // 202: LD V1, 2
+    0x62, 0x03, // 204: LD V2, 3
+    0x70, 0x01, // 206: ADD V0, 1
+    0x12, 0x06, // 208: JP 0x206
+};
+
+const std::vector<uint8_t> STORING_ROM = {
+    0xA3, 0x00, // 200: LD I, 0x300
+    0x60, 0x05, // 202: LD V0, 5
+    0x61, 0x06, // 204: LD V1, 6
+    0xF1, 0x55, // 206: LD [I], V1
+    0x12, 0x08, // 208: JP 0x208
+};
+
+const std::vector<uint8_t> WRAPPING_ROM = {
+    0xAF, 0xFE, // 200: LD I, 0xFFE
+    0xF2, 0x55, // 202: LD [I], V2
+    0x12, 0x04, // 204: JP 0x204
+};
+
+const std::vector<uint8_t> FAULTING_ROM = {
+    0x60, 0x01, // 200: LD V0, 1
+    0xE0, 0x00, // 202: not an instruction
+};
+
+std::string checkBreakpoint() {
+    Chip8 cpu;
+    cpu.load(COUNTING_ROM.data(), COUNTING_ROM.size());
+    cpu.debugger.setBreakpoint(0x204);
+    RunResult result = cpu.run(100);
+    if (result.stop != DebugStop::Breakpoint || result.executed != 2 || cpu.state.pc != 0x204 ||
+        cpu.state.v[2] != 0 || !cpu.debugger.isPaused()) {
+        return "breakpoint: didn't stop before 0x204";
+    }
+    if (cpu.run(100).executed != 0) {
+        return "breakpoint: ran on while paused";
+    }
+    // The breakpoint stays set, but resuming from it runs its instruction
+    cpu.debugger.resume(cpu.state.pc);
+    result = cpu.run(1);
+    if (result.stop != DebugStop::None || result.executed != 1 || cpu.state.v[2] != 3 || cpu.state.pc != 0x206) {
+        return "breakpoint: resume() stopped on the same breakpoint again";
+    }
+    return "";
+}
+
+std::string checkWatchpoint() {
+    Chip8 cpu;
+    cpu.load(STORING_ROM.data(), STORING_ROM.size());
+    cpu.debugger.setWatchpoint(0x301);
+    RunResult result = cpu.run(100);
+    if (result.stop != DebugStop::Watchpoint || cpu.state.pc != 0x206 || cpu.debugger.watchHit() != 0x301) {
+        return "watchpoint: FX55 didn't stop on 0x301";
+    }
+    if (cpu.memory()[0x300] != 0 || cpu.memory()[0x301] != 0) {
+        return "watchpoint: stopped after the store";
+    }
+    cpu.debugger.resume(cpu.state.pc);
+    cpu.run(1);
+    if (cpu.memory()[0x300] != 5 || cpu.memory()[0x301] != 6) {
+        return "watchpoint: resuming didn't store";
+    }
+    return "";
+}
+
+// A store past the end of classic memory wraps to its start, watchpoint included
+std::string checkWrappingWatchpoint() {
+    Chip8 cpu;
+    cpu.load(WRAPPING_ROM.data(), WRAPPING_ROM.size());
+    cpu.debugger.setWatchpoint(0x000);
+    RunResult result = cpu.run(100);
+    if (result.stop != DebugStop::Watchpoint || cpu.state.pc != 0x202 || cpu.debugger.watchHit() != 0x000) {
+        return "watchpoint: FX55 at 0xFFE didn't stop on 0x000";
+    }
+    return "";
+}
+
+std::string checkStepping() {
+    Chip8 cpu;
+    cpu.load(COUNTING_ROM.data(), COUNTING_ROM.size());
+    cpu.debugger.step(cpu.state.pc, 3);
+    RunResult result = cpu.run(100);
+    if (result.stop != DebugStop::Step || result.executed != 3 || cpu.state.pc != 0x206) {
+        return "step: ran " + std::to_string(result.executed) + " instructions instead of 3";
+    }
+    // Two frames of 10 instructions each, as the frontend calls endFrame() after its timer tick
+    cpu.debugger.runFrames(cpu.state.pc, 2);
+    int executed = 0;
+    for (int frame = 0; frame < 3; frame++) {
+        executed += cpu.run(10).executed;
+        cpu.tickTimers();
+        cpu.debugger.endFrame();
+    }
+    if (executed != 20 || !cpu.debugger.isPaused() || cpu.debugger.lastStop() != DebugStop::Paused) {
+        return "frames: ran " + std::to_string(executed) + " instructions instead of 20";
+    }
+    return "";
+}
+
+std::string checkClear() {
+    Debugger debugger;
+    if (debugger.active()) {
+        return "clear: active before anything was set";
+    }
+    debugger.setBreakpoint(0x200);
+    debugger.setWatchpoint(0x300, 4);
+    if (!debugger.active() || !debugger.watching()) {
+        return "clear: not active with a breakpoint and a watchpoint";
+    }
+    debugger.clear();
+    if (debugger.active() || debugger.hasBreakpoint(0x200) || debugger.watches(0x300, 4)) {
+        return "clear: still active after clear()";
+    }
+    return "";
+}
+
+// FaultPolicy::Pause from a trap handler leaves the machine running, paused on the faulting instruction
+std::string checkTrap() {
+    Chip8 cpu;
+    cpu.load(FAULTING_ROM.data(), FAULTING_ROM.size());
+    cpu.faultPolicy = FaultPolicy::Trap;
+    int traps = 0;
+    cpu.trapHandler = [&traps](Chip8&, const FaultRecord&) {
+        traps++;
+        return FaultPolicy::Pause;
+    };
+    RunResult result = cpu.run(100);
+    if (result.stop != DebugStop::Fault || result.fault.fault != Fault::UnknownOpcode || traps != 1 ||
+        cpu.state.pc != 0x202 || !cpu.state.running || cpu.debugger.lastStop() != DebugStop::Fault) {
+        return "trap: didn't pause on the unknown opcode";
+    }
+    return "";
+}
+
+std::string checkConsole() {
+    Chip8 cpu;
+    cpu.load(COUNTING_ROM.data(), COUNTING_ROM.size());
+    std::istringstream in;
+    std::ostringstream out;
+    DebugConsole console(cpu, in, out);
+    if (!console.execute("b 204") || !cpu.debugger.hasBreakpoint(0x204) || console.execute("nonsense")) {
+        return "console: b 204 didn't set a breakpoint";
+    }
+    console.execute("l 200 3");
+    if (out.str().find("*0x204  6203  LD V2, 0x03") == std::string::npos) {
+        return "console: unexpected listing\n" + out.str();
+    }
+    // The last instruction in memory has no word after it
+    cpu.memory()[MEMORY_SIZE - 2] = 0x00;
+    cpu.memory()[MEMORY_SIZE - 1] = 0xE0;
+    out.str("");
+    console.execute("l FFE");
+    if (out.str().find("0xFFE  00E0") == std::string::npos) {
+        return "console: didn't list the last instruction\n" + out.str();
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors = {
+        checkBreakpoint(),
+        checkWatchpoint(),
+        checkWrappingWatchpoint(),
+        checkStepping(),
+        checkClear(),
+        checkTrap(),
+        checkConsole(),
+    };
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Stopped at breakpoints, watchpoints, steps, frames and traps" << std::endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Disassembly.h"
+
+// Disassembles small hand-built programs and checks what each byte turned out to be, where the basic blocks start
+// and end and where they lead. Exits non-zero on any difference.
+
+namespace {
+
+// The program at PROGRAM_OFFSET, with the memory before it zeroed like the interpreter area
+Disassembly disassemble(const std::vector<uint8_t>& program) {
+    std::vector<uint8_t> memory(PROGRAM_OFFSET, 0);
+    memory.insert(memory.end(), program.begin(), program.end());
+    return Disassembly(memory.data(), int(memory.size()));
+}
+
+const char* kindName(ByteKind kind) {
+    switch (kind) {
+    case ByteKind::Code:
+        return "code";
+    case ByteKind::Operand:
+        return "operand";
+    case ByteKind::Data:
+        return "data";
+    default:
+        return "unknown";
+    }
+}
+
+// kinds holds one ByteKind per byte of the program
+std::string checkKinds(const Disassembly& disassembly, const std::vector<ByteKind>& kinds, const std::string& name) {
+    for (size_t n = 0; n < kinds.size(); n++) {
+        uint16_t address = uint16_t(PROGRAM_OFFSET + n);
+        if (disassembly.kind(address) != kinds[n]) {
+            std::stringstream error;
+            error << name << ": 0x" << std::hex << address << " is " << kindName(disassembly.kind(address))
+                  << " instead of " << kindName(kinds[n]);
+            return error.str();
+        }
+    }
+    return "";
+}
+
+struct ExpectedBlock {
+    uint16_t start;
+    uint16_t end;
+    std::vector<uint16_t> successors;
+};
+
+std::string checkBlocks(const Disassembly& disassembly, const std::vector<ExpectedBlock>& blocks,
+                        const std::string& name) {
+    if (disassembly.blocks().size() != blocks.size()) {
+        return name + ": " + std::to_string(disassembly.blocks().size()) + " blocks instead of " +
+               std::to_string(blocks.size());
+    }
+    for (size_t n = 0; n < blocks.size(); n++) {
+        const BasicBlock& block = disassembly.blocks()[n];
+        if (block.start != blocks[n].start || block.end != blocks[n].end) {
+            std::stringstream error;
+            error << name << ": block " << n << " is 0x" << std::hex << block.start << "-0x" << block.end
+                  << " instead of 0x" << blocks[n].start << "-0x" << blocks[n].end;
+            return error.str();
+        }
+        if (block.successors != blocks[n].successors) {
+            std::stringstream error;
+            error << name << ": block 0x" << std::hex << block.start << " leads to";
+            for (uint16_t successor : block.successors) {
+                error << " 0x" << successor;
+            }
+            return error.str();
+        }
+    }
+    return "";
+}
+
+std::string listing(const Disassembly& disassembly) {
+    std::stringstream out;
+    disassembly.writeListing(out);
+    return out.str();
+}
+
+// Both sides of a skip over the only 4 byte instruction, whose second word points at data
+std::string checkSkipOverLongLoad() {
+    Disassembly disassembly = disassemble({
+        0x30, 0x00, // 200: SE V0, 0
+        0xF0, 0x00, 0x02, 0x08, // 202: LD I, 0x208
+        0x00, 0xFD, // 206: EXIT
+        0x12, 0x34, // 208: data
+    });
+    std::string error = checkKinds(disassembly, {
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand, ByteKind::Operand, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Data, ByteKind::Data,
+    }, "skip");
+    if (!error.empty()) {
+        return error;
+    }
+    return checkBlocks(disassembly, {
+        {0x200, 0x202, {0x202, 0x206}}, // the skip lands after all 4 bytes
+        {0x202, 0x206, {0x206}},
+        {0x206, 0x208, {}},
+    }, "skip");
+}
+
+std::string checkCallAndReturn() {
+    Disassembly disassembly = disassemble({
+        0x22, 0x06, // 200: CALL 0x206
+        0x12, 0x02, // 202: JP 0x202
+        0x12, 0x34, // 204: never reached
+        0x60, 0x01, // 206: LD V0, 1
+        0x00, 0xEE, // 208: RET
+    });
+    std::string error = checkKinds(disassembly, {
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Unknown, ByteKind::Unknown,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+    }, "call");
+    if (!error.empty()) {
+        return error;
+    }
+    error = checkBlocks(disassembly, {
+        {0x200, 0x202, {0x202}}, // the return address, the call itself is kept apart
+        {0x202, 0x204, {0x202}},
+        {0x206, 0x20A, {}},
+    }, "call");
+    if (!error.empty()) {
+        return error;
+    }
+    const BasicBlock& caller = disassembly.blocks()[0];
+    if (!caller.endsWithCall || caller.call != 0x206 || disassembly.subroutines() != std::vector<uint16_t>{0x206}) {
+        return "call: the call to 0x206 wasn't recorded";
+    }
+    std::string text = listing(disassembly);
+    if (text.find("sub_206:\n") == std::string::npos || text.find("??    DB 0x12, 0x34\n") == std::string::npos) {
+        return "call: unexpected listing\n" + text;
+    }
+    return "";
+}
+
+// Only BNNN's own target can be followed, whatever V0 holds
+std::string checkIndirectJump() {
+    Disassembly disassembly = disassemble({
+        0x60, 0x02, // 200: LD V0, 2
+        0xB2, 0x06, // 202: JP V0, 0x206
+        0x00, 0xFD, // 204: never reached
+        0x00, 0xFD, // 206: EXIT
+        0x00, 0xFD, // 208: where the jump really goes
+    });
+    std::string error = checkKinds(disassembly, {
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Unknown, ByteKind::Unknown,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Unknown, ByteKind::Unknown,
+    }, "indirect jump");
+    if (!error.empty()) {
+        return error;
+    }
+    error = checkBlocks(disassembly, {
+        {0x200, 0x204, {0x206}},
+        {0x206, 0x208, {}},
+    }, "indirect jump");
+    if (error.empty() && !disassembly.blocks()[0].endsWithIndirectJump) {
+        return "indirect jump: the block doesn't end with one";
+    }
+    return error;
+}
+
+// A sprite loaded with ANNN, from its address up to the end of the program
+std::string checkDataReference() {
+    Disassembly disassembly = disassemble({
+        0xA2, 0x08, // 200: LD I, 0x208
+        0xD0, 0x15, // 202: DRW V0, V1, 5
+        0x12, 0x04, // 204: JP 0x204
+        0x00, 0x00, // 206: padding, never referenced
+        0xF0, 0x90, 0xF0, 0x90, 0x90, // 208: a zero
+    });
+    std::string error = checkKinds(disassembly, {
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Code, ByteKind::Operand,
+        ByteKind::Unknown, ByteKind::Unknown,
+        ByteKind::Data, ByteKind::Data, ByteKind::Data, ByteKind::Data, ByteKind::Data,
+    }, "data");
+    if (!error.empty()) {
+        return error;
+    }
+    error = checkBlocks(disassembly, {
+        {0x200, 0x204, {0x204}},
+        {0x204, 0x206, {0x204}},
+    }, "data");
+    if (!error.empty()) {
+        return error;
+    }
+    if (disassembly.bytesOf(ByteKind::Data) != 5) {
+        return "data: " + std::to_string(disassembly.bytesOf(ByteKind::Data)) + " data bytes instead of 5";
+    }
+    std::string text = listing(disassembly);
+    if (text.find("data_208:\n    0x208            DB 0xF0, 0x90, 0xF0, 0x90, 0x90\n") == std::string::npos) {
+        return "data: unexpected listing\n" + text;
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors = {
+        checkSkipOverLongLoad(),
+        checkCallAndReturn(),
+        checkIndirectJump(),
+        checkDataReference(),
+    };
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Disassembled " << errors.size() << " programs" << std::endl;
+    return 0;
+}
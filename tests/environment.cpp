@@ -0,0 +1,282 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "yachie_env.h"
+
+// Drives the environments through the C API: actions reach the ROM, episodes end and restart, observations are
+// packed, downsampled and pooled over frames, rewards follow memory and probe programs, and results don't depend on
+// the number of threads. Exits non-zero on the first failure.
+
+namespace {
+
+// Waits for a key and shows its digit at the top left, forever
+const std::vector<uint8_t> DIGIT_ROM = {
+    0xF0, 0x0A, // LD V0, K
+    0x00, 0xE0, // CLS
+    0xF0, 0x29, // LD F, V0
+    0xD1, 0x15, // DRW V1, V1, 5
+    0x12, 0x00, // JP 0x200
+};
+// Draws a random byte as a sprite and exits, so episodes end and the seed shows
+const std::vector<uint8_t> RANDOM_ROM = {
+    0xC0, 0xFF, // RND V0, 0xFF
+    0xA3, 0x00, // LD I, 0x300
+    0xF0, 0x55, // LD [I], V0
+    0xD1, 0x11, // DRW V1, V1, 1
+    0x00, 0xFD, // EXIT
+};
+// Counts frames into V0 with instructions_per_frame at 3, and writes the count's digits to 0x300
+const std::vector<uint8_t> COUNTER_ROM = {
+    0xA3, 0x00, // LD I, 0x300
+    0x70, 0x01, // ADD V0, 1
+    0xF0, 0x33, // LD B, V0
+    0x12, 0x02, // JP 0x202
+};
+// Draws and erases the top of the 0 glyph in alternate frames, with instructions_per_frame at 2
+const std::vector<uint8_t> FLICKER_ROM = {
+    0xF0, 0x29, // LD F, V0
+    0xD0, 0x01, // DRW V0, V0, 1
+    0x12, 0x02, // JP 0x202
+};
+constexpr int ENVIRONMENTS = 37; // not a multiple of the threads
+constexpr uint8_t FONT_TOP_ROWS[] = {0xF0, 0x20, 0xF0, 0xF0, 0x90, 0xF0, 0xF0, 0xF0,
+                                     0xF0, 0xF0, 0xF0, 0xE0, 0xF0, 0xE0, 0xF0, 0xF0};
+
+yachie_env* create(const std::vector<uint8_t>& rom, const char* quirks, int maxFrames, int threads) {
+    yachie_env_config config = yachie_env_default_config();
+    config.quirks = quirks;
+    config.max_episode_frames = maxFrames;
+    config.threads = threads;
+    return yachie_env_create(rom.data(), rom.size(), ENVIRONMENTS, &config);
+}
+
+std::string checkDigits() {
+    yachie_env* env = create(DIGIT_ROM, nullptr, 0, 4);
+    int size = yachie_env_observation_size(env);
+    if (size != 64 * 32) {
+        return "observations are " + std::to_string(size) + " bytes";
+    }
+    std::vector<uint8_t> observations(size_t(ENVIRONMENTS * size));
+    std::vector<uint8_t> dones(ENVIRONMENTS);
+    std::vector<int32_t> actions(ENVIRONMENTS);
+    for (int n = 0; n < ENVIRONMENTS; n++) {
+        actions[size_t(n)] = n % 17 - 1; // YACHIE_ENV_NO_KEY, then each key
+    }
+    yachie_env_reset(env, 0, observations.data());
+    // FX0A starts waiting in the first frame and takes the key held in the second
+    yachie_env_step(env, actions.data(), observations.data(), nullptr, dones.data());
+    yachie_env_step(env, actions.data(), observations.data(), nullptr, dones.data());
+    yachie_env_destroy(env);
+    for (int n = 0; n < ENVIRONMENTS; n++) {
+        const uint8_t* observation = observations.data() + n * size;
+        uint8_t top = 0;
+        for (int x = 0; x < 8; x++) {
+            top = uint8_t(top | observation[x] << (7 - x));
+        }
+        int key = actions[size_t(n)];
+        if (top != (key == YACHIE_ENV_NO_KEY ? 0 : FONT_TOP_ROWS[key]) || dones[size_t(n)] != YACHIE_ENV_RUNNING) {
+            return "environment " + std::to_string(n) + " didn't show the digit of key " + std::to_string(key);
+        }
+    }
+    return "";
+}
+
+std::string checkEpisodes() {
+    // 00FD ends an episode on its first frame, the frame limit on the third
+    yachie_env* halting = create(RANDOM_ROM, "schip", 0, 2);
+    yachie_env* truncated = create(DIGIT_ROM, nullptr, 3, 2);
+    int size = 128 * 64;
+    std::vector<uint8_t> observations(size_t(ENVIRONMENTS * size));
+    std::vector<uint8_t> dones(ENVIRONMENTS);
+    std::vector<int32_t> actions(ENVIRONMENTS, YACHIE_ENV_NO_KEY);
+    yachie_env_reset(halting, 1, observations.data());
+    yachie_env_reset(truncated, 1, observations.data());
+    for (int frame = 1; frame <= 6; frame++) {
+        yachie_env_step(halting, actions.data(), observations.data(), nullptr, dones.data());
+        if (dones[0] != YACHIE_ENV_TERMINATED) {
+            return "a halted machine wasn't terminated in frame " + std::to_string(frame);
+        }
+        yachie_env_step(truncated, actions.data(), observations.data(), nullptr, dones.data());
+        uint8_t expected = frame % 3 == 0 ? YACHIE_ENV_TRUNCATED : YACHIE_ENV_RUNNING;
+        if (dones[0] != expected) {
+            return "frame " + std::to_string(frame) + " ended with " + std::to_string(dones[0]);
+        }
+    }
+    yachie_env_destroy(halting);
+    yachie_env_destroy(truncated);
+    return "";
+}
+
+// A packed observation's first byte is the top row of the digit, and downsampling by 4 ORs it into two pixels
+std::string checkFormats() {
+    yachie_env_config config = yachie_env_default_config();
+    config.observation_format = YACHIE_ENV_PACKED;
+    config.frame_skip = 2; // FX0A starts waiting in the first frame and takes the key held in the second
+    yachie_env* packed = yachie_env_create(DIGIT_ROM.data(), DIGIT_ROM.size(), ENVIRONMENTS, &config);
+    config.observation_format = YACHIE_ENV_PIXELS;
+    config.downsample = 4;
+    yachie_env* downsampled = yachie_env_create(DIGIT_ROM.data(), DIGIT_ROM.size(), ENVIRONMENTS, &config);
+    if (yachie_env_observation_size(packed) != 64 * 32 / 8 || yachie_env_observation_width(downsampled) != 16 ||
+        yachie_env_observation_size(downsampled) != 16 * 8) {
+        return "packed or downsampled observations have the wrong size";
+    }
+    std::vector<uint8_t> bits(size_t(ENVIRONMENTS * yachie_env_observation_size(packed)));
+    std::vector<uint8_t> pixels(size_t(ENVIRONMENTS * yachie_env_observation_size(downsampled)));
+    std::vector<uint8_t> dones(ENVIRONMENTS);
+    std::vector<int32_t> actions(ENVIRONMENTS);
+    for (int n = 0; n < ENVIRONMENTS; n++) {
+        actions[size_t(n)] = n % 17 - 1;
+    }
+    yachie_env_reset(packed, 0, bits.data());
+    yachie_env_reset(downsampled, 0, pixels.data());
+    yachie_env_step(packed, actions.data(), bits.data(), nullptr, dones.data());
+    yachie_env_step(downsampled, actions.data(), pixels.data(), nullptr, dones.data());
+    const int packedSize = yachie_env_observation_size(packed);
+    yachie_env_destroy(packed);
+    yachie_env_destroy(downsampled);
+    for (int n = 0; n < ENVIRONMENTS; n++) {
+        int key = actions[size_t(n)];
+        uint8_t top = key == YACHIE_ENV_NO_KEY ? 0 : FONT_TOP_ROWS[key];
+        if (bits[size_t(n * packedSize)] != top) {
+            return "packed environment " + std::to_string(n) + " didn't show the digit of key " + std::to_string(key);
+        }
+        // Glyphs are 4 pixels wide and 5 high, so they light the first block of the first two rows of blocks
+        const uint8_t* observation = pixels.data() + n * 16 * 8;
+        uint8_t expected = key != YACHIE_ENV_NO_KEY;
+        if (observation[0] != expected || observation[16] != expected || observation[1] != 0) {
+            return "downsampled environment " + std::to_string(n) + " is wrong for key " + std::to_string(key);
+        }
+    }
+    return "";
+}
+
+// A sprite that's only on screen in odd frames shows with max_over_frames, and a BCD counter of frames gives rewards
+std::string checkFramesAndRewards() {
+    yachie_env_config config = yachie_env_default_config();
+    config.instructions_per_frame = 2;
+    config.frame_skip = 2;
+    yachie_env* plain = yachie_env_create(FLICKER_ROM.data(), FLICKER_ROM.size(), 1, &config);
+    config.max_over_frames = 1;
+    yachie_env* pooled = yachie_env_create(FLICKER_ROM.data(), FLICKER_ROM.size(), 1, &config);
+    std::vector<uint8_t> observation(64 * 32);
+    uint8_t done = 0;
+    int32_t action = YACHIE_ENV_NO_KEY;
+    for (int step = 0; step < 3; step++) {
+        yachie_env_step(plain, &action, observation.data(), nullptr, &done);
+        if (observation[0] != 0) {
+            return "the sprite is still there after an even number of frames";
+        }
+        yachie_env_step(pooled, &action, observation.data(), nullptr, &done);
+        if (observation[0] != 1 || observation[3] != 1 || observation[4] != 0) {
+            return "max_over_frames lost the flickering sprite";
+        }
+    }
+    yachie_env_destroy(plain);
+    yachie_env_destroy(pooled);
+
+    // The whole count is worth 0.5 a frame, and its last digit, scaled by -1, goes 5, 0, 5...
+    yachie_env_probe probes[] = {{0x300, 3, YACHIE_ENV_DIGITS, 0.5f}, {0x302, 1, YACHIE_ENV_BINARY, -1}};
+    config = yachie_env_default_config();
+    config.instructions_per_frame = 3;
+    config.frame_skip = 5;
+    config.reward_probes = probes;
+    config.reward_probe_count = 2;
+    yachie_env* counter = yachie_env_create(COUNTER_ROM.data(), COUNTER_ROM.size(), 1, &config);
+    float reward = 0;
+    for (int step = 1; step <= 6; step++) {
+        yachie_env_step(counter, &action, observation.data(), &reward, &done);
+        float expected = 2.5f + (step % 2 == 0 ? 5 : -5);
+        if (reward != expected) {
+            return "step " + std::to_string(step) + " got a reward of " + std::to_string(reward);
+        }
+    }
+    yachie_env_destroy(counter);
+    probes[0].bytes = 5;
+    config.reward_probe_count = 1;
+    if (yachie_env_create(COUNTER_ROM.data(), COUNTER_ROM.size(), 1, &config) != nullptr) {
+        return "a 5 byte reward probe was accepted";
+    }
+    return "";
+}
+
+// A probe program's reward counts every frame, its score every step and its done ends the episode mid-step
+std::string checkProbeProgram() {
+    yachie_env_config config = yachie_env_default_config();
+    config.instructions_per_frame = 3;
+    config.frame_skip = 3;
+    config.probes = "score = bcd(mem[0x300..0x302])\ndone = v[0] == 7; reward = 1";
+    yachie_env* env = yachie_env_create(COUNTER_ROM.data(), COUNTER_ROM.size(), 1, &config);
+    if (env == nullptr) {
+        return std::string("the probe program didn't compile: ") + yachie_env_error();
+    }
+    std::vector<uint8_t> observation(64 * 32);
+    float reward = 0;
+    uint8_t done = 0;
+    int32_t action = YACHIE_ENV_NO_KEY;
+    const float expectedRewards[] = {6, 6, 2};
+    for (int step = 0; step < 3; step++) {
+        yachie_env_step(env, &action, observation.data(), &reward, &done);
+        if (reward != expectedRewards[step] || done != (step == 2 ? YACHIE_ENV_TERMINATED : YACHIE_ENV_RUNNING)) {
+            return "step " + std::to_string(step) + " got a reward of " + std::to_string(reward) + " and done " +
+                   std::to_string(done);
+        }
+    }
+    int64_t score = 0;
+    if (yachie_env_probe_values(env, "score", &score) != 0 || score != 7 ||
+        yachie_env_probe_values(env, "lives", &score) != -1) {
+        return "the probe values are wrong";
+    }
+    yachie_env_destroy(env);
+    config.probes = "score = mem[0x300] +";
+    if (yachie_env_create(COUNTER_ROM.data(), COUNTER_ROM.size(), 1, &config) != nullptr ||
+        std::string(yachie_env_error()).find("line 1") == std::string::npos) {
+        return "a probe program that doesn't compile was accepted";
+    }
+    return "";
+}
+
+// Random actions on a real ROM and episodes reseeded by the restarts give the same results on any number of threads
+std::string checkThreads() {
+    std::vector<std::vector<uint8_t>> results;
+    for (int threads : {1, 3}) {
+        yachie_env* env = create(RANDOM_ROM, "schip", 0, threads);
+        int size = yachie_env_observation_size(env);
+        std::vector<uint8_t> observations(size_t(ENVIRONMENTS * size));
+        std::vector<uint8_t> dones(ENVIRONMENTS);
+        std::vector<int32_t> actions(ENVIRONMENTS);
+        std::mt19937 rng(7);
+        std::vector<uint8_t> result;
+        yachie_env_reset(env, 42, observations.data());
+        for (int frame = 0; frame < 20; frame++) {
+            for (int32_t& action : actions) {
+                action = int32_t(rng() % 17) - 1;
+            }
+            yachie_env_step(env, actions.data(), observations.data(), nullptr, dones.data());
+            result.insert(result.end(), observations.begin(), observations.end());
+            result.insert(result.end(), dones.begin(), dones.end());
+        }
+        yachie_env_destroy(env);
+        results.push_back(result);
+    }
+    return results[0] == results[1] ? "" : "one thread and three disagree";
+}
+
+} // namespace
+
+int main() {
+    if (create(DIGIT_ROM, "pdp11", 0, 1) != nullptr || std::string(yachie_env_error()).empty()) {
+        std::cerr << "an unknown quirk profile was accepted" << std::endl;
+        return 1;
+    }
+    for (auto check : {checkDigits, checkEpisodes, checkFormats, checkFramesAndRewards, checkProbeProgram,
+                        checkThreads}) {
+        std::string error = check();
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "The environments behave" << std::endl;
+    return 0;
+}
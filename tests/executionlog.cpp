@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "Chip8.h"
+
+// Runs a short XO-CHIP program, writes its execution log and reads it back, checking every record, the registers
+// that several-register loads (FX65, 5XY3) left behind and the registers at the time of writing. Exits non-zero on
+// any difference.
+
+namespace {
+
+const std::vector<uint8_t> LOADING_ROM = {
+    0xA2, 0x0C, // 200: LD I, 0x20C
+    0x54, 0x73, // 202: LD V4-V7, [I]
+    0xF3, 0x65, // 204: LD V3, [I], which moves I past the data with this profile
+    0x6F, 0x09, // 206: LD VF, 9
+    0x12, 0x08, // 208: JP 0x208
+    0x00, 0x00, // 20A: padding
+    0x11, 0x22, 0x33, 0x44, // 20C: data
+};
+constexpr int INSTRUCTIONS = 6; // the loop at 0x208 runs twice
+
+std::string checkRoundTrip() {
+    Chip8 cpu;
+    cpu.quirkProfile = QuirkProfile::XoChip;
+    cpu.load(LOADING_ROM.data(), LOADING_ROM.size());
+    cpu.run(INSTRUCTIONS);
+    std::string filename = "/tmp/yachie-log-test-" + std::to_string(getpid()) + ".ylog";
+    if (!cpu.writeExecutionLog(filename)) {
+        return "couldn't write " + filename;
+    }
+    ExecutionLog::Registers registers {};
+    std::vector<ExecutionLog::Record> records;
+    uint64_t executed = 0;
+    bool read = ExecutionLog::read(filename, registers, records, executed);
+    std::remove(filename.c_str());
+    if (!read) {
+        return "couldn't read back " + filename;
+    }
+    if (executed != INSTRUCTIONS || records.size() != INSTRUCTIONS) {
+        return "read back " + std::to_string(records.size()) + " of " + std::to_string(executed) +
+               " instructions instead of " + std::to_string(INSTRUCTIONS);
+    }
+    const std::vector<uint16_t> pcs = {0x200, 0x202, 0x204, 0x206, 0x208, 0x208};
+    const std::vector<uint16_t> opcodes = {0xA20C, 0x5473, 0xF365, 0x6F09, 0x1208, 0x1208};
+    const std::vector<uint16_t> is = {0x20C, 0x20C, 0x210, 0x210, 0x210, 0x210};
+    for (size_t n = 0; n < records.size(); n++) {
+        if (records[n].pc != pcs[n] || records[n].opcode != opcodes[n] || records[n].i != is[n]) {
+            return "record " + std::to_string(n) + " doesn't match the instruction executed";
+        }
+    }
+    const ExecutionLog::Record& xy3 = records[1];
+    const ExecutionLog::Record& fx65 = records[2];
+    if (xy3.v[4] != 0x11 || xy3.v[7] != 0x44 || xy3.v[0] != 0 || fx65.v[0] != 0x11 || fx65.v[3] != 0x44 ||
+        records[3].v[0xF] != 9) {
+        return "the registers loaded weren't logged";
+    }
+    int first = 0;
+    int last = 0;
+    ExecutionLog::writtenRegisters(fx65.opcode, first, last);
+    if (first != 0 || last != 3) {
+        return "FX65 isn't logged as writing V0-V3";
+    }
+    ExecutionLog::writtenRegisters(0x5743, first, last); // 5XY3 loads backwards when X > Y
+    if (first != 4 || last != 7) {
+        return "5XY3 isn't logged as writing V4-V7";
+    }
+    if (registers.pc != 0x208 || registers.i != 0x210 || registers.v[7] != 0x44 || registers.v[0xF] != 9) {
+        return "the registers at the time of writing don't match";
+    }
+    return "";
+}
+
+std::string checkNotALog() {
+    std::string filename = "/tmp/yachie-log-test-" + std::to_string(getpid()) + ".txt";
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    std::fputs("not a log", file);
+    std::fclose(file);
+    ExecutionLog::Registers registers {};
+    std::vector<ExecutionLog::Record> records;
+    uint64_t executed = 0;
+    bool read = ExecutionLog::read(filename, registers, records, executed);
+    std::remove(filename.c_str());
+    return read ? "read a file that isn't an execution log" : "";
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors = {
+        checkRoundTrip(),
+        checkNotALog(),
+    };
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Read back the execution log of " << INSTRUCTIONS << " instructions" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Explorer.h"
+
+// Checks that the explorer finds every screen of a ROM whose screens are known, with the shortest inputs, and that
+// the screens it finds within a depth and the inputs reaching them don't depend on how many threads search. Exits
+// non-zero on any difference.
+
+namespace {
+
+// Waits for a key and shows its digit, forever, so there are 17 screens: the blank one and one per key
+const std::vector<uint8_t> DIGIT_ROM = {
+    0xF0, 0x0A, // LD V0, K
+    0x00, 0xE0, // CLS
+    0xF0, 0x29, // LD F, V0
+    0xD1, 0x15, // DRW V1, V1, 5
+    0x12, 0x00, // JP 0x200
+};
+const std::string SEARCHED_ROM = std::string(YACHIE_ROM_DIR) + "/PONG";
+
+std::string checkDigits(const ExploreOptions& options, const std::string& name) {
+    ExploreResult result = Explorer(options).run([](Chip8& cpu) {
+        cpu.load(DIGIT_ROM.data(), DIGIT_ROM.size());
+    });
+    if (!result.exhausted || result.screens.size() != NUMBER_OF_KEYS + 1) {
+        return name + ": found " + std::to_string(result.screens.size()) + " screens instead of 17";
+    }
+    if (!result.screens[0].inputs.empty()) {
+        return name + ": the first screen isn't the blank one from the start";
+    }
+    for (int key = 0; key < NUMBER_OF_KEYS; key++) {
+        const Screen& screen = result.screens[size_t(key) + 1];
+        if (screen.inputs != std::vector<int8_t>{int8_t(key)}) {
+            return name + ": key " + std::to_string(key) + " took " + Explorer::formatInputs(screen.inputs);
+        }
+        // The top row of the digit's glyph
+        for (int x = 0; x < 8; x++) {
+            bool lit = (FONT_SET[key * 5] >> (7 - x) & 1) != 0;
+            if ((screen.pixels[size_t(x)] != 0) != lit) {
+                return name + ": key " + std::to_string(key) + " shows the wrong digit";
+            }
+        }
+    }
+    return "";
+}
+
+std::vector<std::pair<uint64_t, std::vector<int8_t>>> searchScreens(int threads) {
+    ExploreOptions options;
+    options.maxDepth = 6;
+    options.holdFrames = 30; // half a second, PONG takes a while to start
+    options.keys = 1 << 0x1 | 1 << 0x4 | 1 << 0xC; // the paddles
+    options.threads = threads;
+    ExploreResult result = Explorer(options).run([](Chip8& cpu) {
+        cpu.load(SEARCHED_ROM);
+        cpu.seedRandom(0);
+    });
+    std::vector<std::pair<uint64_t, std::vector<int8_t>>> screens;
+    for (const Screen& screen : result.screens) {
+        screens.emplace_back(screen.hash, screen.inputs);
+    }
+    return screens;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors;
+    ExploreOptions options;
+    options.maxDepth = 3;
+    for (int threads : {1, 4}) {
+        options.threads = threads;
+        options.bestFirst = false;
+        errors.push_back(checkDigits(options, "breadth-first with " + std::to_string(threads) + " threads"));
+        options.bestFirst = true;
+        options.maxDepth = 1; // only shortest paths are certain to be found first
+        errors.push_back(checkDigits(options, "best-first with " + std::to_string(threads) + " threads"));
+        options.maxDepth = 3;
+    }
+    auto single = searchScreens(1);
+    auto parallel = searchScreens(4);
+    if (single != parallel || single.size() < 2) {
+        errors.push_back("PONG: " + std::to_string(single.size()) + " screens with one thread, " +
+                         std::to_string(parallel.size()) + " with four");
+    }
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Explored the digit ROM and " << single.size() << " screens of PONG" << std::endl;
+    return 0;
+}
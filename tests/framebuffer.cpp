@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include "Framebuffer.h"
+
+// Converts VRAM through palettes and fades frames with phosphor persistence, checking the vectorized pass against
+// the plain definition. Exits non-zero on the first failure.
+
+namespace {
+
+std::string checkPalettes() {
+    Palette palette;
+    for (const char* name : {"grey", "green", "amber", "octo", "lcd", "000000,FFFFFF", "102030,A0B0C0,ff0000,00ff00"}) {
+        if (!parsePalette(name, palette)) {
+            return std::string("didn't parse ") + name;
+        }
+    }
+    for (const char* text : {"", "blue", "000000", "000000,FFFFFF,FF0000", "000000,FFFFFG", "000000,FFFFFF,",
+                             "0,1", "000000,FFFFFF,FF0000,00FF00,0000FF"}) {
+        if (parsePalette(text, palette)) {
+            return std::string("parsed ") + text;
+        }
+    }
+    parsePalette("000000,FFFFFF", palette);
+    if (palette[0][0] != 0 || palette[1][0] != 0xFF || palette[2][0] != 0xAA || palette[3][0] != 0x55) {
+        return "two colors aren't shaded like PLANE_LEVELS";
+    }
+
+    vram_t vram {};
+    vram_t plane2 {};
+    vram[0][1] = 1;
+    plane2[0][2] = 1;
+    vram[0][3] = plane2[0][3] = 1;
+    parsePalette("102030,A0B0C0,FF0000,00FF00", palette);
+    pixels_t pixels;
+    vramToPixels(vram, &plane2, pixels, HIRES_WIDTH, HIRES_HEIGHT, palette);
+    for (size_t pixel = 0; pixel < 4; pixel++) {
+        if (!std::equal(palette[pixel].begin(), palette[pixel].end(), pixels.begin() + long(pixel) * BYTES_PER_PIXEL)) {
+            return "pixel " + std::to_string(pixel) + " isn't its planes' color";
+        }
+    }
+    return "";
+}
+
+// The plain definition of decayPixels(), one pixel at a time
+void fadePixels(const pixels_t& current, pixels_t& shown, size_t size, int decay, const Palette& palette) {
+    for (size_t n = 0; n < size; n += BYTES_PER_PIXEL) {
+        const bool lit = !std::equal(palette[0].begin(), palette[0].end(), current.begin() + long(n));
+        for (size_t channel = 0; channel < BYTES_PER_PIXEL; channel++) {
+            const int background = palette[0][channel];
+            const int offset = shown[n + channel] - background;
+            const int faded = offset < 0 ? -(-offset * decay / 256) : offset * decay / 256;
+            shown[n + channel] = lit ? current[n + channel] : uint8_t(background + faded);
+        }
+    }
+}
+
+std::string checkPersistence() {
+    std::mt19937 random(1);
+    Palette lcd;
+    parsePalette("lcd", lcd);
+    for (int frames : {1, 2, 4, 8, 30}) {
+        const int decay = persistenceDecay(frames);
+        pixels_t current;
+        pixels_t shown;
+        for (const Palette& palette : {GREY_PALETTE, lcd}) {
+            for (int width : {DISPLAY_WIDTH, HIRES_WIDTH}) {
+                const int height = width / 2;
+                const size_t size = size_t(width * height * BYTES_PER_PIXEL);
+                for (size_t n = 0; n < size; n += BYTES_PER_PIXEL) {
+                    const auto& color = palette[random() % 4];
+                    std::copy(color.begin(), color.end(), current.begin() + long(n));
+                    for (size_t channel = n; channel < n + BYTES_PER_PIXEL; channel++) {
+                        shown[channel] = uint8_t(random());
+                    }
+                }
+                pixels_t expected = shown;
+                fadePixels(current, expected, size, decay, palette);
+                decayPixels(current, shown, width, height, decay, palette);
+                if (!std::equal(expected.begin(), expected.begin() + long(size), shown.begin())) {
+                    return "the faded pixels differ from the definition, over " + std::to_string(frames) + " frames";
+                }
+            }
+        }
+
+        // A pixel lit for one frame is down to about a sixteenth after the frames, then fades out completely
+        vramToPixels(vram_t {}, nullptr, current, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        shown.fill(0xFF);
+        for (int frame = 0; frame < frames; frame++) {
+            decayPixels(current, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, decay);
+        }
+        if (shown[0] < 0x08 || shown[0] > 0x18) {
+            return "after " + std::to_string(frames) + " frames a pixel is at " + std::to_string(shown[0]);
+        }
+        for (int frame = 0; frame < 40 * frames; frame++) {
+            decayPixels(current, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, decay);
+        }
+        if (shown[0] != 0) {
+            return "a pixel never fades out over " + std::to_string(frames) + " frames";
+        }
+    }
+    // However long the persistence, pixels still fade
+    if (persistenceDecay(1 << 20) != 255) {
+        return "very long persistence decays by " + std::to_string(persistenceDecay(1 << 20)) + " rather than 255";
+    }
+    return persistenceDecay(0) == 0 ? "" : "no persistence still fades";
+}
+
+// With dark pixels on a light background, lit pixels still show at once and fade back to the background when cleared
+std::string checkLightBackground() {
+    Palette lcd;
+    parsePalette("lcd", lcd);
+    const int decay = persistenceDecay(4);
+    vram_t vram {};
+    pixels_t current;
+    pixels_t shown;
+    vramToPixels(vram, nullptr, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, lcd);
+    vram[0][0] = 1;
+    vramToPixels(vram, nullptr, current, DISPLAY_WIDTH, DISPLAY_HEIGHT, lcd);
+    decayPixels(current, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, decay, lcd);
+    if (!std::equal(lcd[1].begin(), lcd[1].end(), shown.begin())) {
+        return "a lit pixel doesn't show at once on a light background";
+    }
+    vram[0][0] = 0;
+    vramToPixels(vram, nullptr, current, DISPLAY_WIDTH, DISPLAY_HEIGHT, lcd);
+    decayPixels(current, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, decay, lcd);
+    for (size_t channel = 0; channel < 2; channel++) { // lcd's blue doesn't change
+        if (shown[channel] <= lcd[1][channel] || shown[channel] >= lcd[0][channel]) {
+            return "a cleared pixel isn't fading towards a light background";
+        }
+    }
+    for (int frame = 0; frame < 40 * 4; frame++) {
+        decayPixels(current, shown, DISPLAY_WIDTH, DISPLAY_HEIGHT, decay, lcd);
+    }
+    if (!std::equal(lcd[0].begin(), lcd[0].end(), shown.begin())) {
+        return "a cleared pixel never fades out on a light background";
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    for (auto check : {checkPalettes, checkPersistence, checkLightBackground}) {
+        std::string error = check();
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Palettes and persistence render as expected" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "GdbServer.h"
+
+// Talks to the GDB stub over its Unix socket like a client would, while another thread runs the machine and polls
+// the stub like the frontend does. Checks the replies to each packet and the stop replies. Exits non-zero on any
+// difference.
+
+namespace {
+
+constexpr int REPLY_TIMEOUT_S = 5; // a reply that takes this long isn't coming
+constexpr int INSTRUCTIONS_PER_POLL = 50;
+
+const std::vector<uint8_t> LOOPING_ROM = {
+    0x60, 0x01, // 200: LD V0, 1
+    0xA3, 0x00, // 202: LD I, 0x300
+    0x70, 0x01, // 204: ADD V0, 1
+    0x12, 0x04, // 206: JP 0x204
+};
+
+class Client {
+public:
+    bool connect(const std::string& path) {
+        sockaddr_un remote {};
+        remote.sun_family = AF_UNIX;
+        path.copy(remote.sun_path, sizeof(remote.sun_path) - 1);
+        socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        timeval timeout {REPLY_TIMEOUT_S, 0};
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        return socket >= 0 && ::connect(socket, reinterpret_cast<sockaddr*>(&remote), sizeof(remote)) == 0;
+    }
+
+    ~Client() {
+        if (socket >= 0) {
+            close(socket);
+        }
+    }
+
+    void send(const std::string& payload) {
+        int sum = 0;
+        for (char c : payload) {
+            sum += static_cast<unsigned char>(c);
+        }
+        char checksum[3];
+        std::snprintf(checksum, sizeof(checksum), "%02x", sum & 0xFF);
+        sendRaw("$" + payload + "#" + checksum);
+    }
+
+    void sendRaw(const std::string& data) {
+        ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+    }
+
+    // The payload of the next packet, acknowledging it, or "<none>" on a timeout or a bad checksum
+    std::string reply() {
+        while (true) {
+            size_t start = input.find('$');
+            size_t end = start == std::string::npos ? std::string::npos : input.find('#', start);
+            if (end != std::string::npos && end + 2 < input.size()) {
+                std::string payload = input.substr(start + 1, end - start - 1);
+                int sum = 0;
+                for (char c : payload) {
+                    sum += static_cast<unsigned char>(c);
+                }
+                bool valid = std::stoi(input.substr(end + 1, 2), nullptr, 16) == (sum & 0xFF);
+                input.erase(0, end + 3);
+                sendRaw("+");
+                return valid ? payload : "<none>";
+            }
+            char buffer[4096];
+            ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return "<none>";
+            }
+            input.append(buffer, size_t(received));
+        }
+    }
+
+    std::string request(const std::string& payload) {
+        send(payload);
+        return reply();
+    }
+
+private:
+    int socket = -1;
+    std::string input; // received but not yet parsed, acks included
+};
+
+// The hex of a register in a g reply, which holds V0-VF, then I and PC little-endian
+std::string pcOf(const std::string& registers) {
+    return registers.size() == 46 ? registers.substr(36, 4) : "<none>";
+}
+
+std::string expect(const std::string& what, const std::string& reply, const std::string& expected) {
+    return reply == expected ? "" : what + ": got \"" + reply + "\" instead of \"" + expected + "\"";
+}
+
+std::string runSession(Client& client) {
+    std::string supported = client.request("qSupported:multiprocess+;swbreak+");
+    if (supported.find("PacketSize=4000") == std::string::npos ||
+        supported.find("qXfer:features:read+") == std::string::npos) {
+        return "qSupported: got \"" + supported + "\"";
+    }
+    std::string xml = client.request("qXfer:features:read:target.xml:0,3fff");
+    if (xml.empty() || xml[0] != 'l' || xml.find("<reg name=\"pc\" bitsize=\"16\"") == std::string::npos) {
+        return "target.xml: got \"" + xml + "\"";
+    }
+    // Attaching pauses before the first instruction
+    std::string error = expect("?", client.request("?"), "S05");
+    std::string registers = client.request("g");
+    if (error.empty()) {
+        error = expect("g", registers, std::string(32, '0') + "0000" + "0002" + "100000");
+    }
+    if (error.empty()) {
+        error = expect("m", client.request("m200,8"), "6001a30070011204");
+    }
+    if (error.empty()) {
+        error = expect("M", client.request("M300,2:abcd"), "OK");
+    }
+    if (error.empty()) {
+        error = expect("m after M", client.request("m300,2"), "abcd");
+    }
+    if (error.empty()) {
+        error = expect("m out of memory", client.request("mfff,4"), "E01");
+    }
+    if (error.empty()) {
+        error = expect("m with a 9 digit address", client.request("m100000200,2"), "E01");
+    }
+    if (error.empty()) {
+        error = expect("M past the end of memory", client.request("M300,ffffffff:00"), "E01");
+    }
+    if (error.empty()) {
+        error = expect("Z0 with a 9 digit address", client.request("Z0,ffffffff0,2"), "E01");
+    }
+    if (error.empty()) {
+        error = expect("Z0", client.request("Z0,206,2"), "OK");
+    }
+    if (error.empty()) {
+        error = expect("c to the breakpoint", client.request("c"), "S05");
+    }
+    if (error.empty()) {
+        error = expect("PC at the breakpoint", pcOf(client.request("g")), "0602");
+    }
+    if (error.empty()) {
+        error = expect("s", client.request("s"), "S05");
+    }
+    if (error.empty()) {
+        error = expect("PC after a step", pcOf(client.request("g")), "0402");
+    }
+    if (error.empty()) {
+        error = expect("z0", client.request("z0,206,2"), "OK");
+    }
+    if (error.empty()) {
+        // Loops forever until interrupted
+        client.send("c");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        client.sendRaw(std::string(1, '\x03'));
+        error = expect("^C", client.reply(), "S05");
+    }
+    if (error.empty()) {
+        // An unknown opcode under both instructions of the loop traps as SIGILL
+        error = expect("M over the loop", client.request("M204,4:e000e000"), "OK");
+    }
+    if (error.empty()) {
+        error = expect("c to a fault", client.request("c"), "S04");
+    }
+    if (error.empty()) {
+        error = expect("D", client.request("D"), "OK");
+    }
+    return error;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors;
+    {
+        Chip8 cpu;
+        cpu.load(LOOPING_ROM.data(), LOOPING_ROM.size());
+        GdbServer server(cpu);
+        if (server.listen("not-a-port") || server.listen("70000")) {
+            errors.push_back("listen: accepted a bad port");
+        }
+        cpu.faultPolicy = FaultPolicy::Trap;
+        cpu.trapHandler = [&server](Chip8&, const FaultRecord& fault) {return server.trap(fault);};
+        cpu.debugger.pause(); // like the frontend, before the first instruction
+        std::string path = "/tmp/yachie-gdb-test-" + std::to_string(getpid());
+        if (!server.listen("unix:" + path)) {
+            errors.push_back("listen: couldn't listen on " + path);
+        } else {
+            // The frontend's loop, without the window
+            std::atomic<bool> done {false};
+            std::thread emulator([&] {
+                while (!done) {
+                    server.poll();
+                    if (cpu.state.running && !cpu.debugger.isPaused()) {
+                        cpu.run(INSTRUCTIONS_PER_POLL);
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+            });
+            Client client;
+            errors.push_back(client.connect(path) ? runSession(client) : "connect: couldn't connect to " + path);
+            done = true;
+            emulator.join();
+        }
+    }
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Served a GDB session over a Unix socket" << std::endl;
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+// Runs every ROM in roms/ headless with scripted input and compares hashes of VRAM and the registers at
+// checkpoints against tests/golden.txt. `yachie_tests --update` rewrites the golden file after intended changes.
+
+namespace {
+
+constexpr int FRAMES = 600; // 10 seconds of emulated time per ROM
+constexpr int CHECKPOINT_FRAMES = 120;
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+constexpr uint32_t RANDOM_SEED = 0xC8C8C8C8;
+constexpr int KEY_HOLD_FRAMES = 6; // each key in turn is held this long, then released for as long
+constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325;
+constexpr uint64_t FNV_PRIME = 0x100000001B3;
+
+struct Checkpoint {
+    int frame;
+    uint64_t vram;
+    uint64_t registers;
+    bool operator==(const Checkpoint& other) const {
+        return frame == other.frame && vram == other.vram && registers == other.registers;
+    }
+};
+
+using Golden = std::map<std::string, std::vector<Checkpoint>>;
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t n = 0; n < size; n++) {
+        hash = (hash ^ bytes[n]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+Checkpoint checkpoint(const Chip8& cpu, int frame) {
+    const Chip8State& state = cpu.state;
+    uint64_t vram = fnv1a(&state.vram, sizeof(state.vram));
+    uint64_t registers = fnv1a(state.v, sizeof(state.v));
+    // Field by field, so padding doesn't end up in the hash
+    for (uint16_t value : {state.i, state.pc, state.sp, uint16_t(state.delayTimer), uint16_t(state.soundTimer),
+                           uint16_t(state.running)}) {
+        registers = fnv1a(&value, sizeof(value), registers);
+    }
+    registers = fnv1a(state.stack, sizeof(state.stack), registers);
+    return {frame, vram, registers};
+}
+
+// Presses the keys in turn, answering FX0A with whichever key is down (or the next one when none is)
+std::vector<Checkpoint> runRom(const std::filesystem::path& rom) {
+    Chip8 cpu;
+    cpu.load(rom.string());
+    cpu.seedRandom(RANDOM_SEED);
+    std::vector<Checkpoint> checkpoints;
+    for (int frame = 1; frame <= FRAMES; frame++) {
+        int step = frame / KEY_HOLD_FRAMES;
+        int key = (step / 2) % NUMBER_OF_KEYS;
+        bool pressed = step % 2 == 0;
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            cpu.state.input[n] = pressed && n == key;
+        }
+        int remaining = STEPS_PER_FRAME;
+        while (remaining > 0 && cpu.state.running) {
+            if (cpu.state.acceptingInputInto != -1) {
+                cpu.keyInput(uint8_t(key));
+            }
+            RunResult result = cpu.run(remaining);
+            remaining -= std::max(result.executed, 1);
+        }
+        cpu.tickTimers();
+        if (frame % CHECKPOINT_FRAMES == 0) {
+            checkpoints.push_back(checkpoint(cpu, frame));
+        }
+    }
+    return checkpoints;
+}
+
+bool readGolden(const std::string& filename, Golden& golden) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string rom;
+        Checkpoint point {};
+        fields >> rom >> point.frame >> std::hex >> point.vram >> point.registers;
+        golden[rom].push_back(point);
+    }
+    return true;
+}
+
+bool writeGolden(const std::string& filename, const Golden& golden) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "# rom frame vram-hash register-hash, written by yachie_tests --update\n";
+    for (const auto& [rom, checkpoints] : golden) {
+        for (const auto& point : checkpoints) {
+            file << rom << " " << point.frame << std::hex << std::setfill('0') << " " << std::setw(16) << point.vram
+                 << " " << std::setw(16) << point.registers << std::dec << "\n";
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool update = false;
+    std::string goldenFilename = YACHIE_GOLDEN_FILE;
+    std::string romDirectory = YACHIE_ROM_DIR;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "--update") {
+            update = true;
+        } else if (option.compare(0, 9, "--golden=") == 0) {
+            goldenFilename = option.substr(9);
+        } else if (option.compare(0, 7, "--roms=") == 0) {
+            romDirectory = option.substr(7);
+        } else {
+            std::cout << "Usage: yachie_tests [--update] [--golden=FILE] [--roms=DIRECTORY]" << std::endl;
+            return option == "-h" || option == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<std::filesystem::path> roms;
+    for (const auto& entry : std::filesystem::directory_iterator(romDirectory)) {
+        if (entry.is_regular_file()) {
+            roms.push_back(entry.path());
+        }
+    }
+    std::sort(roms.begin(), roms.end());
+
+    // Every ROM on its own thread, they share nothing
+    std::vector<std::future<std::vector<Checkpoint>>> runs;
+    for (const auto& rom : roms) {
+        runs.push_back(std::async(std::launch::async, runRom, rom));
+    }
+    Golden actual;
+    for (size_t n = 0; n < roms.size(); n++) {
+        actual[roms[n].filename().string()] = runs[n].get();
+    }
+
+    if (update) {
+        if (!writeGolden(goldenFilename, actual)) {
+            std::cerr << "Couldn't write " << goldenFilename << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << actual.size() << " ROMs to " << goldenFilename << std::endl;
+        return 0;
+    }
+
+    Golden expected;
+    if (!readGolden(goldenFilename, expected)) {
+        std::cerr << "Couldn't read " << goldenFilename << ", run with --update to create it" << std::endl;
+        return 1;
+    }
+    int failures = 0;
+    for (const auto& [rom, checkpoints] : actual) {
+        auto golden = expected.find(rom);
+        if (golden == expected.end()) {
+            std::cerr << rom << ": no golden hashes" << std::endl;
+            failures++;
+            continue;
+        }
+        for (size_t n = 0; n < checkpoints.size(); n++) {
+            if (n >= golden->second.size() || !(checkpoints[n] == golden->second[n])) {
+                std::cerr << rom << ": differs at frame " << checkpoints[n].frame << std::endl;
+                failures++;
+                break; // later checkpoints will differ too
+            }
+        }
+    }
+    for (const auto& [rom, checkpoints] : expected) {
+        if (actual.find(rom) == actual.end()) {
+            std::cerr << rom << ": missing from " << romDirectory << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        std::cerr << failures << " of " << actual.size() << " ROMs differ from " << goldenFilename << std::endl;
+        return 1;
+    }
+    std::cout << "All " << actual.size() << " ROMs match" << std::endl;
+    return 0;
+}
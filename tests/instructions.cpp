@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+
+// Runs small hand-built programs under each quirk profile and checks the registers, memory and screen they leave
+// behind. Exits non-zero on any difference.
+
+namespace {
+
+constexpr int INSTRUCTIONS = 100; // enough for every program here to end up in its final loop
+
+// Loads program at PROGRAM_OFFSET under profile, followed by a jump to itself so that it can run for any number of
+// instructions, and data at address
+void load(Chip8& cpu, QuirkProfile profile, std::vector<uint8_t> program, uint16_t address = 0,
+          const std::vector<uint8_t>& data = {}) {
+    uint16_t end = uint16_t(PROGRAM_OFFSET + program.size());
+    program.push_back(uint8_t(0x10 | end >> 8));
+    program.push_back(uint8_t(end & 0xFF));
+    cpu.quirkProfile = profile;
+    cpu.load(program.data(), program.size());
+    std::copy(data.begin(), data.end(), cpu.memory() + address);
+    cpu.rehash();
+}
+
+int litPixels(const vram_t& plane) {
+    int lit = 0;
+    for (const auto& row : plane) {
+        for (uint8_t pixel : row) {
+            lit += pixel != 0;
+        }
+    }
+    return lit;
+}
+
+// The only lit pixel of plane is at (x, y)
+bool onlyPixel(const vram_t& plane, int x, int y) {
+    return plane[size_t(y)][size_t(x)] != 0 && litPixels(plane) == 1;
+}
+
+std::string named(QuirkProfile profile, const std::string& error) {
+    return error.empty() ? "" : std::string(quirkProfileName(profile)) + ": " + error;
+}
+
+// What each profile does with the ambiguous opcodes
+struct ProfileQuirks {
+    QuirkProfile profile;
+    bool shiftUsesVy;
+    int indexAdvance; // how far FX55 or FX65 with X = 1 moves I
+    bool wrapSprites;
+    bool carryIsLowBit;
+    bool logicResetsVF;
+    bool jumpUsesVx;
+};
+
+const ProfileQuirks PROFILES[] = {
+    {QuirkProfile::Yachie, true, 0, true, true, false, false},
+    {QuirkProfile::CosmacVip, true, 2, false, false, true, false},
+    {QuirkProfile::Chip48, false, 1, false, false, false, true},
+    {QuirkProfile::SuperChip, false, 0, false, false, false, true},
+    {QuirkProfile::XoChip, true, 2, true, false, false, false},
+};
+
+std::string checkQuirks(const ProfileQuirks& quirks) {
+    Chip8 cpu;
+    load(cpu, quirks.profile, {
+        0x60, 0x01, // LD V0, 1
+        0x61, 0x06, // LD V1, 6
+        0x80, 0x16, // SHR V0, V1
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.v[0] != (quirks.shiftUsesVy ? 3 : 0) || cpu.state.v[0xF] != (quirks.shiftUsesVy ? 0 : 1)) {
+        return "8XY6 shifted the wrong register";
+    }
+
+    load(cpu, quirks.profile, {
+        0x60, 0x05, // LD V0, 5
+        0x61, 0x06, // LD V1, 6
+        0xA3, 0x00, // LD I, 0x300
+        0xF1, 0x55, // LD [I], V1
+        0xF1, 0x65, // LD V1, [I]
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.memory()[0x300] != 5 || cpu.memory()[0x301] != 6 || cpu.state.i != 0x300 + 2 * quirks.indexAdvance) {
+        return "FX55/FX65 left I at " + std::to_string(cpu.state.i - 0x300) + " past where it started";
+    }
+
+    // The 4 pixel wide top of a font 0, 2 pixels from the right edge
+    load(cpu, quirks.profile, {
+        0x60, 0x3E, // LD V0, 62
+        0x61, 0x00, // LD V1, 0
+        0xA0, 0x00, // LD I, 0
+        0xD0, 0x11, // DRW V0, V1, 1
+    });
+    cpu.run(INSTRUCTIONS);
+    const auto& top = cpu.state.vram[0];
+    if (top[62] == 0 || top[63] == 0 || (top[0] != 0) != quirks.wrapSprites) {
+        return quirks.wrapSprites ? "DXYN didn't wrap around the edge" : "DXYN didn't clip at the edge";
+    }
+
+    load(cpu, quirks.profile, {
+        0x60, 0xFF, // LD V0, 0xFF
+        0x61, 0x01, // LD V1, 1
+        0x80, 0x14, // ADD V0, V1
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.v[0] != 0 || cpu.state.v[0xF] != (quirks.carryIsLowBit ? 0 : 1)) {
+        return "8XY4 set VF to " + std::to_string(cpu.state.v[0xF]);
+    }
+
+    load(cpu, quirks.profile, {
+        0x6F, 0x05, // LD VF, 5
+        0x80, 0x11, // OR V0, V1
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.v[0xF] != (quirks.logicResetsVF ? 0 : 5)) {
+        return "8XY1 set VF to " + std::to_string(cpu.state.v[0xF]);
+    }
+
+    load(cpu, quirks.profile, {
+        0x60, 0x00, // 200: LD V0, 0
+        0x62, 0x04, // 202: LD V2, 4
+        0xB2, 0x0A, // 204: JP V0, 0x20A or JP V2, 0x20A
+        0x00, 0x00, // 206: padding
+        0x00, 0x00, // 208: padding
+        0x12, 0x0A, // 20A: JP 0x20A
+        0x00, 0x00, // 20C: padding
+        0x12, 0x0E, // 20E: JP 0x20E
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.pc != (quirks.jumpUsesVx ? 0x20E : 0x20A)) {
+        return "BNNN jumped with the wrong register";
+    }
+    return "";
+}
+
+// A pixel drawn in high resolution, scrolled down, right and left, then kept when switching back to low resolution
+std::string checkSuperChipScrolls() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::SuperChip, {
+        0x00, 0xFF, // HIGH
+        0xA3, 0x00, // LD I, 0x300
+        0x60, 0x00, // LD V0, 0
+        0x61, 0x00, // LD V1, 0
+        0xD0, 0x11, // DRW V0, V1, 1
+        0x00, 0xC3, // SCD 3
+        0x00, 0xFB, // SCR
+        0x00, 0xFC, // SCL
+        0x00, 0xFE, // LOW
+    }, 0x300, {0x80});
+    cpu.run(5);
+    if (!cpu.state.hires || cpu.state.screenWidth() != HIRES_WIDTH || !onlyPixel(cpu.state.vram, 0, 0)) {
+        return "00FF/DXYN: no pixel at (0, 0) in high resolution";
+    }
+    cpu.run(1);
+    if (!onlyPixel(cpu.state.vram, 0, 3)) {
+        return "00C3 didn't scroll down 3 lines";
+    }
+    cpu.run(1);
+    if (!onlyPixel(cpu.state.vram, 4, 3)) {
+        return "00FB didn't scroll right 4 pixels";
+    }
+    cpu.run(1);
+    if (!onlyPixel(cpu.state.vram, 0, 3)) {
+        return "00FC didn't scroll left 4 pixels";
+    }
+    cpu.run(1);
+    if (cpu.state.hires || !onlyPixel(cpu.state.vram, 0, 3)) {
+        return "00FE didn't switch to low resolution, leaving the screen alone";
+    }
+    if (cpu.stateHash() != cpu.computeStateHash()) {
+        return "the scrolls left the incremental VRAM hash out of date";
+    }
+    return "";
+}
+
+// A 16x16 sprite drawn twice, the second time erasing the first
+std::string checkSuperChipWideSprite() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::SuperChip, {
+        0x00, 0xFF, // HIGH
+        0xA3, 0x00, // LD I, 0x300
+        0x60, 0x70, // LD V0, 112
+        0x61, 0x30, // LD V1, 48
+        0xD0, 0x10, // DRW V0, V1, 0
+    }, 0x300, std::vector<uint8_t>(32, 0xFF));
+    cpu.run(5);
+    if (litPixels(cpu.state.vram) != 16 * 16 || cpu.state.vram[63][127] == 0 || cpu.state.v[0xF] != 0) {
+        return "DXY0 didn't draw a 16x16 sprite in the bottom right corner";
+    }
+    cpu.state.pc -= OPCODE_SIZE;
+    cpu.run(1);
+    if (litPixels(cpu.state.vram) != 0 || cpu.state.v[0xF] != 1) {
+        return "DXY0 drawn again didn't erase the sprite and collide";
+    }
+    return "";
+}
+
+std::string checkSuperChipRegisters() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::SuperChip, {
+        0x60, 0x0A, // LD V0, 0xA
+        0xF0, 0x30, // LD HF, V0
+        0x60, 0x01, // LD V0, 1
+        0x61, 0x02, // LD V1, 2
+        0x62, 0x03, // LD V2, 3
+        0xF2, 0x75, // LD R, V2
+    });
+    cpu.run(2);
+    if (cpu.state.i != BIG_FONT_OFFSET + 0xA * BIG_FONT_CHARACTER_SIZE) {
+        return "FX30 didn't point I at the big A";
+    }
+    cpu.run(INSTRUCTIONS);
+    // The flags outlive the ROM, like on the HP-48
+    load(cpu, QuirkProfile::SuperChip, {
+        0xF2, 0x85, // LD V2, R
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.v[0] != 1 || cpu.state.v[1] != 2 || cpu.state.v[2] != 3) {
+        return "FX85 didn't load back what FX75 saved";
+    }
+    return "";
+}
+
+// Without the SCHIP profile, its scrolls are 0NNN calls to machine code, which are ignored
+std::string checkSuperChipOnly() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::Chip48, {
+        0xA3, 0x00, // LD I, 0x300
+        0xD0, 0x01, // DRW V0, V0, 1
+        0x00, 0xFB, // SYS 0x0FB
+    }, 0x300, {0x80});
+    cpu.run(INSTRUCTIONS);
+    return onlyPixel(cpu.state.vram, 0, 0) ? "" : "00FB scrolled outside SCHIP";
+}
+
+// A skip over F000 NNNN skips all 4 bytes, and the address it loads can be past the classic 4KB
+std::string checkXoChipLongLoad() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::XoChip, {
+        0x60, 0x01, // LD V0, 1
+        0x30, 0x01, // SE V0, 1
+        0xF0, 0x00, 0x12, 0x34, // LD I, 0x1234
+        0x61, 0x05, // LD V1, 5
+        0xF0, 0x00, 0xAB, 0xCD, // LD I, 0xABCD
+    });
+    cpu.run(INSTRUCTIONS);
+    if (cpu.state.v[1] != 5 || cpu.state.i != 0xABCD) {
+        return "F000 NNNN wasn't skipped whole or didn't load a 16 bit address";
+    }
+    return "";
+}
+
+// Sprites and CLS only touch the planes FN01 selected, a sprite per plane
+std::string checkXoChipPlanes() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::XoChip, {
+        0xA3, 0x00, // LD I, 0x300
+        0xF2, 0x01, // PLANE 2
+        0xD0, 0x01, // DRW V0, V0, 1
+        0xF3, 0x01, // PLANE 3
+        0xD0, 0x01, // DRW V0, V0, 1
+        0xF1, 0x01, // PLANE 1
+        0x00, 0xE0, // CLS
+    }, 0x300, {0x80, 0x40});
+    const vram_t& plane2 = *cpu.secondPlane();
+    cpu.run(3);
+    if (litPixels(cpu.state.vram) != 0 || !onlyPixel(plane2, 0, 0)) {
+        return "F201 didn't draw in the second plane only";
+    }
+    cpu.run(2);
+    if (!onlyPixel(cpu.state.vram, 0, 0) || litPixels(plane2) != 2 || plane2[0][1] == 0 || cpu.state.v[0xF] != 0) {
+        return "F301 didn't draw each plane's own sprite";
+    }
+    cpu.run(2);
+    if (litPixels(cpu.state.vram) != 0 || litPixels(plane2) != 2) {
+        return "F101 didn't clear the first plane only";
+    }
+    return "";
+}
+
+// Both planes scrolled up, then cleared by a change of resolution
+std::string checkXoChipScrollUp() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::XoChip, {
+        0xA3, 0x00, // LD I, 0x300
+        0x61, 0x05, // LD V1, 5
+        0xF3, 0x01, // PLANE 3
+        0xD0, 0x11, // DRW V0, V1, 1
+        0x00, 0xD2, // SCU 2
+        0x00, 0xFF, // HIGH
+    }, 0x300, {0x80, 0x80});
+    cpu.run(5);
+    if (!onlyPixel(cpu.state.vram, 0, 3) || !onlyPixel(*cpu.secondPlane(), 0, 3)) {
+        return "00D2 didn't scroll both planes up 2 lines";
+    }
+    if (cpu.stateHash() != cpu.computeStateHash()) {
+        return "00DN left the incremental VRAM hash out of date";
+    }
+    cpu.run(1);
+    if (litPixels(cpu.state.vram) != 0 || litPixels(*cpu.secondPlane()) != 0) {
+        return "00FF didn't clear the screen";
+    }
+    return "";
+}
+
+// 5XY2 and 5XY3 save and load from Vx to Vy, backwards when X > Y, and leave I alone
+std::string checkXoChipRegisterRanges() {
+    Chip8 cpu;
+    load(cpu, QuirkProfile::XoChip, {
+        0x60, 0x01, // LD V0, 1
+        0x61, 0x02, // LD V1, 2
+        0x62, 0x03, // LD V2, 3
+        0xA3, 0x00, // LD I, 0x300
+        0x50, 0x22, // SAVE V0-V2
+        0xA3, 0x10, // LD I, 0x310
+        0x52, 0x02, // SAVE V2-V0
+        0x53, 0x53, // LOAD V3-V5
+        0xA3, 0x00, // LD I, 0x300
+        0x58, 0x63, // LOAD V8-V6
+    });
+    cpu.run(INSTRUCTIONS);
+    const uint8_t* memory = cpu.memory();
+    const uint8_t* v = cpu.state.v;
+    if (memory[0x300] != 1 || memory[0x302] != 3 || memory[0x310] != 3 || memory[0x312] != 1) {
+        return "5XY2 didn't save the registers in order";
+    }
+    if (v[3] != 3 || v[5] != 1 || v[8] != 1 || v[6] != 3 || cpu.state.i != 0x300) {
+        return "5XY3 didn't load the registers in order";
+    }
+    return "";
+}
+
+std::string checkXoChipAudio() {
+    Chip8 cpu;
+    std::vector<uint8_t> pattern(AUDIO_PATTERN_SIZE);
+    for (int n = 0; n < AUDIO_PATTERN_SIZE; n++) {
+        pattern[size_t(n)] = uint8_t(n * 17);
+    }
+    load(cpu, QuirkProfile::XoChip, {
+        0xA3, 0x00, // LD I, 0x300
+        0xF0, 0x02, // AUDIO
+        0x60, 0x80, // LD V0, 0x80
+        0xF0, 0x3A, // PITCH V0
+    }, 0x300, pattern);
+    cpu.run(INSTRUCTIONS);
+    if (!std::equal(pattern.begin(), pattern.end(), cpu.xoChip->audioPattern)) {
+        return "F002 didn't load the audio pattern";
+    }
+    if (cpu.xoChip->pitch != 0x80) {
+        return "FX3A didn't set the pitch";
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors;
+    for (const ProfileQuirks& quirks : PROFILES) {
+        errors.push_back(named(quirks.profile, checkQuirks(quirks)));
+    }
+    for (const std::string& error : {
+        checkSuperChipScrolls(),
+        checkSuperChipWideSprite(),
+        checkSuperChipRegisters(),
+        checkSuperChipOnly(),
+    }) {
+        errors.push_back(named(QuirkProfile::SuperChip, error));
+    }
+    for (const std::string& error : {
+        checkXoChipLongLoad(),
+        checkXoChipPlanes(),
+        checkXoChipScrollUp(),
+        checkXoChipRegisterRanges(),
+        checkXoChipAudio(),
+    }) {
+        errors.push_back(named(QuirkProfile::XoChip, error));
+    }
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Ran " << errors.size() << " instruction checks as expected" << std::endl;
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Lockstep.h"
+
+// Runs the engines against Chip8::run() in lockstep, on every ROM in roms/ under every quirk profile and on random
+// instruction streams, and checks that the runner itself catches a divergence. Exits non-zero if any run diverges.
+
+namespace {
+
+constexpr uint32_t RANDOM_SEED = 0xC8C8C8C8;
+constexpr int KEY_HOLD_FRAMES = 6;
+constexpr int ROM_FRAMES = 600;
+constexpr int ROM_BLOCK_SIZE = 16;
+constexpr int RANDOM_PROGRAMS = 64; // per profile
+constexpr int RANDOM_INSTRUCTIONS = 256;
+constexpr int RANDOM_FRAMES = 30;
+constexpr int RANDOM_BLOCK_SIZE = 4;
+constexpr int HASH_FRAMES = 120; // the incremental hash checks are slow, so they get shorter runs
+constexpr int HASH_PROGRAMS = 4; // per profile
+constexpr QuirkProfile PROFILES[] = {QuirkProfile::Yachie, QuirkProfile::CosmacVip, QuirkProfile::Chip48,
+                                     QuirkProfile::SuperChip, QuirkProfile::XoChip};
+
+struct Candidate {
+    const char* name;
+    Engine engine;
+};
+
+// The memory policies only differ past the end of memory, which neither the ROMs nor the random programs reach
+RunResult runWrapMemory(Chip8& cpu, int instructions) {
+    cpu.memoryPolicy = MemoryPolicy::Wrap;
+    return cpu.run(instructions);
+}
+
+RunResult runCheckedMemory(Chip8& cpu, int instructions) {
+    cpu.memoryPolicy = MemoryPolicy::Checked;
+    return cpu.run(instructions);
+}
+
+const Candidate CANDIDATES[] = {
+    {"stepped", runStepped},
+    {"checked", runChecked},
+    {"wrap memory", runWrapMemory},
+    {"checked memory", runCheckedMemory},
+};
+
+// Each key in turn is held for KEY_HOLD_FRAMES and released for as long, FX0A gets the current one
+void scriptedInput(Chip8& cpu, int frame) {
+    int step = frame / KEY_HOLD_FRAMES;
+    int key = (step / 2) % NUMBER_OF_KEYS;
+    bool pressed = step % 2 == 0;
+    for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+        cpu.state.input[n] = pressed && n == key;
+    }
+    if (cpu.state.acceptingInputInto != -1) {
+        cpu.keyInput(uint8_t(key));
+    }
+}
+
+std::string runRom(const std::filesystem::path& rom) {
+    LockstepOptions options;
+    options.frames = ROM_FRAMES;
+    options.blockSize = ROM_BLOCK_SIZE;
+    for (QuirkProfile profile : PROFILES) {
+        auto setup = [&rom, profile](Chip8& cpu) {
+            cpu.quirkProfile = profile;
+            cpu.faultPolicy = FaultPolicy::Skip;
+            cpu.load(rom.string());
+            cpu.seedRandom(RANDOM_SEED);
+        };
+        for (const Candidate& candidate : CANDIDATES) {
+            Divergence divergence = LockstepRunner(runBatched, candidate.engine).run(setup, scriptedInput, options);
+            if (divergence.found) {
+                return rom.filename().string() + " (" + quirkProfileName(profile) + ", " + candidate.name + "): " +
+                       LockstepRunner::describe(divergence);
+            }
+        }
+    }
+    return "";
+}
+
+std::string runRandom(QuirkProfile profile, uint32_t seed, int programs) {
+    LockstepOptions options;
+    options.frames = RANDOM_FRAMES;
+    options.blockSize = RANDOM_BLOCK_SIZE;
+    std::mt19937 rng(seed);
+    for (int n = 0; n < programs; n++) {
+        std::vector<uint8_t> program = randomProgram(rng, RANDOM_INSTRUCTIONS);
+        uint32_t programSeed = rng();
+        auto setup = [&program, profile, programSeed](Chip8& cpu) {
+            cpu.quirkProfile = profile;
+            cpu.faultPolicy = FaultPolicy::Skip;
+            loadProgram(cpu, program);
+            cpu.seedRandom(programSeed);
+        };
+        for (const Candidate& candidate : CANDIDATES) {
+            Divergence divergence = LockstepRunner(runBatched, candidate.engine).run(setup, scriptedInput, options);
+            if (divergence.found) {
+                return std::string("random program ") + std::to_string(n) + " (" + quirkProfileName(profile) +
+                       ", " + candidate.name + ", seed " + std::to_string(seed) + "): " +
+                       LockstepRunner::describe(divergence);
+            }
+        }
+    }
+    return "";
+}
+
+// The incremental state hashes against hashing from scratch, after every block of a ROM and a few random programs
+// under every profile
+std::string checkHashes(const std::filesystem::path& rom, uint32_t seed) {
+    LockstepOptions options;
+    options.frames = HASH_FRAMES;
+    options.blockSize = ROM_BLOCK_SIZE;
+    options.checkHashes = true;
+    std::mt19937 rng(seed);
+    for (QuirkProfile profile : PROFILES) {
+        auto romSetup = [&rom, profile](Chip8& cpu) {
+            cpu.quirkProfile = profile;
+            cpu.faultPolicy = FaultPolicy::Skip;
+            cpu.load(rom.string());
+            cpu.seedRandom(RANDOM_SEED);
+        };
+        Divergence divergence = LockstepRunner(runBatched, runStepped).run(romSetup, scriptedInput, options);
+        if (divergence.found) {
+            return rom.filename().string() + " (" + quirkProfileName(profile) + ", hashes): " +
+                   LockstepRunner::describe(divergence);
+        }
+        for (int n = 0; n < HASH_PROGRAMS; n++) {
+            std::vector<uint8_t> program = randomProgram(rng, RANDOM_INSTRUCTIONS);
+            auto setup = [&program, profile](Chip8& cpu) {
+                cpu.quirkProfile = profile;
+                cpu.faultPolicy = FaultPolicy::Skip;
+                loadProgram(cpu, program);
+                cpu.seedRandom(RANDOM_SEED);
+            };
+            divergence = LockstepRunner(runBatched, runStepped).run(setup, scriptedInput, options);
+            if (divergence.found) {
+                return std::string("random program ") + std::to_string(n) + " (" + quirkProfileName(profile) +
+                       ", hashes): " + LockstepRunner::describe(divergence);
+            }
+        }
+    }
+    return "";
+}
+
+// Machines that only differ in how far their RNG has got carry on differently, so they can't hash the same
+std::string checkRandomHash() {
+    const std::vector<uint8_t> program = {0xC0, 0x00, 0x12, 0x00}; // RND V0, 0 then loop
+    Chip8 once;
+    Chip8 twice;
+    for (Chip8* cpu : {&once, &twice}) {
+        cpu->load(program.data(), program.size());
+        cpu->seedRandom(RANDOM_SEED);
+    }
+    once.run(1);
+    twice.run(3);
+    if (!LockstepRunner::compare(once, twice).empty() || once.stateHash() == twice.stateHash()) {
+        return "the state hash doesn't cover the RNG";
+    }
+    return "";
+}
+
+// An engine that gets V1 wrong after the instruction at 0x206, which the runner has to pin down from a larger block
+std::string checkRunner() {
+    const std::vector<uint8_t> program = {0x61, 0x01, 0x71, 0x01, 0x71, 0x01, 0x71, 0x01, 0x71, 0x01, 0x12, 0x00};
+    auto setup = [&program](Chip8& cpu) {
+        cpu.initState();
+        std::copy(program.begin(), program.end(), cpu.memory() + PROGRAM_OFFSET);
+        cpu.rehash();
+        cpu.state.running = true;
+    };
+    Engine broken = [](Chip8& cpu, int instructions) {
+        RunResult result {0, {}};
+        for (int n = 0; n < instructions; n++) {
+            uint16_t pc = cpu.state.pc;
+            result.executed += cpu.run(1).executed;
+            if (pc == 0x206) {
+                cpu.state.v[1] ^= 0x80;
+            }
+        }
+        return result;
+    };
+    LockstepOptions options;
+    options.frames = 1;
+    options.blockSize = 8;
+    Divergence divergence = LockstepRunner(runBatched, broken).run(setup, scriptedInput, options);
+    if (!divergence.found || divergence.instruction != 3 || divergence.difference.compare(0, 5, "V[0x1") != 0 ||
+        divergence.trace.empty() || divergence.trace.back().first != 0x206) {
+        return "the runner missed a divergence at 0x206: " + LockstepRunner::describe(divergence);
+    }
+    return "";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string romDirectory = YACHIE_ROM_DIR;
+    uint32_t seed = RANDOM_SEED;
+    int programs = RANDOM_PROGRAMS;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option.compare(0, 7, "--roms=") == 0) {
+            romDirectory = option.substr(7);
+        } else if (option.compare(0, 7, "--seed=") == 0) {
+            seed = uint32_t(std::stoul(option.substr(7)));
+        } else if (option.compare(0, 11, "--programs=") == 0) {
+            programs = std::stoi(option.substr(11));
+        } else {
+            std::cout << "Usage: yachie_lockstep_tests [--roms=DIRECTORY] [--seed=N] [--programs=N]" << std::endl;
+            return option == "-h" || option == "--help" ? 0 : 1;
+        }
+    }
+
+    std::string error = checkRunner();
+    if (error.empty()) {
+        error = checkRandomHash();
+    }
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> roms;
+    for (const auto& entry : std::filesystem::directory_iterator(romDirectory)) {
+        if (entry.is_regular_file()) {
+            roms.push_back(entry.path());
+        }
+    }
+    std::sort(roms.begin(), roms.end());
+    std::vector<std::future<std::string>> runs;
+    for (const auto& rom : roms) {
+        runs.push_back(std::async(std::launch::async, runRom, rom));
+    }
+    for (QuirkProfile profile : PROFILES) {
+        runs.push_back(std::async(std::launch::async, runRandom, profile, seed, programs));
+    }
+    if (!roms.empty()) {
+        runs.push_back(std::async(std::launch::async, checkHashes, roms.front(), seed));
+    }
+    int failures = 0;
+    for (auto& run : runs) {
+        error = run.get();
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        std::cerr << failures << " of " << runs.size() << " runs diverged" << std::endl;
+        return 1;
+    }
+    std::cout << "All engines agree on " << roms.size() << " ROMs and " << programs << " random programs per profile"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <string>
+#include "Probes.h"
+
+// Compiles probe programs and evaluates them against a machine in a known state, and checks that malformed ones are
+// rejected with the line they fail on. Exits non-zero on the first failure.
+
+namespace {
+
+struct Case {
+    const char* source;
+    int64_t expected; // the value of the last variable the program assigns
+};
+
+const Case CASES[] = {
+    {"x = 2 + 3 * 4", 14},
+    {"x = (2 + 3) * 4", 20},
+    {"x = 7 - 2 - 1", 4},
+    {"x = 1 << 4 | 1", 17},
+    {"x = 1 < 2 == 1", 1},
+    {"x = -7 / 2; y = -7 % 2", -1},
+    {"x = 5 / 0 + 5 % 0", 0},
+    {"x = !0 + !5 + ~0", 0},
+    {"x = 1 || 0 && 0", 1},
+    {"x = min(3, -4) * max(3, -4) + abs(-5)", -7},
+    {"x = mem[0x300]", 0x12},
+    {"x = mem[0x300..0x301]", 0x1234},
+    {"score = bcd(mem[0x310..0x312])", 307},
+    {"x = bcd(mem[0x312])", 7},
+    {"x = mem[0x2FF + v[1]]", 0x12},
+    {"x = mem[0x1300]", 0x12}, // wraps at the end of memory
+    {"done = v[0xE] == 0", 1},
+    {"x = v[1] + v[15]", 10},
+    {"x = v[i - 0x2F0]", 1}, // I is 0x2F1
+    {"x = pc + sp + dt + st + running + hires", 0x200 + 2 + 3 + 4 + 1},
+    {"lives = mem[0x302]\n# lives and the score\nscore = bcd(mem[0x310..0x312])\n\nx = lives * 1000 + score", 5307},
+    {"x = 1; x = x + 1; x = x * 10", 20},
+};
+
+const char* const ERRORS[] = {
+    "x = ", // no value
+    "x = 1 +", // no right operand
+    "x = (1", // unclosed
+    "x = y", // y was never assigned
+    "x = mem[0x300..0x3FF]", // longer than 8 bytes
+    "x = mem[v[0]..0x301]", // bounds that aren't numbers
+    "x = bcd(v[0])",
+    "mem = 1", // reserved
+    "x = 1 2", // two values
+    "3 = x",
+    "x = 0x1G",
+    "x = 1 @ 2",
+};
+
+void setUp(Chip8& cpu) {
+    cpu.initState();
+    uint8_t* memory = cpu.memory();
+    memory[0x300] = 0x12;
+    memory[0x301] = 0x34;
+    memory[0x302] = 5;
+    memory[0x310] = 3;
+    memory[0x311] = 0;
+    memory[0x312] = 7;
+    cpu.state.v[1] = 1;
+    cpu.state.v[15] = 9;
+    cpu.state.i = 0x2F1;
+    cpu.state.sp = 2;
+    cpu.state.delayTimer = 3;
+    cpu.state.soundTimer = 4;
+    cpu.state.running = true;
+}
+
+} // namespace
+
+int main() {
+    Chip8 cpu;
+    setUp(cpu);
+    for (const Case& test : CASES) {
+        ProbeProgram program;
+        std::string error = program.compile(test.source);
+        if (!error.empty()) {
+            std::cerr << "\"" << test.source << "\" didn't compile: " << error << std::endl;
+            return 1;
+        }
+        std::vector<int64_t> values(size_t(program.variables()));
+        program.evaluate(cpu, values.data());
+        if (values.back() != test.expected) {
+            std::cerr << "\"" << test.source << "\" gave " << values.back() << ", expected " << test.expected
+                      << std::endl;
+            return 1;
+        }
+    }
+    for (const char* source : ERRORS) {
+        ProbeProgram program;
+        if (program.compile(source).empty() || !program.empty()) {
+            std::cerr << "\"" << source << "\" compiled" << std::endl;
+            return 1;
+        }
+    }
+    ProbeProgram program;
+    std::string error = program.compile("a = 1\nb = a +\n");
+    if (error.rfind("line 2,", 0) != 0) {
+        std::cerr << "an error on the second line was reported as: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "The probe programs evaluate as expected" << std::endl;
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Chip8.h"
+
+// Feeds the profiler a short program with a subroutine and checks the opcode classes, hot PCs and folded stacks it
+// reports. Built with YACHIE_PROFILE, also checks that the interpreter reports the same when it runs the program.
+// Exits non-zero on any difference.
+
+namespace {
+
+const std::vector<uint8_t> CALLING_ROM = {
+    0x60, 0x03, // 200: LD V0, 3
+    0x23, 0x00, // 202: CALL 0x300
+    0x12, 0x04, // 204: JP 0x204
+};
+const std::vector<uint8_t> SUBROUTINE = {
+    0x70, 0x01, // 300: ADD V0, 1
+    0x00, 0xEE, // 302: RET
+};
+constexpr int INSTRUCTIONS = 7; // the loop at 0x204 runs three times
+
+// What the interpreter reports while running INSTRUCTIONS of CALLING_ROM, as (PC, opcode) pairs
+void feed(Profiler& profiler) {
+    const std::vector<std::pair<uint16_t, uint16_t>> executed = {
+        {0x200, 0x6003}, {0x202, 0x2300}, {0x300, 0x7001}, {0x302, 0x00EE}, {0x204, 0x1204}, {0x204, 0x1204},
+        {0x204, 0x1204},
+    };
+    for (auto [pc, opcode] : executed) {
+        profiler.instruction(pc, opcode);
+        if (opcode == 0x2300) {
+            profiler.call(0x300);
+        } else if (opcode == 0x00EE) {
+            profiler.ret();
+        }
+    }
+}
+
+std::string report(const Profiler& profiler) {
+    std::stringstream out;
+    profiler.writeReport(out);
+    return out.str();
+}
+
+std::string folded(const Profiler& profiler) {
+    std::stringstream out;
+    profiler.writeFoldedStacks(out);
+    return out.str();
+}
+
+std::string checkReport() {
+    Profiler profiler;
+    feed(profiler);
+    std::string text = report(profiler);
+    for (const char* line : {
+        "Instructions executed: 7\n",
+        "             3   42.86%  1NNN JP\n",
+        "             1   14.29%  2NNN CALL\n",
+        "             1   14.29%  00EE RET\n",
+        "             3   42.86%  0x204\n",
+        "             1   14.29%  0x300\n",
+    }) {
+        if (text.find(line) == std::string::npos) {
+            return std::string("the report is missing \"") + line + "\":\n" + text;
+        }
+    }
+    // The call and the instructions around it count for the entry point, the subroutine's two for its own frame
+    if (folded(profiler) != "0x200 5\n0x200;0x300 2\n") {
+        return "unexpected folded stacks:\n" + folded(profiler);
+    }
+    profiler.reset();
+    if (report(profiler).find("Instructions executed: 0\n") == std::string::npos || !folded(profiler).empty()) {
+        return "reset() left counts behind";
+    }
+    return "";
+}
+
+#ifdef YACHIE_PROFILE
+std::string checkInterpreter() {
+    Chip8 cpu;
+    cpu.load(CALLING_ROM.data(), CALLING_ROM.size());
+    std::copy(SUBROUTINE.begin(), SUBROUTINE.end(), cpu.memory() + 0x300);
+    cpu.rehash();
+    cpu.run(INSTRUCTIONS);
+    Profiler expected;
+    feed(expected);
+    // The time spent drawing differs, the rest doesn't
+    auto counts = [](const std::string& text) {return text.substr(text.find("\n\n"));};
+    if (counts(report(cpu.profiler)) != counts(report(expected)) || folded(cpu.profiler) != folded(expected)) {
+        return "the interpreter's profile differs:\n" + report(cpu.profiler) + folded(cpu.profiler);
+    }
+    return "";
+}
+#endif
+
+} // namespace
+
+int main() {
+    std::vector<std::string> errors = {
+        checkReport(),
+#ifdef YACHIE_PROFILE
+        checkInterpreter(),
+#endif
+    };
+    int failures = 0;
+    for (const std::string& error : errors) {
+        if (!error.empty()) {
+            std::cerr << error << std::endl;
+            failures++;
+        }
+    }
+    if (failures != 0) {
+        return 1;
+    }
+    std::cout << "Profiled " << INSTRUCTIONS << " instructions as expected" << std::endl;
+    return 0;
+}
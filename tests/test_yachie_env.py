@@ -0,0 +1,70 @@
+"""Runs the Python binding against the library: observations and rewards land in the binding's buffers and the key
+actions reach the ROM. Takes the roms/ directory as its argument."""
+
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "python"))
+import yachie_env  # noqa: E402
+
+# Waits for a key and shows its digit at the top left, forever
+DIGIT_ROM = bytes([0xF0, 0x0A, 0x00, 0xE0, 0xF0, 0x29, 0xD1, 0x15, 0x12, 0x00])
+# Writes the digits of the frame count to 0x300, with instructions_per_frame at 3
+COUNTER_ROM = bytes([0xA3, 0x00, 0x70, 0x01, 0xF0, 0x33, 0x12, 0x02])
+
+
+def top_row(env, index):
+    start = index * env.width * env.height
+    return [int(env.observations[start + x]) if isinstance(env.observations, bytearray)
+            else int(env.observations[index][0][x]) for x in range(8)]
+
+
+def main():
+    with yachie_env.VectorEnv(DIGIT_ROM, 3, threads=2) as env:
+        env.reset(seed=1)
+        for frame in range(2):  # FX0A starts waiting in the first frame
+            _, _, dones = env.step([yachie_env.NO_KEY, 1, 8])
+        assert top_row(env, 0) == [0] * 8, "no key drew something"
+        assert top_row(env, 1) == [0, 0, 1, 0, 0, 0, 0, 0], "key 1 didn't draw a 1"
+        assert top_row(env, 2) == [1, 1, 1, 1, 0, 0, 0, 0], "key 8 didn't draw an 8"
+        assert list(dones) == [yachie_env.RUNNING] * 3
+
+    with yachie_env.VectorEnv(os.path.join(sys.argv[1], "BRIX"), 8, max_episode_frames=5) as env:
+        env.reset(seed=2)
+        for frame in range(1, 11):
+            _, _, dones = env.step([4, 6] * 4)
+            expected = yachie_env.TRUNCATED if frame % 5 == 0 else yachie_env.RUNNING
+            assert list(dones) == [expected] * 8, "frame %d ended with %s" % (frame, list(dones))
+
+    with yachie_env.VectorEnv(DIGIT_ROM, 3, frame_skip=2, packed=True) as env:
+        env.reset()
+        env.step([yachie_env.NO_KEY, 1, 8])
+        assert [int(env.observations[n * env.height * env.width // 8] if isinstance(env.observations, bytearray)
+                    else env.observations[n][0][0]) for n in range(3)] == [0, 0x20, 0xF0], "packed digits are wrong"
+
+    probes = [yachie_env.Probe(0x300, 3, yachie_env.DIGITS, 0.5)]
+    with yachie_env.VectorEnv(COUNTER_ROM, 2, instructions_per_frame=3, frame_skip=4, reward_probes=probes) as env:
+        env.reset()
+        for step in range(3):
+            _, rewards, _ = env.step([yachie_env.NO_KEY] * 2)
+            assert list(rewards) == [2.0, 2.0], "got rewards %s" % list(rewards)
+
+    program = "count = bcd(mem[0x300..0x302]); done = count == 6"
+    with yachie_env.VectorEnv(COUNTER_ROM, 2, instructions_per_frame=3, frame_skip=4, probes=program) as env:
+        env.reset()
+        _, _, dones = env.step([yachie_env.NO_KEY] * 2)
+        assert list(dones) == [yachie_env.RUNNING] * 2 and env.probe("count") == [4, 4]
+        _, _, dones = env.step([yachie_env.NO_KEY] * 2)
+        assert list(dones) == [yachie_env.TERMINATED] * 2 and env.probe("count") == [6, 6]
+
+    try:
+        yachie_env.VectorEnv(DIGIT_ROM, 1, quirks="pdp11")
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("an unknown quirk profile was accepted")
+    print("The Python binding works")
+
+
+if __name__ == "__main__":
+    main()
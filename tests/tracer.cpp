@@ -0,0 +1,240 @@
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "Tracer.h"
+
+// Records spans and instant events on two threads, exports them and parses the Chrome trace JSON back, checking that
+// every event is there with its phase, thread and argument. Exits non-zero on any difference.
+
+namespace {
+
+// Just enough JSON for a trace: objects, arrays, strings without \u escapes, numbers and the literals
+struct Json {
+    enum Type {Null, Bool, Number, String, Array, Object};
+    Type type = Null;
+    double number = 0;
+    std::string string;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> members;
+
+    const Json* member(const std::string& name) const {
+        for (const auto& [key, value] : members) {
+            if (key == name) {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text(text) {}
+
+    // False unless the whole text is one valid value
+    bool parse(Json& value) {
+        bool valid = parseValue(value);
+        skipSpace();
+        return valid && position == text.size();
+    }
+
+private:
+    void skipSpace() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+            position++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (position < text.size() && text[position] == c) {
+            position++;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseString(std::string& string) {
+        if (!consume('"')) {
+            return false;
+        }
+        while (position < text.size() && text[position] != '"') {
+            if (text[position] == '\\') {
+                position++;
+                if (position == text.size() || std::string("\"\\/").find(text[position]) == std::string::npos) {
+                    return false;
+                }
+            } else if (static_cast<unsigned char>(text[position]) < 0x20) {
+                return false;
+            }
+            string += text[position++];
+        }
+        return position++ < text.size();
+    }
+
+    bool parseValue(Json& value) {
+        skipSpace();
+        if (position == text.size()) {
+            return false;
+        }
+        char c = text[position];
+        if (c == '{') {
+            value.type = Json::Object;
+            position++;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                std::pair<std::string, Json> member;
+                if (!parseString(member.first) || !consume(':') || !parseValue(member.second)) {
+                    return false;
+                }
+                value.members.push_back(std::move(member));
+            } while (consume(','));
+            return consume('}');
+        } else if (c == '[') {
+            value.type = Json::Array;
+            position++;
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                value.items.emplace_back();
+                if (!parseValue(value.items.back())) {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        } else if (c == '"') {
+            value.type = Json::String;
+            return parseString(value.string);
+        }
+        for (const char* literal : {"true", "false", "null"}) {
+            if (text.compare(position, std::string(literal).size(), literal) == 0) {
+                value.type = literal[0] == 'n' ? Json::Null : Json::Bool;
+                position += std::string(literal).size();
+                return true;
+            }
+        }
+        size_t start = position;
+        if (text[position] == '-') {
+            position++;
+        }
+        if (!skipDigits()) {
+            return false;
+        }
+        if (position < text.size() && text[position] == '.') {
+            position++;
+            if (!skipDigits()) {
+                return false;
+            }
+        }
+        value.type = Json::Number;
+        value.number = std::stod(text.substr(start, position - start));
+        return true;
+    }
+
+    bool skipDigits() {
+        size_t start = position;
+        while (position < text.size() && std::isdigit(static_cast<unsigned char>(text[position]))) {
+            position++;
+        }
+        return position > start;
+    }
+
+    const std::string& text;
+    size_t position = 0;
+};
+
+// The first event named name on the thread called threadName, or nullptr
+const Json* findEvent(const Json& events, const std::string& name, const std::string& threadName) {
+    double tid = -1;
+    for (const Json& event : events.items) {
+        const Json* phase = event.member("ph");
+        const Json* args = event.member("args");
+        if (phase && phase->string == "M" && args && args->member("name") &&
+            args->member("name")->string == threadName) {
+            tid = event.member("tid")->number;
+        }
+    }
+    for (const Json& event : events.items) {
+        if (event.member("name") && event.member("name")->string == name && event.member("tid") &&
+            event.member("tid")->number == tid) {
+            return &event;
+        }
+    }
+    return nullptr;
+}
+
+std::string checkTrace() {
+    Tracer::instant("before enabling", "test");
+    Tracer::setEnabled(true);
+    Tracer::setThreadName("tracer \"test\""); // quotes get escaped
+    {
+        TRACE_SCOPE("frame", "frame");
+        Tracer::instant("key pressed", "input", "code", 42);
+    }
+    std::thread worker([] {
+        Tracer::setThreadName("worker");
+        TRACE_SCOPE("encode", "capture");
+    });
+    worker.join();
+    Tracer::setEnabled(false);
+    Tracer::instant("after disabling", "test");
+
+    std::string filename = "/tmp/yachie-trace-test-" + std::to_string(getpid()) + ".json";
+    if (!Tracer::writeChromeTrace(filename)) {
+        return "couldn't write " + filename;
+    }
+    std::stringstream text;
+    text << std::ifstream(filename).rdbuf();
+    std::remove(filename.c_str());
+    Json trace;
+    if (!JsonParser(text.str()).parse(trace) || trace.type != Json::Object) {
+        return "the trace isn't valid JSON:\n" + text.str();
+    }
+    const Json* events = trace.member("traceEvents");
+    if (events == nullptr || events->type != Json::Array) {
+        return "the trace has no traceEvents array";
+    }
+    const Json* frame = findEvent(*events, "frame", "tracer \"test\"");
+    if (frame == nullptr || frame->member("ph")->string != "X" || !frame->member("dur") ||
+        frame->member("dur")->number < 0 || frame->member("cat")->string != "frame") {
+        return "the frame span is missing or isn't a complete event";
+    }
+    const Json* key = findEvent(*events, "key pressed", "tracer \"test\"");
+    if (key == nullptr || key->member("ph")->string != "i" || !key->member("args") ||
+        !key->member("args")->member("code") || key->member("args")->member("code")->number != 42) {
+        return "the key press is missing or lost its argument";
+    }
+    if (key->member("ts")->number < frame->member("ts")->number) {
+        return "the key press is timed before the frame it happened in";
+    }
+    if (findEvent(*events, "encode", "worker") == nullptr) {
+        return "the worker thread's span is missing";
+    }
+    if (findEvent(*events, "before enabling", "tracer \"test\"") != nullptr ||
+        findEvent(*events, "after disabling", "tracer \"test\"") != nullptr) {
+        return "events were recorded while tracing was off";
+    }
+    return "";
+}
+
+} // namespace
+
+int main() {
+    std::string error = checkTrace();
+    if (!error.empty()) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "Exported a Chrome trace that parses with the recorded events" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Chip8.h"
+#include "Disassembly.h"
+
+// Disassembles ROMs, or every ROM in a directory, into listings and Graphviz control-flow graphs
+
+namespace {
+
+std::vector<std::filesystem::path> collectRoms(const std::vector<std::string>& arguments) {
+    std::vector<std::filesystem::path> roms;
+    for (const auto& argument : arguments) {
+        if (std::filesystem::is_directory(argument)) {
+            std::vector<std::filesystem::path> directory;
+            for (const auto& entry : std::filesystem::directory_iterator(argument)) {
+                if (entry.is_regular_file()) {
+                    directory.push_back(entry.path());
+                }
+            }
+            std::sort(directory.begin(), directory.end());
+            roms.insert(roms.end(), directory.begin(), directory.end());
+        } else {
+            roms.emplace_back(argument);
+        }
+    }
+    return roms;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> arguments;
+    std::string dotFilename;
+    bool summary = false;
+    QuirkProfile profile = QuirkProfile::Yachie;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: yachie-disasm [options] rom|directory..." << std::endl;
+            std::cout << "  --dot=FILE        write the control-flow graphs to FILE for Graphviz" << std::endl;
+            std::cout << "  --summary         print one line of statistics per ROM instead of listings" << std::endl;
+            std::cout << "  --quirks=PROFILE  load ROMs like the profile would, xochip allows ROMs up to 64KB"
+                      << std::endl;
+            return 0;
+        } else if (option.compare(0, 6, "--dot=") == 0) {
+            dotFilename = option.substr(6);
+        } else if (option == "--summary") {
+            summary = true;
+        } else if (option.compare(0, 9, "--quirks=") == 0) {
+            if (!parseQuirkProfile(option.substr(9), profile)) {
+                std::cerr << "Unknown quirk profile " << option.substr(9) << std::endl;
+                return 1;
+            }
+        } else {
+            arguments.push_back(option);
+        }
+    }
+    std::vector<std::filesystem::path> roms = collectRoms(arguments);
+    if (roms.empty()) {
+        std::cerr << "No ROMs given, see --help" << std::endl;
+        return 1;
+    }
+    std::ofstream dot;
+    if (!dotFilename.empty()) {
+        dot.open(dotFilename);
+        if (!dot.is_open()) {
+            std::cerr << "Couldn't write " << dotFilename << std::endl;
+            return 1;
+        }
+    }
+
+    Chip8 cpu;
+    cpu.quirkProfile = profile;
+    std::chrono::nanoseconds analysisTime {0};
+    for (const auto& rom : roms) {
+        std::error_code error;
+        auto romSize = std::filesystem::file_size(rom, error);
+        if (error) {
+            std::cerr << "Couldn't load rom " << rom.string() << std::endl;
+            continue;
+        }
+        cpu.load(rom.string());
+        int size = PROGRAM_OFFSET + int(std::min<uintmax_t>(romSize, uintmax_t(cpu.memorySize() - PROGRAM_OFFSET)));
+
+        auto start = std::chrono::steady_clock::now();
+        Disassembly disassembly(cpu.memory(), size);
+        analysisTime += std::chrono::steady_clock::now() - start;
+
+        if (summary) {
+            std::cout << std::left << std::setw(24) << rom.filename().string() << std::right
+                      << std::setw(6) << romSize << " bytes" << std::setw(6) << disassembly.bytesOf(ByteKind::Code)
+                      << " instructions" << std::setw(6) << disassembly.blocks().size() << " blocks"
+                      << std::setw(4) << disassembly.subroutines().size() << " subroutines"
+                      << std::setw(6) << disassembly.bytesOf(ByteKind::Data) << " data bytes" << std::endl;
+        } else {
+            std::cout << "; " << rom.filename().string() << std::endl;
+            disassembly.writeListing(std::cout);
+            std::cout << std::endl;
+        }
+        if (dot.is_open()) {
+            disassembly.writeGraphviz(dot, rom.filename().string());
+        }
+    }
+    if (summary) {
+        std::cout << roms.size() << " ROMs analysed in "
+                  << std::chrono::duration<double, std::milli>(analysisTime).count() << " ms" << std::endl;
+    }
+    return 0;
+}
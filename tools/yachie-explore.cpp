@@ -0,0 +1,143 @@
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Explorer.h"
+#include "Framebuffer.h"
+#include "Options.h"
+
+// Lists the screens a ROM can reach from the keypad and how, by searching its states over every core
+
+namespace {
+
+bool parseKeys(const std::string& text, uint16_t& keys) {
+    const std::string digits = "0123456789ABCDEF";
+    keys = 0;
+    for (char digit : text) {
+        size_t key = digits.find(char(std::toupper(static_cast<unsigned char>(digit))));
+        if (key == std::string::npos) {
+            return false;
+        }
+        keys |= uint16_t(1 << key);
+    }
+    return keys != 0;
+}
+
+// Binary PGM, which most image viewers open
+bool writeScreen(const std::filesystem::path& path, const Screen& screen) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "P5\n" << screen.width << " " << screen.height << "\n255\n";
+    for (uint8_t planes : screen.pixels) {
+        file.put(char(PLANE_LEVELS[planes & 3]));
+    }
+    return file.good();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ExploreOptions options;
+    QuirkProfile profile = QuirkProfile::Yachie;
+    uint32_t seed = 0;
+    std::string romFilename;
+    std::string outDirectory;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: yachie-explore [options] rom" << std::endl;
+            std::cout << "  --depth=N         input steps to search, " << options.maxDepth << " by default"
+                      << std::endl;
+            std::cout << "  --states=N        distinct states to visit at most, " << options.maxStates
+                      << " by default" << std::endl;
+            std::cout << "  --hold=FRAMES     frames each step holds its key for, " << options.holdFrames
+                      << " by default" << std::endl;
+            std::cout << "  --keys=DIGITS     the keys to try, like 456 for the usual left, fire and right, "
+                         "all of them by default" << std::endl;
+            std::cout << "  --best-first      follow the inputs that find new screens instead of searching "
+                         "breadth-first" << std::endl;
+            std::cout << "  --threads=N       worker threads, one per core by default" << std::endl;
+            std::cout << "  --quirks=PROFILE  run the ROM under a quirk profile" << std::endl;
+            std::cout << "  --seed=N          seed for CXNN, 0 by default" << std::endl;
+            std::cout << "  --out=DIRECTORY   write each screen there as a PGM image" << std::endl;
+            return 0;
+        } else if (option.compare(0, 8, "--depth=") == 0) {
+            if (!parseNumber(option.substr(8), options.maxDepth)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 9, "--states=") == 0) {
+            if (!parseNumber(option.substr(9), options.maxStates)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 7, "--hold=") == 0) {
+            if (!parseNumber(option.substr(7), options.holdFrames)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 7, "--keys=") == 0) {
+            if (!parseKeys(option.substr(7), options.keys)) {
+                std::cerr << "Keys are hex digits, like --keys=456" << std::endl;
+                return 1;
+            }
+        } else if (option == "--best-first") {
+            options.bestFirst = true;
+        } else if (option.compare(0, 10, "--threads=") == 0) {
+            if (!parseNumber(option.substr(10), options.threads)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 9, "--quirks=") == 0) {
+            if (!parseQuirkProfile(option.substr(9), profile)) {
+                std::cerr << "Unknown quirk profile " << option.substr(9) << std::endl;
+                return 1;
+            }
+        } else if (option.compare(0, 7, "--seed=") == 0) {
+            if (!parseNumber(option.substr(7), seed)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 6, "--out=") == 0) {
+            outDirectory = option.substr(6);
+        } else {
+            romFilename = option;
+        }
+    }
+    if (romFilename.empty() || !std::filesystem::is_regular_file(romFilename)) {
+        std::cerr << "No ROM given, see --help" << std::endl;
+        return 1;
+    }
+    if (!outDirectory.empty()) {
+        std::filesystem::create_directories(outDirectory);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ExploreResult result = Explorer(options).run([&](Chip8& cpu) {
+        cpu.quirkProfile = profile;
+        cpu.load(romFilename);
+        cpu.seedRandom(seed);
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t n = 0; n < result.screens.size(); n++) {
+        const Screen& screen = result.screens[n];
+        std::cout << "screen " << n << "  " << screen.width << "x" << screen.height << "  depth "
+                  << screen.inputs.size() << "  inputs: " << Explorer::formatInputs(screen.inputs) << std::endl;
+        if (!outDirectory.empty()) {
+            std::ostringstream name;
+            name << "screen-" << std::setw(4) << std::setfill('0') << n << ".pgm";
+            if (!writeScreen(std::filesystem::path(outDirectory) / name.str(), screen)) {
+                std::cerr << "Couldn't write " << name.str() << " to " << outDirectory << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << result.screens.size() << " screens in " << result.states << " states, " << result.depth
+              << " steps deep, in " << seconds << "s" << std::endl;
+    if (!result.exhausted) {
+        std::cout << "Stopped at the state limit, there may be more screens (see --states)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "GridDisplay.h"
+#include "Options.h"
+#include "ThreadPool.h"
+
+// Runs many machines side by side in one window, pressing random keys on each, to keep an eye on batch runs
+
+namespace {
+
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+constexpr int MIN_HOLD_FRAMES = 6; // each random key (or none) is held for between these
+constexpr int MAX_HOLD_FRAMES = 30;
+
+struct Instance {
+    Chip8 cpu;
+    std::mt19937 random;
+    int key = -1;
+    int holdFrames = 0;
+};
+
+void addRoms(const std::filesystem::path& path, std::vector<std::string>& roms) {
+    if (std::filesystem::is_directory(path)) {
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path().string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        roms.insert(roms.end(), files.begin(), files.end());
+    } else if (std::filesystem::is_regular_file(path)) {
+        roms.push_back(path.string());
+    }
+}
+
+// A frame of a machine, holding a random key for a random while like an untrained agent would
+void runFrame(Instance& instance) {
+    Chip8& cpu = instance.cpu;
+    if (--instance.holdFrames <= 0) {
+        instance.key = int(instance.random() % (NUMBER_OF_KEYS + 1)) - 1;
+        instance.holdFrames = MIN_HOLD_FRAMES + int(instance.random() % (MAX_HOLD_FRAMES - MIN_HOLD_FRAMES + 1));
+    }
+    for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+        cpu.state.input[n] = n == instance.key;
+    }
+    int remaining = STEPS_PER_FRAME;
+    while (remaining > 0 && cpu.state.running) {
+        if (cpu.state.acceptingInputInto != -1 && instance.key != -1) {
+            cpu.keyInput(uint8_t(instance.key));
+        }
+        RunResult result = cpu.run(remaining);
+        remaining -= std::max(result.executed, 1);
+    }
+    cpu.tickTimers();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int count = 100;
+    int threads = 0;
+    std::optional<QuirkProfile> profile; // by each ROM's extension unless given
+    Palette palette = GREY_PALETTE;
+    std::vector<std::string> roms;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: yachie-grid [options] rom|directory..." << std::endl;
+            std::cout << "  --instances=N     machines to run, " << count << " by default, taking the ROMs in turn"
+                      << std::endl;
+            std::cout << "  --threads=N       worker threads, one per core by default" << std::endl;
+            std::cout << "  --quirks=PROFILE  run every ROM under a quirk profile rather than by extension"
+                      << std::endl;
+            std::cout << "  --palette=COLORS  as for yachie" << std::endl;
+            return 0;
+        } else if (option.compare(0, 12, "--instances=") == 0) {
+            if (!parseNumber(option.substr(12), count)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 10, "--threads=") == 0) {
+            if (!parseNumber(option.substr(10), threads)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 9, "--quirks=") == 0) {
+            QuirkProfile parsed;
+            if (!parseQuirkProfile(option.substr(9), parsed)) {
+                std::cerr << "Unknown quirk profile " << option.substr(9) << std::endl;
+                return 1;
+            }
+            profile = parsed;
+        } else if (option.compare(0, 10, "--palette=") == 0) {
+            if (!parsePalette(option.substr(10), palette)) {
+                std::cerr << "Unknown palette " << option.substr(10) << std::endl;
+                return 1;
+            }
+        } else {
+            addRoms(option, roms);
+        }
+    }
+    if (roms.empty() || count < 1) {
+        std::cerr << "No ROMs given, see --help" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Instance>> instances;
+    for (int n = 0; n < count; n++) {
+        auto instance = std::make_unique<Instance>();
+        const std::string& rom = roms[size_t(n) % roms.size()];
+        instance->cpu.quirkProfile = profile ? *profile : quirkProfileForRom(rom);
+        instance->cpu.load(rom);
+        instance->cpu.seedRandom(uint32_t(n));
+        instance->random.seed(uint32_t(n));
+        instances.push_back(std::move(instance));
+    }
+    GridDisplay grid(count, palette);
+    if (!grid.isOpen()) {
+        std::cerr << count << " instances don't fit in one texture" << std::endl;
+        return 1;
+    }
+    ThreadPool pool(threads);
+
+    sf::Clock frameTimer;
+    sf::Clock titleTimer;
+    int frames = 0;
+    while (grid.window.isOpen()) {
+        sf::Event event; // NOLINT
+        while (grid.window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                grid.window.close();
+            }
+        }
+        if (frameTimer.getElapsedTime().asSeconds() < TIMER_FREQUENCY) {
+            sf::sleep(sf::milliseconds(1));
+            continue;
+        }
+        frameTimer.restart();
+        pool.run(count, [&instances](int begin, int end) {
+            for (int n = begin; n < end; n++) {
+                runFrame(*instances[size_t(n)]);
+            }
+        });
+        for (int n = 0; n < count; n++) {
+            grid.update(n, instances[size_t(n)]->cpu);
+        }
+        grid.draw();
+        frames++;
+        if (titleTimer.getElapsedTime().asSeconds() >= 1) {
+            grid.window.setTitle(std::to_string(count) + " instances, " + std::to_string(frames) + " fps");
+            frames = 0;
+            titleTimer.restart();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "Capture.h"
+#include "Options.h"
+
+// Records a ROM running headless to a GIF or Y4M, pressing each key in turn like the golden tests do
+
+namespace {
+
+constexpr int STEPS_PER_FRAME = int(TIMER_FREQUENCY / CPU_FREQUENCY);
+constexpr int KEY_HOLD_FRAMES = 6; // each key in turn is held this long, then released for as long
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int frames = 600;
+    int scale = 2;
+    bool pressKeys = true;
+    QuirkProfile profile = QuirkProfile::Yachie;
+    uint32_t seed = 0;
+    std::string romFilename;
+    std::string outFilename;
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: yachie-record [options] rom out.gif|out.y4m" << std::endl;
+            std::cout << "  --frames=N        frames to record at 60 per second, " << frames << " by default"
+                      << std::endl;
+            std::cout << "  --scale=N         pixels per high resolution pixel, " << scale << " by default"
+                      << std::endl;
+            std::cout << "  --no-keys         don't press any keys" << std::endl;
+            std::cout << "  --quirks=PROFILE  run the ROM under a quirk profile" << std::endl;
+            std::cout << "  --seed=N          seed for CXNN, 0 by default" << std::endl;
+            return 0;
+        } else if (option.compare(0, 9, "--frames=") == 0) {
+            if (!parseNumber(option.substr(9), frames)) {
+                return notANumber(option);
+            }
+        } else if (option.compare(0, 8, "--scale=") == 0) {
+            if (!parseNumber(option.substr(8), scale)) {
+                return notANumber(option);
+            } else if (scale == 0) {
+                std::cerr << "The scale must be at least 1" << std::endl;
+                return 1;
+            }
+        } else if (option == "--no-keys") {
+            pressKeys = false;
+        } else if (option.compare(0, 9, "--quirks=") == 0) {
+            if (!parseQuirkProfile(option.substr(9), profile)) {
+                std::cerr << "Unknown quirk profile " << option.substr(9) << std::endl;
+                return 1;
+            }
+        } else if (option.compare(0, 7, "--seed=") == 0) {
+            if (!parseNumber(option.substr(7), seed)) {
+                return notANumber(option);
+            }
+        } else if (romFilename.empty()) {
+            romFilename = option;
+        } else {
+            outFilename = option;
+        }
+    }
+    if (romFilename.empty() || !std::filesystem::is_regular_file(romFilename)) {
+        std::cerr << "No ROM given, see --help" << std::endl;
+        return 1;
+    }
+    CaptureFormat format;
+    if (!captureFormatFor(outFilename, format)) {
+        std::cerr << "The output has to be a .gif or .y4m file, see --help" << std::endl;
+        return 1;
+    }
+    Capture capture(outFilename, format, scale);
+    if (!capture.isOpen()) {
+        std::cerr << "Can't write " << outFilename << std::endl;
+        return 1;
+    }
+
+    Chip8 cpu;
+    cpu.quirkProfile = profile;
+    cpu.load(romFilename);
+    cpu.seedRandom(seed);
+    for (int frame = 1; frame <= frames; frame++) {
+        int step = frame / KEY_HOLD_FRAMES;
+        int key = (step / 2) % NUMBER_OF_KEYS;
+        bool pressed = pressKeys && step % 2 == 0;
+        for (int n = 0; n < NUMBER_OF_KEYS; n++) {
+            cpu.state.input[n] = pressed && n == key;
+        }
+        int remaining = STEPS_PER_FRAME;
+        while (remaining > 0 && cpu.state.running) {
+            if (cpu.state.acceptingInputInto != -1 && pressKeys) {
+                cpu.keyInput(uint8_t(key));
+            }
+            RunResult result = cpu.run(remaining);
+            remaining -= std::max(result.executed, 1);
+        }
+        cpu.tickTimers();
+        capture.waitForSpace();
+        capture.submit(cpu);
+    }
+    capture.finish();
+    std::cout << "Recorded " << capture.frames() << " frames to " << outFilename << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "ExecutionLog.h"
+#include "Options.h"
+
+// Decodes the execution logs written by yachie when a ROM faults
+
+namespace {
+
+void printHex(uint32_t value, int width) {
+    std::cout << std::hex << std::uppercase << std::setw(width) << std::setfill('0') << value
+              << std::dec << std::nouppercase << std::setfill(' ');
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filename;
+    size_t limit = 0; // 0 shows everything
+    for (int arg = 1; arg < argc; arg++) {
+        std::string option = argv[arg];
+        if (option == "-h" || option == "--help") {
+            std::cout << "Usage: yachie-trace [-n count] log" << std::endl;
+            std::cout << "  -n count   only show the last count instructions" << std::endl;
+            return 0;
+        } else if (option == "-n" && arg + 1 < argc) {
+            if (!parseNumber(argv[++arg], limit)) {
+                std::cerr << "-n takes a number of instructions, not " << argv[arg] << std::endl;
+                return 1;
+            }
+        } else {
+            filename = option;
+        }
+    }
+    if (filename.empty()) {
+        std::cerr << "No execution log given, see --help" << std::endl;
+        return 1;
+    }
+
+    ExecutionLog::Registers registers {};
+    std::vector<ExecutionLog::Record> records;
+    uint64_t executed = 0;
+    if (!ExecutionLog::read(filename, registers, records, executed)) {
+        return 1;
+    }
+    if (limit != 0 && records.size() > limit) {
+        records.erase(records.begin(), records.end() - long(limit));
+    }
+
+    std::cout << executed << " instructions executed, showing the last " << records.size() << std::endl;
+    for (const auto& record : records) {
+        std::cout << "0x";
+        printHex(record.pc, 3);
+        std::cout << "  ";
+        printHex(record.opcode, 4);
+        std::cout << "  I=";
+        printHex(record.i, 3);
+        int first = 0;
+        int last = 0;
+        ExecutionLog::writtenRegisters(record.opcode, first, last);
+        std::cout << "  V";
+        printHex(first, 1);
+        if (last != first) {
+            std::cout << "-V";
+            printHex(last, 1);
+        }
+        std::cout << "=";
+        for (int reg = first; reg <= last; reg++) {
+            printHex(record.v[reg], 2);
+            std::cout << (reg == last ? "" : " ");
+        }
+        std::cout << "  VF=";
+        printHex(record.v[0xF], 2);
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl << "Registers at fault:" << std::endl;
+    for (int reg = 0; reg < 16; reg++) {
+        std::cout << "V";
+        printHex(reg, 1);
+        std::cout << "=";
+        printHex(registers.v[reg], 2);
+        std::cout << (reg % 8 == 7 ? "\n" : "  ");
+    }
+    std::cout << "I=";
+    printHex(registers.i, 3);
+    std::cout << "  PC=";
+    printHex(registers.pc, 3);
+    std::cout << "  SP=" << registers.sp << "  DT=" << int(registers.delayTimer)
+              << "  ST=" << int(registers.soundTimer) << std::endl;
+    return 0;
+}